@@ -0,0 +1,22 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/Test/Benchmark.h"
+
+#include "Misc/AutomationTest.h"
+
+namespace Zkz::Test
+{
+
+void ReportBenchmark(
+	FAutomationTestBase& Test, const FStringView Name, const double BaselineSeconds, const double Seconds)
+{
+	Test.AddInfo(FString::Printf(
+		TEXT("%.*s: baseline %.3f ms, measured %.3f ms (%.2fx)"),
+		Name.Len(),
+		Name.GetData(),
+		BaselineSeconds * 1000.0,
+		Seconds * 1000.0,
+		Seconds > 0.0 ? BaselineSeconds / Seconds : 0.0));
+}
+
+}  // namespace Zkz::Test
@@ -0,0 +1,31 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAutomationTestBase;
+
+namespace Zkz::Test
+{
+
+/// Calls Func NumIterations times and returns the average wall time of a single call in seconds.
+template <class FuncType>
+double MeasureAverageSeconds(const int32 NumIterations, FuncType&& Func)
+{
+	check(NumIterations > 0);
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	for (int32 Iteration = 0; Iteration < NumIterations; ++Iteration)
+	{
+		::Invoke(Func);
+	}
+
+	return (FPlatformTime::Seconds() - StartSeconds) / NumIterations;
+}
+
+/// Adds an info message to the test comparing the measured time against the baseline.
+ZAKAZANETESTUTILITIES_API void ReportBenchmark(
+	FAutomationTestBase& Test, FStringView Name, double BaselineSeconds, double Seconds);
+
+}  // namespace Zkz::Test
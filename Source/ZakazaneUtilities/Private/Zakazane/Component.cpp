@@ -4,10 +4,12 @@
 #include "ComponentUtils.h"
 #include "Engine/SCS_Node.h"
 #include "Engine/SimpleConstructionScript.h"
+#include "Misc/ScopeRWLock.h"
 #include "Zakazane/Blueprint.h"
 #include "Zakazane/Object.h"
 
 #if WITH_EDITOR
+#include "Editor.h"
 #include "Kismet2/BlueprintEditorUtils.h"
 #include "SubobjectData.h"
 #include "SubobjectDataHandle.h"
@@ -58,6 +60,89 @@ USCS_Node* FindCorrespondingSCSNode(const USceneComponent& SceneComponent)
 
 #if WITH_EDITOR
 
+/// Templates of construction script nodes are outered to their class, default subobjects to the default object
+const UClass* FindArchetypeOwnerClass(const UActorComponent& Component)
+{
+	const UObject* const Outer = Component.GetOuter();
+	ZKZ_RETURN_IF_INVALID(Outer, nullptr);
+
+	return Outer->IsA<UClass>() ? CastChecked<UClass>(Outer) : Outer->GetClass();
+}
+
+/// Parent of an archetype component, resolved the same way as when gathering the hierarchy
+UActorComponent* FindArchetypeParent(const UActorComponent& Component)
+{
+	const USceneComponent* const SceneComp = Cast<USceneComponent>(&Component);
+	ZKZ_RETURN_IF_INVALID(SceneComp, nullptr);
+
+	if (const USCS_Node* const SCSNode = FindCorrespondingSCSNode(*SceneComp))
+	{
+		const USimpleConstructionScript* const SCS = SCSNode->GetSCS();
+		ZKZ_RETURN_IF_INVALID(SCS, nullptr);
+
+		return SCSNode->GetParentComponentTemplate(SCS->GetBlueprint());
+	}
+
+	return SceneComp->GetAttachParent();
+}
+
+/// Adds a name entry, replacing the one of any other component with the same name
+void AddArchetypeComponentName(FArchetypeComponents& ArchetypeComponents, const FName Name, UActorComponent* const Comp)
+{
+	if (const TWeakObjectPtr<UActorComponent>* const ReplacedComp = ArchetypeComponents.CompsByName.Find(Name))
+	{
+		ArchetypeComponents.NamesByComp.Remove(*ReplacedComp);
+	}
+
+	ArchetypeComponents.CompsByName.Emplace(Name, Comp);
+	ArchetypeComponents.NamesByComp.Emplace(Comp, Name);
+}
+
+/// Removes the name entry of the component, found by the component since it may have been renamed already
+void RemoveArchetypeComponentName(FArchetypeComponents& ArchetypeComponents, const UActorComponent& Comp)
+{
+	FName Name;
+	ZKZ_RETURN_IF(!ArchetypeComponents.NamesByComp.RemoveAndCopyValue(const_cast<UActorComponent*>(&Comp), Name));
+
+	ArchetypeComponents.CompsByName.Remove(Name);
+}
+
+void RemoveArchetypeComponentName(FArchetypeComponents& ArchetypeComponents, const FName Name)
+{
+	TWeakObjectPtr<UActorComponent> Comp;
+	ZKZ_RETURN_IF(!ArchetypeComponents.CompsByName.RemoveAndCopyValue(Name, Comp));
+
+	ArchetypeComponents.NamesByComp.Remove(Comp);
+}
+
+/// Removes the component from the parent and child maps, reparenting its children to its parent
+void RemoveArchetypeComponent(FArchetypeComponents& ArchetypeComponents, const UActorComponent& Comp)
+{
+	FArchetypeComponents::FCompsByParent& CompsByParent = ArchetypeComponents.CompsByParent;
+	FArchetypeComponents::FCompsByChild& CompsByChild = ArchetypeComponents.CompsByChild;
+
+	const TWeakObjectPtr<UActorComponent> Parent = CompsByChild.FindAndRemoveChecked(&Comp);
+	CompsByParent.Remove(Parent, const_cast<UActorComponent*>(&Comp));
+
+	const TArray<TWeakObjectPtr<UActorComponent>> ReparentedChildren = [&CompsByParent, &Comp]
+	{
+		TArray<TWeakObjectPtr<UActorComponent>> Result;
+		for (auto It = CompsByParent.CreateKeyIterator(&Comp); It; ++It)
+		{
+			Result.Emplace(It.Value());
+			It.RemoveCurrent();
+		}
+
+		return Result;
+	}();
+
+	for (const TWeakObjectPtr<UActorComponent>& ReparentedChild : ReparentedChildren)
+	{
+		CompsByParent.Emplace(Parent, ReparentedChild);
+		CompsByChild.FindChecked(ReparentedChild) = Parent;
+	}
+}
+
 FSubobjectDataHandle* FindSubobjectDataHandle(TArray<FSubobjectDataHandle>& SubobjectDataHandles, const UObject& Object)
 {
 	return SubobjectDataHandles.FindByPredicate(
@@ -69,6 +154,89 @@ FSubobjectDataHandle* FindSubobjectDataHandle(TArray<FSubobjectDataHandle>& Subo
 		});
 }
 
+/// Process-wide cache of archetype hierarchies by class. Entries are shared read-only with FComponentHierarchy objects,
+/// which copy them before modifying.
+class FArchetypeComponentsCache
+{
+public:
+	using FArchetypeComponentsPtr = TSharedPtr<FArchetypeComponents, ESPMode::ThreadSafe>;
+
+	static FArchetypeComponentsCache& Get()
+	{
+		// Intentionally leaked, the editor may be gone by static destruction and the delegates can't be unbound then
+		static FArchetypeComponentsCache* const Cache = new FArchetypeComponentsCache;
+
+		// GEditor may not exist yet on first use, e.g. when components are queried during engine startup
+		if (IsInGameThread())
+		{
+			Cache->TryBindBlueprintCompiled();
+		}
+
+		return *Cache;
+	}
+
+	FArchetypeComponentsPtr Find(const UClass& Class) const
+	{
+		FReadScopeLock Lock{Mutex};
+
+		const FArchetypeComponentsPtr* const FoundEntry = Entries.Find(&Class);
+		return FoundEntry == nullptr ? nullptr : *FoundEntry;
+	}
+
+	void Add(const UClass& Class, FArchetypeComponentsPtr ArchetypeComponents)
+	{
+		FWriteScopeLock Lock{Mutex};
+		Entries.Emplace(&Class, MoveTemp(ArchetypeComponents));
+	}
+
+	/// Removes the entries of the given class and its subclasses, which inherit its components
+	void Invalidate(const UClass& Class)
+	{
+		FWriteScopeLock Lock{Mutex};
+
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			const UClass* const EntryClass = It.Key().Get();
+			if (EntryClass == nullptr || EntryClass->IsChildOf(&Class))
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	void Reset()
+	{
+		FWriteScopeLock Lock{Mutex};
+		Entries.Reset();
+	}
+
+private:
+	mutable FRWLock Mutex;
+	TMap<TWeakObjectPtr<const UClass>, FArchetypeComponentsPtr> Entries;
+
+	/// Only accessed on the game thread
+	bool bBlueprintCompiledBound = false;
+
+	FArchetypeComponentsCache()
+	{
+		FCoreUObjectDelegates::OnObjectsReinstanced.AddLambda(
+			[this](const FCoreUObjectDelegates::FReplacementObjectMap&) { Reset(); });
+	}
+
+	void TryBindBlueprintCompiled()
+	{
+		ZKZ_RETURN_IF(bBlueprintCompiledBound || GEditor == nullptr);
+
+		// Compiling a blueprint may change the components of its subclasses and of any class using it as a child actor,
+		// so the whole cache is dropped
+		GEditor->OnBlueprintCompiled().AddRaw(this, &FArchetypeComponentsCache::Reset);
+		bBlueprintCompiledBound = true;
+
+		// Blueprints compiled before the binding may have left stale entries behind
+		Reset();
+	}
+};
+
 #endif
 
 }  // namespace ComponentPrivate
@@ -175,7 +343,8 @@ UActorComponent* FComponentHierarchy::FindParent(const UActorComponent& Child)
 
 const UActorComponent* FComponentHierarchy::FindComponentByName(const FName Name) const
 {
-	const TWeakObjectPtr<UActorComponent>* FoundWeakComp = CompsByName.Find(FName{GetComponentNameNoSuffix(Name)});
+	const TWeakObjectPtr<UActorComponent>* FoundWeakComp =
+		GetArchetypeComponents().CompsByName.Find(FName{GetComponentNameNoSuffix(Name)});
 
 	return FoundWeakComp == nullptr ? nullptr : FoundWeakComp->Get();
 }
@@ -188,74 +357,11 @@ UActorComponent* FComponentHierarchy::AddNewSubobject(
 	const FName& Name,
 	const Editor::EMarkBlueprintAsStructurallyModified MarkBlueprintAsStructurallyModified)
 {
-	using namespace ComponentPrivate;
-
-	ZKZ_RETURN_IF_ENSUREALWAYS(!Class.IsChildOf(UActorComponent::StaticClass()), nullptr);
-	ZKZ_RETURN_IF_ENSUREALWAYS(!bComponentsMutable, nullptr);
-
-	AActor* const ActorPtr = Actor.Get();
-	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ActorPtr, nullptr);
-
-	USubobjectDataSubsystem* const SubobjectDataSubsystem = USubobjectDataSubsystem::Get();
-	ZKZ_RETURN_IF_INVALID(SubobjectDataSubsystem, nullptr);
-
-	TArray<FSubobjectDataHandle> SubobjectDataHandles;
-	SubobjectDataSubsystem->GatherSubobjectData(ActorPtr, SubobjectDataHandles);
-	ZKZ_RETURN_IF_ENSUREALWAYS(SubobjectDataHandles.IsEmpty(), nullptr);
-
-	UBlueprint* const Blueprint = GetBlueprint(*ActorPtr);
-	ZKZ_RETURN_IF_INVALID(Blueprint, nullptr);
-	const UClass* const BlueprintGeneratedClass = Blueprint->GeneratedClass;
-	ZKZ_RETURN_IF_INVALID(BlueprintGeneratedClass, nullptr);
-	ZKZ_RETURN_IF_ENSUREALWAYS(ActorPtr != BlueprintGeneratedClass->GetDefaultObject(false), nullptr);
-
-	const UObject* const Parent = (ParentComp == nullptr ? Cast<UObject>(ActorPtr) : ParentComp);
-	ZKZ_RETURN_IF_INVALID(Parent, nullptr);
-	const FSubobjectDataHandle* const ParentDataHandle = FindSubobjectDataHandle(SubobjectDataHandles, *Parent);
-	ZKZ_RETURN_IF_ENSUREALWAYS(ParentDataHandle == nullptr, nullptr);
+	Editor::FSubobjectEditBatch Batch{*this, MarkBlueprintAsStructurallyModified};
+	const Editor::FSubobjectEditBatch::FAddId AddId = Batch.AddNewSubobject(Class, ParentComp, Name);
+	Batch.Commit();
 
-	FAddNewSubobjectParams Params;
-	Params.ParentHandle = *ParentDataHandle;
-	Params.NewClass = &Class;
-	Params.AssetOverride = nullptr;
-	Params.BlueprintContext = Blueprint;
-	Params.bSkipMarkBlueprintModified = true;  // conditionally marking blueprint as modified after rename
-
-	FText FailReason;
-	const FSubobjectDataHandle NewSubobjectHandle = SubobjectDataSubsystem->AddNewSubobject(Params, FailReason);
-
-	ZKZ_RETURN_IF(!NewSubobjectHandle.IsValid(), nullptr);
-
-	const FSubobjectData* const NewSubobjectHandleData = NewSubobjectHandle.GetData();
-	ZKZ_RETURN_IF(NewSubobjectHandleData == nullptr, nullptr);
-
-	const UObject* const NewObject = NewSubobjectHandleData->GetObjectForBlueprint(Blueprint);
-
-	// The const_cast here should be fine. We know the hierarchy is mutable, as we checked at the beginning of the function
-	UActorComponent* const NewComp = const_cast<UActorComponent*>(Cast<UActorComponent>(NewObject));
-	ZKZ_RETURN_IF_INVALID(NewComp, nullptr);
-	ZKZ_RETURN_IF_ENSUREALWAYS(!NewComp->HasAllFlags(RF_ArchetypeObject), nullptr);
-
-	CompsByParent.Emplace(ParentComp, NewComp);
-	CompsByChild.Emplace(NewComp, ParentComp);
-
-	const bool bRenameSuccessful = SubobjectDataSubsystem->RenameSubobject(NewSubobjectHandle, FText::FromName(Name));
-	if (!bRenameSuccessful)
-	{
-		// #TODO #Buildings: would be nice to handle it more gracefully, but I don't have an idea how ATM
-		const int32 NumRemoved = RemoveSubobject(*NewComp, Editor::EMarkBlueprintAsStructurallyModified::Disabled);
-		ensureMsgf(NumRemoved > 0, TEXT("Failed to rename newly created subobject, then failed to remove it."));
-		return nullptr;
-	}
-
-	CompsByName.Emplace(Name, NewComp);
-
-	if (MarkBlueprintAsStructurallyModified == Editor::EMarkBlueprintAsStructurallyModified::Enabled)
-	{
-		FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
-	}
-
-	return NewComp;
+	return Batch.GetAddedComponent(AddId);
 }
 
 int32 FComponentHierarchy::RemoveSubobject(
@@ -268,90 +374,20 @@ int32 FComponentHierarchy::RemoveSubobjects(
 	const TArray<const UActorComponent*>& Comps,
 	const Editor::EMarkBlueprintAsStructurallyModified MarkBlueprintAsStructurallyModified)
 {
-	using namespace ComponentPrivate;
-
-	ZKZ_RETURN_IF_ENSUREALWAYS(!bComponentsMutable, 0);
-
-	AActor* const ActorPtr = Actor.Get();
-	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ActorPtr, 0);
-
-	USubobjectDataSubsystem* const SubobjectDataSubsystem = USubobjectDataSubsystem::Get();
-	ZKZ_RETURN_IF_INVALID(SubobjectDataSubsystem, 0);
-
-	TArray<FSubobjectDataHandle> SubobjectDataHandles;
-	SubobjectDataSubsystem->GatherSubobjectData(ActorPtr, SubobjectDataHandles);
-	ZKZ_RETURN_IF_ENSUREALWAYS(SubobjectDataHandles.IsEmpty(), 0);
-
-	UBlueprint* const Blueprint = GetBlueprint(*ActorPtr);
-	ZKZ_RETURN_IF_INVALID(Blueprint, 0);
-	ZKZ_RETURN_IF_ENSUREALWAYS(ActorPtr != Blueprint->GeneratedClass->GetDefaultObject(false), 0);
-
-	const FSubobjectDataHandle* const OwnerDataHandle = FindSubobjectDataHandle(SubobjectDataHandles, *ActorPtr);
-	ZKZ_RETURN_IF(OwnerDataHandle == nullptr, 0);
-
-	const TArray<FSubobjectDataHandle> CompDataHandles = [&Comps, &SubobjectDataHandles]()
-	{
-		TArray<FSubobjectDataHandle> Result;
-		for (const UActorComponent* const Comp : Comps)
-		{
-			ZKZ_CONTINUE_IF_INVALID(Comp);
-			const FSubobjectDataHandle* const CompDataHandle = FindSubobjectDataHandle(SubobjectDataHandles, *Comp);
-			ZKZ_CONTINUE_IF_ENSUREALWAYS(CompDataHandle == nullptr);
-			Result.Emplace(*CompDataHandle);
-		}
-		return Result;
-	}();
-
-	const TArray<FName> CompNames = [&Comps]()
-	{
-		TArray<FName> Result;
-		for (const UActorComponent* const Comp : Comps)
-		{
-			ZKZ_CONTINUE_IF_INVALID(Comp);
-			Result.Emplace(GetComponentNameNoSuffix(*Comp));
-		}
-		return Result;
-	}();
-
-	const int32 NumRemoved = SubobjectDataSubsystem->DeleteSubobjects(*OwnerDataHandle, CompDataHandles, Blueprint);
-
-	ZKZ_RETURN_IF(NumRemoved == 0, 0);
-
+	Editor::FSubobjectEditBatch Batch{*this, MarkBlueprintAsStructurallyModified};
 	for (const UActorComponent* const Comp : Comps)
 	{
-		const TWeakObjectPtr<UActorComponent> Parent = CompsByChild.FindAndRemoveChecked(Comp);
-		CompsByParent.Remove(Parent, const_cast<UActorComponent*>(Comp));
-
-		const TArray<TWeakObjectPtr<UActorComponent>> ReparentedChildren = [this, Comp]
-		{
-			TArray<TWeakObjectPtr<UActorComponent>> Result;
-			for (auto It = CompsByParent.CreateKeyIterator(Comp); It; ++It)
-			{
-				Result.Emplace(It.Value());
-				It.RemoveCurrent();
-			}
-
-			return Result;
-		}();
-
-		for (const TWeakObjectPtr<UActorComponent>& ReparentedChild : ReparentedChildren)
-		{
-			CompsByParent.Emplace(Parent, ReparentedChild);
-			CompsByChild.FindChecked(ReparentedChild) = Parent;
-		}
+		ZKZ_CONTINUE_IF_INVALID(Comp);
+		Batch.RemoveSubobject(*Comp);
 	}
+	Batch.Commit();
 
-	for (const FName CompName : CompNames)
-	{
-		CompsByName.Remove(CompName);
-	}
-
-	if (MarkBlueprintAsStructurallyModified == Editor::EMarkBlueprintAsStructurallyModified::Enabled)
-	{
-		FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
-	}
+	return Batch.GetNumRemoved();
+}
 
-	return NumRemoved;
+void FComponentHierarchy::InvalidateArchetypeCache()
+{
+	ComponentPrivate::FArchetypeComponentsCache::Get().Reset();
 }
 
 #endif
@@ -386,15 +422,28 @@ void FComponentHierarchy::ConstructFromActor(AActor& InActor, const bool bAllowM
 #if WITH_EDITOR
 void FComponentHierarchy::ConstructHierarchyFromCDO(const TSubclassOf<AActor>& ActorClass)
 {
-	CompsByParent.Reset();
-	CompsByChild.Reset();
-	CompsByName.Reset();
+	using namespace ComponentPrivate;
+
+	ArchetypeComponents.Reset();
+	bComponentsMutable = false;
 
 	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ActorClass.Get());
 
+	FArchetypeComponentsCache& Cache = FArchetypeComponentsCache::Get();
+	if (FArchetypeComponentsPtr CachedArchetypeComponents = Cache.Find(*ActorClass))
+	{
+		ArchetypeComponents = MoveTemp(CachedArchetypeComponents);
+		bComponentsMutable = ArchetypeComponents->bBlueprintComponents;
+		return;
+	}
+
+	const FArchetypeComponentsPtr NewArchetypeComponents = MakeShared<FArchetypeComponents, ESPMode::ThreadSafe>();
+	FArchetypeComponents::FCompsByParent& CompsByParent = NewArchetypeComponents->CompsByParent;
+	FArchetypeComponents::FCompsByChild& CompsByChild = NewArchetypeComponents->CompsByChild;
+
 	if (Cast<UBlueprintGeneratedClass>(ActorClass.Get()))
 	{
-		bComponentsMutable = true;
+		NewArchetypeComponents->bBlueprintComponents = true;
 
 		// This looks strange, but unfortunately the parent data is not reliable when accessing from
 		// USCS_Node->GetParentComponentTemplate. Sometimes a node returns a null parent, while it's actually
@@ -445,18 +494,17 @@ void FComponentHierarchy::ConstructHierarchyFromCDO(const TSubclassOf<AActor>& A
 
 				CompsByParent.Emplace(Parent, SCSNode.ComponentTemplate);
 				CompsByChild.Emplace(SCSNode.ComponentTemplate, Parent);
-				CompsByName.Emplace(
-					GetComponentNameNoSuffix(*SCSNode.ComponentTemplate),
+				AddArchetypeComponentName(
+					*NewArchetypeComponents,
+					FName{GetComponentNameNoSuffix(*SCSNode.ComponentTemplate)},
 					SCSNode.GetActualComponentTemplate(&BlueprintGeneratedClass));
 			});
 	}
 	else
 	{
-		bComponentsMutable = false;
-
 		AActor::ForEachComponentOfActorClassDefault<UActorComponent>(
 			ActorClass,
-			[this](const UActorComponent* const Comp)
+			[&](const UActorComponent* const Comp)
 			{
 				ZKZ_RETURN_IF_INVALID(Comp, true);
 
@@ -468,13 +516,161 @@ void FComponentHierarchy::ConstructHierarchyFromCDO(const TSubclassOf<AActor>& A
 				USceneComponent* const Parent = IsValid(SceneComp) ? SceneComp->GetAttachParent() : nullptr;
 				CompsByParent.Emplace(Parent, MutableComp);
 				CompsByChild.Emplace(MutableComp, Parent);
-				CompsByName.Emplace(GetComponentNameNoSuffix(*Comp), MutableComp);
+				AddArchetypeComponentName(*NewArchetypeComponents, FName{GetComponentNameNoSuffix(*Comp)}, MutableComp);
 				return true;
 			});
 	}
+
+	Cache.Add(*ActorClass, NewArchetypeComponents);
+
+	ArchetypeComponents = NewArchetypeComponents;
+	bComponentsMutable = NewArchetypeComponents->bBlueprintComponents;
+}
+
+ComponentPrivate::FArchetypeComponents& FComponentHierarchy::GetMutableArchetypeComponents()
+{
+	using namespace ComponentPrivate;
+
+	// Other hierarchies of the same class would not see the changes, so they are invalidated together with the cache
+	if (const AActor* const ActorPtr = Actor.Get())
+	{
+		FArchetypeComponentsCache::Get().Invalidate(*ActorPtr->GetClass());
+	}
+
+	if (!ArchetypeComponents.IsValid())
+	{
+		ArchetypeComponents = MakeShared<FArchetypeComponents, ESPMode::ThreadSafe>();
+	}
+	else if (!ArchetypeComponents.IsUnique())
+	{
+		ArchetypeComponents = MakeShared<FArchetypeComponents, ESPMode::ThreadSafe>(*ArchetypeComponents);
+	}
+
+	return *ArchetypeComponents;
+}
+
+FComponentHierarchy::EArchetypeChangeScope FComponentHierarchy::GetArchetypeChangeScope(
+	const UActorComponent& Component) const
+{
+	const AActor* const ActorPtr = Actor.Get();
+	ZKZ_RETURN_IF(
+		!IsValid(ActorPtr) || !ActorPtr->HasAllFlags(RF_ArchetypeObject)
+			|| !Component.HasAllFlags(RF_ArchetypeObject),
+		EArchetypeChangeScope::None);
+
+	const UClass* const OwnerClass = ComponentPrivate::FindArchetypeOwnerClass(Component);
+	ZKZ_RETURN_IF_INVALID(OwnerClass, EArchetypeChangeScope::None);
+
+	if (ActorPtr->GetClass() == OwnerClass)
+	{
+		return EArchetypeChangeScope::Patch;
+	}
+
+	return ActorPtr->GetClass()->IsChildOf(OwnerClass) ? EArchetypeChangeScope::Regather : EArchetypeChangeScope::None;
+}
+
+void FComponentHierarchy::RegatherArchetypeComponents(const UActorComponent& ChangedComponent)
+{
+	using namespace ComponentPrivate;
+
+	const AActor* const ActorPtr = Actor.Get();
+	ZKZ_RETURN_IF_INVALID(ActorPtr);
+
+	// The change may have been made outside of FComponentHierarchy, in which case the cache doesn't know about it
+	if (const UClass* const ChangedClass = FindArchetypeOwnerClass(ChangedComponent))
+	{
+		FArchetypeComponentsCache::Get().Invalidate(*ChangedClass);
+	}
+
+	const bool bWereComponentsMutable = bComponentsMutable;
+	ConstructHierarchyFromCDO(ActorPtr->GetClass());
+	bComponentsMutable = bWereComponentsMutable;
+}
+
+void FComponentHierarchy::PatchAddedArchetypeComponent(UActorComponent& Component)
+{
+	using namespace ComponentPrivate;
+
+	switch (GetArchetypeChangeScope(Component))
+	{
+	case EArchetypeChangeScope::None:
+		return;
+	case EArchetypeChangeScope::Regather:
+		RegatherArchetypeComponents(Component);
+		return;
+	case EArchetypeChangeScope::Patch:
+		break;
+	}
+
+	// Already there if it was added through this hierarchy
+	ZKZ_RETURN_IF(GetArchetypeComponents().CompsByChild.Contains(&Component));
+
+	UActorComponent* const Parent = FindArchetypeParent(Component);
+
+	FArchetypeComponents& MutableArchetypeComponents = GetMutableArchetypeComponents();
+	MutableArchetypeComponents.CompsByParent.Emplace(Parent, &Component);
+	MutableArchetypeComponents.CompsByChild.Emplace(&Component, Parent);
+	AddArchetypeComponentName(MutableArchetypeComponents, FName{GetComponentNameNoSuffix(Component)}, &Component);
+}
+
+void FComponentHierarchy::PatchRemovedArchetypeComponent(const UActorComponent& Component)
+{
+	using namespace ComponentPrivate;
+
+	switch (GetArchetypeChangeScope(Component))
+	{
+	case EArchetypeChangeScope::None:
+		return;
+	case EArchetypeChangeScope::Regather:
+		RegatherArchetypeComponents(Component);
+		return;
+	case EArchetypeChangeScope::Patch:
+		break;
+	}
+
+	// Already gone if it was removed through this hierarchy
+	ZKZ_RETURN_IF(!GetArchetypeComponents().CompsByChild.Contains(&Component));
+
+	FArchetypeComponents& MutableArchetypeComponents = GetMutableArchetypeComponents();
+	RemoveArchetypeComponent(MutableArchetypeComponents, Component);
+	RemoveArchetypeComponentName(MutableArchetypeComponents, Component);
+}
+
+void FComponentHierarchy::PatchArchetypeAttachment(UActorComponent& Component)
+{
+	using namespace ComponentPrivate;
+
+	switch (GetArchetypeChangeScope(Component))
+	{
+	case EArchetypeChangeScope::None:
+		return;
+	case EArchetypeChangeScope::Regather:
+		RegatherArchetypeComponents(Component);
+		return;
+	case EArchetypeChangeScope::Patch:
+		break;
+	}
+
+	const TWeakObjectPtr<UActorComponent>* const FoundParent = GetArchetypeComponents().CompsByChild.Find(&Component);
+	ZKZ_RETURN_IF(FoundParent == nullptr);
+
+	const TWeakObjectPtr<UActorComponent> OldParent = *FoundParent;
+	UActorComponent* const NewParent = FindArchetypeParent(Component);
+	ZKZ_RETURN_IF(OldParent.Get() == NewParent);
+
+	FArchetypeComponents& MutableArchetypeComponents = GetMutableArchetypeComponents();
+	MutableArchetypeComponents.CompsByParent.Remove(OldParent, &Component);
+	MutableArchetypeComponents.CompsByParent.Emplace(NewParent, &Component);
+	MutableArchetypeComponents.CompsByChild.FindChecked(&Component) = NewParent;
 }
 #endif
 
+const ComponentPrivate::FArchetypeComponents& FComponentHierarchy::GetArchetypeComponents() const
+{
+	static const ComponentPrivate::FArchetypeComponents EmptyArchetypeComponents;
+	return ArchetypeComponents.IsValid() ? *ArchetypeComponents : EmptyArchetypeComponents;
+}
+
 UActorComponent* FComponentHierarchy::InternalFindParent(const UActorComponent& Child) const
 {
 	const AActor* const ActorPtr = Actor.Get();
@@ -483,7 +679,7 @@ UActorComponent* FComponentHierarchy::InternalFindParent(const UActorComponent&
 #if WITH_EDITOR
 	if (Actor->HasAllFlags(RF_ArchetypeObject))
 	{
-		const TWeakObjectPtr<UActorComponent>* const FoundParent = CompsByChild.Find(&Child);
+		const TWeakObjectPtr<UActorComponent>* const FoundParent = GetArchetypeComponents().CompsByChild.Find(&Child);
 		return FoundParent == nullptr ? nullptr : FoundParent->Get();
 	}
 	else
@@ -494,6 +690,41 @@ UActorComponent* FComponentHierarchy::InternalFindParent(const UActorComponent&
 	}
 }
 
+FLiveComponentHierarchy::FLiveComponentHierarchy(const AActor& InActor) : FComponentHierarchy{InActor}
+{
+	BindToComponentEvents(InActor);
+}
+
+FLiveComponentHierarchy::FLiveComponentHierarchy(AActor& InActor, const bool bAllowMutableComponents)
+	: FComponentHierarchy{InActor, bAllowMutableComponents}
+{
+	BindToComponentEvents(InActor);
+}
+
+void FLiveComponentHierarchy::BindToComponentEvents(const AActor& InActor)
+{
+#if WITH_EDITOR
+	// Hierarchies of instanced actors read the actor directly, there's nothing to patch
+	ZKZ_RETURN_IF(!InActor.HasAllFlags(RF_ArchetypeObject));
+
+	ComponentEvents::FOnComponentEvent& OnComponentAdded = ComponentEvents::OnComponentAdded();
+	OnComponentAddedHandle = {
+		OnComponentAdded,
+		OnComponentAdded.AddLambda([this](UActorComponent& Component) { PatchAddedArchetypeComponent(Component); })};
+
+	ComponentEvents::FOnComponentEvent& OnComponentRemoved = ComponentEvents::OnComponentRemoved();
+	OnComponentRemovedHandle = {
+		OnComponentRemoved,
+		OnComponentRemoved.AddLambda([this](const UActorComponent& Component)
+									 { PatchRemovedArchetypeComponent(Component); })};
+
+	ComponentEvents::FOnComponentEvent& OnAttachmentChanged = ComponentEvents::OnAttachmentChanged();
+	OnAttachmentChangedHandle = {
+		OnAttachmentChanged,
+		OnAttachmentChanged.AddLambda([this](UActorComponent& Component) { PatchArchetypeAttachment(Component); })};
+#endif
+}
+
 AActor* GetOwner(const USceneComponent& SceneComp)
 {
 #if WITH_EDITOR
@@ -513,36 +744,6 @@ AActor* GetOwner(const USceneComponent& SceneComp)
 	return SceneComp.GetOwner();
 }
 
-UActorComponent* FindComponentInSubtree(
-	UActorComponent& RootComp, const TFunction<bool(const UActorComponent&)>& Predicate)
-{
-	UActorComponent* FoundComp = nullptr;
-
-	const auto StoreIfSatisfiesPred = [&FoundComp, &Predicate](UActorComponent& Comp)
-	{
-		if (Predicate(Comp))
-		{
-			FoundComp = &Comp;
-			// Component found, return false to stop traversal
-			return false;
-		}
-
-		// Continue traversal
-		return true;
-	};
-
-	FComponentHierarchy{RootComp}
-		.ForEachComponentInSubtree<EForEachComponentRecursionType::PrefixCond>(RootComp, StoreIfSatisfiesPred);
-
-	return FoundComp;
-}
-
-const UActorComponent* FindComponentInSubtree(
-	const UActorComponent& RootComp, const TFunction<bool(const UActorComponent&)>& Predicate)
-{
-	return FindComponentInSubtree(const_cast<UActorComponent&>(RootComp), Predicate);
-}
-
 UActorComponent* FindComponentInSubtreeByName(UActorComponent& RootComp, const FName& Name)
 {
 	const FString NameNoSuffix = GetComponentNameNoSuffix(Name);
@@ -586,6 +787,230 @@ int32 RemoveSubobject(
 	return FComponentHierarchy{Owner, true}.RemoveSubobject(Comp, MarkBlueprintAsStructurallyModified);
 }
 
+FSubobjectEditBatch::FSubobjectEditBatch(
+	FComponentHierarchy& InHierarchy, const EMarkBlueprintAsStructurallyModified InMarkBlueprintAsStructurallyModified)
+	: Hierarchy{InHierarchy}
+	, MarkBlueprintAsStructurallyModified{InMarkBlueprintAsStructurallyModified}
+{
+	++Hierarchy.OpenEditBatches.Num;
+}
+
+FSubobjectEditBatch::~FSubobjectEditBatch()
+{
+	Commit();
+	--Hierarchy.OpenEditBatches.Num;
+}
+
+FSubobjectEditBatch::FAddId FSubobjectEditBatch::AddNewSubobject(
+	UClass& Class, UActorComponent* ParentComp, const FName& Name)
+{
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Class.IsChildOf(UActorComponent::StaticClass()), INDEX_NONE);
+
+	return QueuedAdds.Emplace(FQueuedAdd{&Class, ParentComp, INDEX_NONE, Name});
+}
+
+FSubobjectEditBatch::FAddId FSubobjectEditBatch::AddNewSubobject(
+	UClass& Class, const FAddId ParentAddId, const FName& Name)
+{
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Class.IsChildOf(UActorComponent::StaticClass()), INDEX_NONE);
+	ZKZ_RETURN_IF_ENSUREALWAYS(!QueuedAdds.IsValidIndex(ParentAddId), INDEX_NONE);
+
+	return QueuedAdds.Emplace(FQueuedAdd{&Class, nullptr, ParentAddId, Name});
+}
+
+void FSubobjectEditBatch::RemoveSubobject(const UActorComponent& Comp)
+{
+	QueuedRemoves.AddUnique(TWeakObjectPtr<const UActorComponent>{&Comp});
+}
+
+void FSubobjectEditBatch::Commit()
+{
+	using namespace ComponentPrivate;
+
+	ZKZ_RETURN_IF(NumCommittedAdds == QueuedAdds.Num() && QueuedRemoves.IsEmpty());
+
+	// The queued edits are only taken once everything needed to apply them has been checked, so they aren't lost
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Hierarchy.bComponentsMutable);
+
+	AActor* const ActorPtr = Hierarchy.Actor.Get();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ActorPtr);
+
+	USubobjectDataSubsystem* const SubobjectDataSubsystem = USubobjectDataSubsystem::Get();
+	ZKZ_RETURN_IF_INVALID(SubobjectDataSubsystem);
+
+	TArray<FSubobjectDataHandle> SubobjectDataHandles;
+	SubobjectDataSubsystem->GatherSubobjectData(ActorPtr, SubobjectDataHandles);
+	ZKZ_RETURN_IF_ENSUREALWAYS(SubobjectDataHandles.IsEmpty());
+
+	UBlueprint* const Blueprint = GetBlueprint(*ActorPtr);
+	ZKZ_RETURN_IF_INVALID(Blueprint);
+	const UClass* const BlueprintGeneratedClass = Blueprint->GeneratedClass;
+	ZKZ_RETURN_IF_INVALID(BlueprintGeneratedClass);
+	ZKZ_RETURN_IF_ENSUREALWAYS(ActorPtr != BlueprintGeneratedClass->GetDefaultObject(false));
+
+	const FSubobjectDataHandle* const FoundOwnerDataHandle = FindSubobjectDataHandle(SubobjectDataHandles, *ActorPtr);
+	ZKZ_RETURN_IF(FoundOwnerDataHandle == nullptr);
+	// Copied, as added subobjects are appended to SubobjectDataHandles
+	const FSubobjectDataHandle OwnerDataHandle = *FoundOwnerDataHandle;
+
+	const int32 FirstAddIdx = NumCommittedAdds;
+	NumCommittedAdds = QueuedAdds.Num();
+	const TArray<TWeakObjectPtr<const UActorComponent>> Removes = MoveTemp(QueuedRemoves);
+	QueuedRemoves.Reset();
+
+	TArray<UActorComponent*> AddedComps;
+	for (int32 AddIdx = FirstAddIdx; AddIdx < QueuedAdds.Num(); ++AddIdx)
+	{
+		UActorComponent* const NewComp =
+			ApplyAdd(QueuedAdds[AddIdx], *SubobjectDataSubsystem, *Blueprint, OwnerDataHandle, SubobjectDataHandles);
+		ZKZ_CONTINUE_IF(NewComp == nullptr);
+		AddedComps.Emplace(NewComp);
+	}
+
+	TArray<UActorComponent*> RemovedComps;
+	const int32 NumRemovedNow = ApplyRemoves(
+		Removes, RemovedComps, *SubobjectDataSubsystem, *Blueprint, OwnerDataHandle, SubobjectDataHandles);
+	NumRemoved += NumRemovedNow;
+
+	if (MarkBlueprintAsStructurallyModified == EMarkBlueprintAsStructurallyModified::Enabled &&
+		(!AddedComps.IsEmpty() || NumRemovedNow > 0))
+	{
+		FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+	}
+
+	for (UActorComponent* const AddedComp : AddedComps)
+	{
+		ComponentEvents::OnComponentAdded().Broadcast(*AddedComp);
+	}
+
+	for (UActorComponent* const RemovedComp : RemovedComps)
+	{
+		ComponentEvents::OnComponentRemoved().Broadcast(*RemovedComp);
+	}
+}
+
+UActorComponent* FSubobjectEditBatch::GetAddedComponent(const FAddId AddId) const
+{
+	ZKZ_RETURN_IF(!QueuedAdds.IsValidIndex(AddId), nullptr);
+
+	return QueuedAdds[AddId].AddedComp.Get();
+}
+
+UActorComponent* FSubobjectEditBatch::ApplyAdd(
+	FQueuedAdd& Add,
+	USubobjectDataSubsystem& SubobjectDataSubsystem,
+	UBlueprint& Blueprint,
+	const FSubobjectDataHandle& OwnerDataHandle,
+	TArray<FSubobjectDataHandle>& SubobjectDataHandles)
+{
+	using namespace ComponentPrivate;
+
+	ZKZ_RETURN_IF_INVALID(Add.Class, nullptr);
+
+	UActorComponent* const ParentComp =
+		Add.ParentAddId == INDEX_NONE ? Add.ParentComp.Get() : QueuedAdds[Add.ParentAddId].AddedComp.Get();
+	// The parent was added earlier in this batch, but failed
+	ZKZ_RETURN_IF(Add.ParentAddId != INDEX_NONE && ParentComp == nullptr, nullptr);
+
+	const FSubobjectDataHandle* const ParentDataHandle =
+		ParentComp == nullptr ? &OwnerDataHandle : FindSubobjectDataHandle(SubobjectDataHandles, *ParentComp);
+	ZKZ_RETURN_IF_ENSUREALWAYS(ParentDataHandle == nullptr, nullptr);
+
+	FAddNewSubobjectParams Params;
+	Params.ParentHandle = *ParentDataHandle;
+	Params.NewClass = Add.Class;
+	Params.AssetOverride = nullptr;
+	Params.BlueprintContext = &Blueprint;
+	Params.bSkipMarkBlueprintModified = true;  // conditionally marking blueprint as modified once, in Commit
+
+	FText FailReason;
+	const FSubobjectDataHandle NewSubobjectHandle = SubobjectDataSubsystem.AddNewSubobject(Params, FailReason);
+
+	ZKZ_RETURN_IF(!NewSubobjectHandle.IsValid(), nullptr);
+
+	const FSubobjectData* const NewSubobjectHandleData = NewSubobjectHandle.GetData();
+	ZKZ_RETURN_IF(NewSubobjectHandleData == nullptr, nullptr);
+
+	const UObject* const NewObject = NewSubobjectHandleData->GetObjectForBlueprint(&Blueprint);
+
+	// The const_cast here should be fine. We know the hierarchy is mutable, as checked in Commit
+	UActorComponent* const NewComp = const_cast<UActorComponent*>(Cast<UActorComponent>(NewObject));
+	ZKZ_RETURN_IF_INVALID(NewComp, nullptr);
+	ZKZ_RETURN_IF_ENSUREALWAYS(!NewComp->HasAllFlags(RF_ArchetypeObject), nullptr);
+
+	const bool bRenameSuccessful =
+		SubobjectDataSubsystem.RenameSubobject(NewSubobjectHandle, FText::FromName(Add.Name));
+	if (!bRenameSuccessful)
+	{
+		// #TODO #Buildings: would be nice to handle it more gracefully, but I don't have an idea how ATM
+		const int32 NumDeleted =
+			SubobjectDataSubsystem.DeleteSubobjects(OwnerDataHandle, {NewSubobjectHandle}, &Blueprint);
+		ensureMsgf(NumDeleted > 0, TEXT("Failed to rename newly created subobject, then failed to remove it."));
+		return nullptr;
+	}
+
+	// Later additions in the batch may be parented to this one
+	SubobjectDataHandles.Emplace(NewSubobjectHandle);
+
+	FArchetypeComponents& MutableArchetypeComponents = Hierarchy.GetMutableArchetypeComponents();
+	MutableArchetypeComponents.CompsByParent.Emplace(ParentComp, NewComp);
+	MutableArchetypeComponents.CompsByChild.Emplace(NewComp, ParentComp);
+	AddArchetypeComponentName(MutableArchetypeComponents, Add.Name, NewComp);
+
+	Add.AddedComp = NewComp;
+
+	return NewComp;
+}
+
+int32 FSubobjectEditBatch::ApplyRemoves(
+	const TArray<TWeakObjectPtr<const UActorComponent>>& Removes,
+	TArray<UActorComponent*>& OutRemovedComps,
+	USubobjectDataSubsystem& SubobjectDataSubsystem,
+	UBlueprint& Blueprint,
+	const FSubobjectDataHandle& OwnerDataHandle,
+	const TArray<FSubobjectDataHandle>& SubobjectDataHandles)
+{
+	using namespace ComponentPrivate;
+
+	TArray<FSubobjectDataHandle> CompDataHandles;
+	TArray<FName> CompNames;
+	for (const TWeakObjectPtr<const UActorComponent>& WeakComp : Removes)
+	{
+		const UActorComponent* const Comp = WeakComp.Get();
+		ZKZ_CONTINUE_IF_INVALID(Comp);
+		const FSubobjectDataHandle* const CompDataHandle = FindSubobjectDataHandle(SubobjectDataHandles, *Comp);
+		ZKZ_CONTINUE_IF_ENSUREALWAYS(CompDataHandle == nullptr);
+
+		CompDataHandles.Emplace(*CompDataHandle);
+		CompNames.Emplace(GetComponentNameNoSuffix(*Comp));
+		// This const cast is fine - the hierarchy is mutable, as checked in Commit
+		OutRemovedComps.Emplace(const_cast<UActorComponent*>(Comp));
+	}
+
+	ZKZ_RETURN_IF(CompDataHandles.IsEmpty(), 0);
+
+	const int32 NumRemovedNow = SubobjectDataSubsystem.DeleteSubobjects(OwnerDataHandle, CompDataHandles, &Blueprint);
+	if (NumRemovedNow == 0)
+	{
+		OutRemovedComps.Reset();
+		return 0;
+	}
+
+	FArchetypeComponents& MutableArchetypeComponents = Hierarchy.GetMutableArchetypeComponents();
+
+	for (const UActorComponent* const Comp : OutRemovedComps)
+	{
+		RemoveArchetypeComponent(MutableArchetypeComponents, *Comp);
+	}
+
+	for (const FName CompName : CompNames)
+	{
+		RemoveArchetypeComponentName(MutableArchetypeComponents, CompName);
+	}
+
+	return NumRemovedNow;
+}
+
 }  // namespace Editor
 #endif
 
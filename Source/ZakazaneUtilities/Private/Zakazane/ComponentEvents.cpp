@@ -0,0 +1,68 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ComponentEvents.h"
+
+#include "Components/SceneComponent.h"
+#include "Zakazane/ReturnIfMacros.h"
+
+namespace Zkz::ComponentEvents
+{
+
+namespace ComponentEventsPrivate
+{
+
+struct FEvents
+{
+	FOnComponentEvent OnComponentAdded;
+	FOnComponentEvent OnComponentRemoved;
+	FOnComponentEvent OnAttachmentChanged;
+
+	static FEvents& Get()
+	{
+		// Intentionally leaked, engine delegates may still be broadcast during static destruction
+		static FEvents* const Events = new FEvents;
+		return *Events;
+	}
+
+private:
+	FEvents()
+	{
+		UActorComponent::GlobalRegisterComponentDelegate.AddLambda(
+			[this](UActorComponent* const Component)
+			{
+				ZKZ_RETURN_IF(Component == nullptr);
+				OnComponentAdded.Broadcast(*Component);
+			});
+
+		UActorComponent::GlobalUnregisterComponentDelegate.AddLambda(
+			[this](UActorComponent* const Component)
+			{
+				ZKZ_RETURN_IF(Component == nullptr);
+				OnComponentRemoved.Broadcast(*Component);
+			});
+	}
+};
+
+}  // namespace ComponentEventsPrivate
+
+FOnComponentEvent& OnComponentAdded()
+{
+	return ComponentEventsPrivate::FEvents::Get().OnComponentAdded;
+}
+
+FOnComponentEvent& OnComponentRemoved()
+{
+	return ComponentEventsPrivate::FEvents::Get().OnComponentRemoved;
+}
+
+FOnComponentEvent& OnAttachmentChanged()
+{
+	return ComponentEventsPrivate::FEvents::Get().OnAttachmentChanged;
+}
+
+void BroadcastAttachmentChanged(USceneComponent& Component)
+{
+	OnAttachmentChanged().Broadcast(Component);
+}
+
+}  // namespace Zkz::ComponentEvents
@@ -0,0 +1,132 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ComponentHierarchySnapshot.h"
+
+#include "Zakazane/Parallel.h"
+
+namespace Zkz
+{
+
+namespace ComponentHierarchySnapshotPrivate
+{
+
+/// A few chunks per worker, so workers which get cheaper chunks pick up more of them
+constexpr int32 NumParallelChunksPerWorker = 4;
+
+}  // namespace ComponentHierarchySnapshotPrivate
+
+FComponentHierarchySnapshot::FComponentHierarchySnapshot(const FComponentHierarchy& Hierarchy)
+	: bComponentsMutable{Hierarchy.ComponentsMutable()}
+{
+	Hierarchy.ForEachRootComponent(
+		[this, &Hierarchy](const UActorComponent& RootComponent)
+		{ AddSubtree(Hierarchy, RootComponent, INDEX_NONE); });
+}
+
+int32 FComponentHierarchySnapshot::FindIndex(const UActorComponent& Component) const
+{
+	const int32* const FoundIdx = IndicesByComponent.Find(&Component);
+	return FoundIdx == nullptr ? INDEX_NONE : *FoundIdx;
+}
+
+UActorComponent& FComponentHierarchySnapshot::GetMutableComponent(const int32 NodeIdx) const
+{
+	ensureAlways(bComponentsMutable);
+	return *Components[NodeIdx];
+}
+
+int32 FComponentHierarchySnapshot::FindIndexByName(const FName Name) const
+{
+	return FindIndexInRangeByName(0, Components.Num(), Name);
+}
+
+int32 FComponentHierarchySnapshot::FindIndexInSubtreeByName(const int32 RootIdx, const FName Name) const
+{
+	ZKZ_RETURN_IF(!IsValidIndex(RootIdx), INDEX_NONE);
+
+	return FindIndexInRangeByName(RootIdx, SubtreeEnds[RootIdx], Name);
+}
+
+int32 FComponentHierarchySnapshot::FindIndexInRangeByName(
+	const int32 BeginIdx, const int32 EndIdx, const FName Name) const
+{
+	const FName NameNoSuffix{GetComponentNameNoSuffix(Name)};
+
+	int32 FoundIdx = INDEX_NONE;
+	for (auto It = IndicesByName.CreateConstKeyIterator(NameNoSuffix); It; ++It)
+	{
+		const int32 NodeIdx = It.Value();
+		if (BeginIdx <= NodeIdx && NodeIdx < EndIdx && (FoundIdx == INDEX_NONE || NodeIdx < FoundIdx))
+		{
+			FoundIdx = NodeIdx;
+		}
+	}
+
+	return FoundIdx;
+}
+
+bool FComponentHierarchySnapshot::IsDescendant(
+	const UActorComponent& Ancestor, const UActorComponent& Descendant) const
+{
+	const int32 AncestorIdx = FindIndex(Ancestor);
+	const int32 DescendantIdx = FindIndex(Descendant);
+	ZKZ_RETURN_IF(AncestorIdx == INDEX_NONE || DescendantIdx == INDEX_NONE, false);
+
+	return IsDescendant(AncestorIdx, DescendantIdx);
+}
+
+TArray<int32> FComponentHierarchySnapshot::MakeParallelChunkBounds(const int32 BeginIdx, const int32 EndIdx) const
+{
+	using namespace ComponentHierarchySnapshotPrivate;
+
+	TArray<int32> Bounds{BeginIdx};
+	ZKZ_RETURN_IF(BeginIdx >= EndIdx, Bounds);
+
+	const int32 NumNodes = EndIdx - BeginIdx;
+	const int32 NumChunks = FMath::Min(ParallelPrivate::GetNumChunks(NumNodes) * NumParallelChunksPerWorker, NumNodes);
+	const int32 ChunkSize = FMath::DivideAndRoundUp(NumNodes, NumChunks);
+
+	// Whole subtrees are appended to the current chunk, or descended into if they're too large to fit in a chunk.
+	// Either way, the next node in preorder comes right after what's been appended, so chunks stay contiguous.
+	int32 ChunkBegin = BeginIdx;
+	for (int32 NodeIdx = BeginIdx; NodeIdx < EndIdx;)
+	{
+		NodeIdx = SubtreeEnds[NodeIdx] - NodeIdx <= ChunkSize ? SubtreeEnds[NodeIdx] : NodeIdx + 1;
+
+		if (NodeIdx - ChunkBegin >= ChunkSize)
+		{
+			Bounds.Emplace(NodeIdx);
+			ChunkBegin = NodeIdx;
+		}
+	}
+
+	if (Bounds.Last() != EndIdx)
+	{
+		Bounds.Emplace(EndIdx);
+	}
+
+	return Bounds;
+}
+
+void FComponentHierarchySnapshot::AddSubtree(
+	const FComponentHierarchy& Hierarchy, const UActorComponent& Component, const int32 ParentIdx)
+{
+	// Guards against cycles and components reachable from multiple roots, which would break the preorder layout
+	ZKZ_RETURN_IF_ENSUREALWAYS(IndicesByComponent.Contains(&Component));
+
+	// This const cast is fine - mutable access is only given out if bComponentsMutable is true, as in the hierarchy
+	const int32 NodeIdx = Components.Emplace(const_cast<UActorComponent*>(&Component));
+	ParentIndices.Emplace(ParentIdx);
+	SubtreeEnds.Emplace(INDEX_NONE);
+	IndicesByComponent.Emplace(&Component, NodeIdx);
+	IndicesByName.Emplace(FName{GetComponentNameNoSuffix(Component)}, NodeIdx);
+
+	Hierarchy.ForEachChildComponent(
+		Component,
+		[this, &Hierarchy, NodeIdx](const UActorComponent& ChildComponent)
+		{ AddSubtree(Hierarchy, ChildComponent, NodeIdx); });
+
+	SubtreeEnds[NodeIdx] = Components.Num();
+}
+
+}  // namespace Zkz
@@ -0,0 +1,404 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ComponentIndexSubsystem.h"
+
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/Actor.h"
+#include "Zakazane/ComponentEvents.h"
+
+namespace Zkz::ComponentIndexSubsystemPrivate
+{
+
+/// Bit arrays of classes and tags only cover entries up to the last one they've had set, they're extended on demand
+void SetBit(TBitArray<>& Bits, const int32 Idx, const bool bValue)
+{
+	if (Idx >= Bits.Num())
+	{
+		ZKZ_RETURN_IF(!bValue);
+		Bits.Add(false, Idx + 1 - Bits.Num());
+	}
+
+	Bits[Idx] = bValue;
+}
+
+}  // namespace Zkz::ComponentIndexSubsystemPrivate
+
+void UZkzComponentIndexSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	UWorld* const World = GetWorld();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(World);
+
+	OnActorSpawnedHandle =
+		World->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &ThisClass::OnActorSpawned));
+	OnActorDestroyedHandle = World->AddOnActorDestroyedHandler(
+		FOnActorDestroyed::FDelegate::CreateUObject(this, &ThisClass::OnActorDestroyed));
+	OnLevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ThisClass::OnLevelAddedToWorld);
+	OnLevelRemovedHandle = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &ThisClass::OnLevelRemovedFromWorld);
+
+	OnComponentAddedHandle = Zkz::ComponentEvents::OnComponentAdded().AddUObject(this, &ThisClass::OnComponentChanged);
+	OnComponentRemovedHandle =
+		Zkz::ComponentEvents::OnComponentRemoved().AddUObject(this, &ThisClass::OnComponentChanged);
+	OnAttachmentChangedHandle =
+		Zkz::ComponentEvents::OnAttachmentChanged().AddUObject(this, &ThisClass::OnComponentChanged);
+}
+
+void UZkzComponentIndexSubsystem::Deinitialize()
+{
+	if (UWorld* const World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(OnActorSpawnedHandle);
+		World->RemoveOnActorDestroyededHandler(OnActorDestroyedHandle);
+	}
+
+	FWorldDelegates::LevelAddedToWorld.Remove(OnLevelAddedHandle);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(OnLevelRemovedHandle);
+
+	Zkz::ComponentEvents::OnComponentAdded().Remove(OnComponentAddedHandle);
+	Zkz::ComponentEvents::OnComponentRemoved().Remove(OnComponentRemovedHandle);
+	Zkz::ComponentEvents::OnAttachmentChanged().Remove(OnAttachmentChangedHandle);
+
+	Super::Deinitialize();
+}
+
+void UZkzComponentIndexSubsystem::InvalidateActor(const AActor& Actor)
+{
+	ActorsToRemove.Remove(&Actor);
+	ActorsToRefresh.Emplace(&Actor);
+}
+
+int32 UZkzComponentIndexSubsystem::GetNumComponents()
+{
+	Flush();
+	return EntriesByComponent.Num();
+}
+
+TBitArray<> UZkzComponentIndexSubsystem::MakeClassMask(const UClass& Class)
+{
+	Flush();
+
+	TBitArray<> Mask{false, Components.Num()};
+
+	for (int32 ClassId = 0; ClassId < Classes.Num(); ++ClassId)
+	{
+		const UClass* const EntryClass = Classes[ClassId].Get();
+		if (EntryClass != nullptr && EntryClass->IsChildOf(&Class))
+		{
+			Mask.CombineWithBitwiseOR(EntriesByClass[ClassId], EBitwiseOperatorFlags::MaintainSize);
+		}
+	}
+
+	return Mask;
+}
+
+TBitArray<> UZkzComponentIndexSubsystem::MakeTagMask(const TArrayView<const FName> Tags)
+{
+	Flush();
+
+	TBitArray<> Mask{false, Components.Num()};
+
+	for (const FName Tag : Tags)
+	{
+		if (const int32* const TagId = TagIds.Find(Tag))
+		{
+			Mask.CombineWithBitwiseOR(EntriesByTag[*TagId], EBitwiseOperatorFlags::MaintainSize);
+		}
+	}
+
+	return Mask;
+}
+
+UActorComponent* UZkzComponentIndexSubsystem::FindAttachParent(const UActorComponent& Component)
+{
+	Flush();
+
+	const int32* const Entry = EntriesByComponent.Find(&Component);
+	ZKZ_RETURN_IF(Entry == nullptr || ParentEntries[*Entry] == INDEX_NONE, nullptr);
+
+	return Components[ParentEntries[*Entry]].Get();
+}
+
+void UZkzComponentIndexSubsystem::Flush()
+{
+	if (bNeedsFullRebuild)
+	{
+		bNeedsFullRebuild = false;
+
+		if (UWorld* const World = GetWorld())
+		{
+			for (TActorIterator<AActor> It{World}; It; ++It)
+			{
+				ActorsToRefresh.Emplace(*It);
+			}
+		}
+	}
+
+	ZKZ_RETURN_IF(ActorsToRefresh.IsEmpty() && ActorsToRemove.IsEmpty());
+
+	for (const TObjectKey<AActor>& ActorKey : ActorsToRemove)
+	{
+		RemoveActor(ActorKey);
+	}
+	ActorsToRemove.Reset();
+
+	// Parents are resolved once all actors are refreshed, as they may be attached to each other
+	TArray<int32> RefreshedEntries;
+
+	for (const TObjectKey<AActor>& ActorKey : ActorsToRefresh)
+	{
+		AActor* const Actor = ActorKey.ResolveObjectPtr();
+		if (IsValid(Actor) && Actor->GetWorld() == GetWorld() && !Actor->IsActorBeingDestroyed())
+		{
+			RefreshActor(*Actor, RefreshedEntries);
+		}
+		else
+		{
+			RemoveActor(ActorKey);
+		}
+	}
+	ActorsToRefresh.Reset();
+
+	for (const int32 EntryIdx : RefreshedEntries)
+	{
+		ResolveParentEntry(EntryIdx);
+	}
+}
+
+void UZkzComponentIndexSubsystem::RefreshActor(AActor& Actor, TArray<int32>& OutRefreshedEntries)
+{
+	TArray<int32>& ActorEntries = EntriesByActor.FindOrAdd(&Actor);
+	const TArray<int32> PreviousEntries = MoveTemp(ActorEntries);
+	ActorEntries.Reset();
+
+	// Components which are still there keep their entries, so entries of other actors can keep referring to them
+	Actor.ForEachComponent(
+		false,
+		[this, &Actor, &ActorEntries](UActorComponent* const Component)
+		{
+			ZKZ_RETURN_IF(!IsValid(Component));
+
+			const int32* const ExistingEntry = EntriesByComponent.Find(Component);
+			const int32 EntryIdx = ExistingEntry != nullptr ? *ExistingEntry : AllocateEntry();
+
+			OwnerKeys[EntryIdx] = &Actor;
+			SetEntryComponent(EntryIdx, *Component);
+			ActorEntries.Emplace(EntryIdx);
+		});
+
+	TSet<int32> CurrentEntries;
+	if (!PreviousEntries.IsEmpty())
+	{
+		CurrentEntries.Append(ActorEntries);
+	}
+
+	for (const int32 EntryIdx : PreviousEntries)
+	{
+		if (!CurrentEntries.Contains(EntryIdx) && OwnerKeys[EntryIdx] == TObjectKey<AActor>{&Actor})
+		{
+			RemoveEntry(EntryIdx);
+		}
+	}
+
+	OutRefreshedEntries.Append(ActorEntries);
+}
+
+void UZkzComponentIndexSubsystem::RemoveActor(const TObjectKey<AActor>& ActorKey)
+{
+	TArray<int32> ActorEntries;
+	ZKZ_RETURN_IF(!EntriesByActor.RemoveAndCopyValue(ActorKey, ActorEntries));
+
+	for (const int32 EntryIdx : ActorEntries)
+	{
+		// The component may have been moved to another actor since
+		if (OwnerKeys[EntryIdx] == ActorKey)
+		{
+			RemoveEntry(EntryIdx);
+		}
+	}
+}
+
+int32 UZkzComponentIndexSubsystem::AllocateEntry()
+{
+	if (!FreeEntries.IsEmpty())
+	{
+		return FreeEntries.Pop(EAllowShrinking::No);
+	}
+
+	ComponentKeys.AddDefaulted();
+	OwnerKeys.AddDefaulted();
+	ParentEntries.Emplace(INDEX_NONE);
+	ClassIds.Emplace(INDEX_NONE);
+	TagIdsByEntry.AddDefaulted();
+	return Components.AddDefaulted();
+}
+
+void UZkzComponentIndexSubsystem::SetEntryComponent(const int32 EntryIdx, UActorComponent& Component)
+{
+	using namespace Zkz::ComponentIndexSubsystemPrivate;
+
+	Components[EntryIdx] = &Component;
+	ComponentKeys[EntryIdx] = &Component;
+	EntriesByComponent.Emplace(&Component, EntryIdx);
+
+	if (ClassIds[EntryIdx] != INDEX_NONE)
+	{
+		SetBit(EntriesByClass[ClassIds[EntryIdx]], EntryIdx, false);
+	}
+	ClassIds[EntryIdx] = FindOrAddClassId(*Component.GetClass());
+	SetBit(EntriesByClass[ClassIds[EntryIdx]], EntryIdx, true);
+
+	for (const int32 TagId : TagIdsByEntry[EntryIdx])
+	{
+		SetBit(EntriesByTag[TagId], EntryIdx, false);
+	}
+	TagIdsByEntry[EntryIdx].Reset();
+
+	for (const FName Tag : Component.ComponentTags)
+	{
+		const int32 TagId = TagIds.FindOrAdd(Tag, EntriesByTag.Num());
+		if (TagId == EntriesByTag.Num())
+		{
+			EntriesByTag.AddDefaulted();
+		}
+
+		SetBit(EntriesByTag[TagId], EntryIdx, true);
+		TagIdsByEntry[EntryIdx].Emplace(TagId);
+	}
+}
+
+void UZkzComponentIndexSubsystem::RemoveEntry(const int32 EntryIdx)
+{
+	using namespace Zkz::ComponentIndexSubsystemPrivate;
+
+	EntriesByComponent.Remove(ComponentKeys[EntryIdx]);
+
+	if (ClassIds[EntryIdx] != INDEX_NONE)
+	{
+		SetBit(EntriesByClass[ClassIds[EntryIdx]], EntryIdx, false);
+	}
+	for (const int32 TagId : TagIdsByEntry[EntryIdx])
+	{
+		SetBit(EntriesByTag[TagId], EntryIdx, false);
+	}
+
+	if (ParentEntries[EntryIdx] != INDEX_NONE)
+	{
+		ChildEntriesByParent.RemoveSingle(ParentEntries[EntryIdx], EntryIdx);
+	}
+
+	// Children in other actors are detached in the index until their actors are refreshed
+	TArray<int32> ChildEntries;
+	ChildEntriesByParent.MultiFind(EntryIdx, ChildEntries);
+	for (const int32 ChildEntry : ChildEntries)
+	{
+		ParentEntries[ChildEntry] = INDEX_NONE;
+	}
+	ChildEntriesByParent.Remove(EntryIdx);
+
+	Components[EntryIdx].Reset();
+	ComponentKeys[EntryIdx] = {};
+	OwnerKeys[EntryIdx] = {};
+	ParentEntries[EntryIdx] = INDEX_NONE;
+	ClassIds[EntryIdx] = INDEX_NONE;
+	TagIdsByEntry[EntryIdx].Reset();
+
+	FreeEntries.Emplace(EntryIdx);
+}
+
+void UZkzComponentIndexSubsystem::ResolveParentEntry(const int32 EntryIdx)
+{
+	const USceneComponent* const SceneComponent = Cast<USceneComponent>(Components[EntryIdx].Get());
+	const USceneComponent* const AttachParent = SceneComponent != nullptr ? SceneComponent->GetAttachParent() : nullptr;
+	const int32* const FoundParentEntry = AttachParent != nullptr ? EntriesByComponent.Find(AttachParent) : nullptr;
+	const int32 ParentEntry = FoundParentEntry != nullptr ? *FoundParentEntry : INDEX_NONE;
+
+	ZKZ_RETURN_IF(ParentEntries[EntryIdx] == ParentEntry);
+
+	if (ParentEntries[EntryIdx] != INDEX_NONE)
+	{
+		ChildEntriesByParent.RemoveSingle(ParentEntries[EntryIdx], EntryIdx);
+	}
+
+	ParentEntries[EntryIdx] = ParentEntry;
+
+	if (ParentEntry != INDEX_NONE)
+	{
+		ChildEntriesByParent.Add(ParentEntry, EntryIdx);
+	}
+}
+
+int32 UZkzComponentIndexSubsystem::FindOrAddClassId(UClass& Class)
+{
+	if (const int32* const ClassId = ClassIdsByClass.Find(&Class))
+	{
+		return *ClassId;
+	}
+
+	EntriesByClass.AddDefaulted();
+	const int32 ClassId = Classes.Emplace(&Class);
+	ClassIdsByClass.Emplace(&Class, ClassId);
+	return ClassId;
+}
+
+void UZkzComponentIndexSubsystem::OnActorSpawned(AActor* const Actor)
+{
+	ZKZ_RETURN_IF_INVALID(Actor);
+	InvalidateActor(*Actor);
+}
+
+void UZkzComponentIndexSubsystem::OnActorDestroyed(AActor* const Actor)
+{
+	ZKZ_RETURN_IF(Actor == nullptr);
+
+	ActorsToRefresh.Remove(Actor);
+	ActorsToRemove.Emplace(Actor);
+}
+
+void UZkzComponentIndexSubsystem::OnLevelAddedToWorld(ULevel* const Level, UWorld* const World)
+{
+	ZKZ_RETURN_IF(Level == nullptr || World != GetWorld());
+
+	for (AActor* const Actor : Level->Actors)
+	{
+		ZKZ_CONTINUE_IF_INVALID(Actor);
+		InvalidateActor(*Actor);
+	}
+}
+
+void UZkzComponentIndexSubsystem::OnLevelRemovedFromWorld(ULevel* const Level, UWorld* const World)
+{
+	ZKZ_RETURN_IF(World != GetWorld());
+
+	// A null level means all levels are being removed
+	if (Level == nullptr)
+	{
+		bNeedsFullRebuild = true;
+		ActorsToRefresh.Reset();
+		for (const TPair<TObjectKey<AActor>, TArray<int32>>& ActorEntries : EntriesByActor)
+		{
+			ActorsToRemove.Emplace(ActorEntries.Key);
+		}
+		return;
+	}
+
+	for (AActor* const Actor : Level->Actors)
+	{
+		ZKZ_CONTINUE_IF(Actor == nullptr);
+
+		ActorsToRefresh.Remove(Actor);
+		ActorsToRemove.Emplace(Actor);
+	}
+}
+
+void UZkzComponentIndexSubsystem::OnComponentChanged(UActorComponent& Component)
+{
+	// Components of actors in other worlds and archetype components are of no interest
+	const AActor* const Owner = Component.GetOwner();
+	ZKZ_RETURN_IF(Owner == nullptr || Owner->GetWorld() != GetWorld());
+
+	InvalidateActor(*Owner);
+}
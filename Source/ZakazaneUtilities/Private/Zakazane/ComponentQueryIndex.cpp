@@ -0,0 +1,120 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ComponentQueryIndex.h"
+
+namespace Zkz
+{
+
+FComponentQueryIndex::FComponentQueryIndex(const FComponentHierarchySnapshot& InSnapshot) : Snapshot{InSnapshot}
+{
+	const int32 NumNodes = Snapshot.Num();
+
+	for (int32 NodeIdx = 0; NodeIdx < NumNodes; ++NodeIdx)
+	{
+		const UActorComponent& Component = Snapshot.GetComponent(NodeIdx);
+
+		for (const FName Tag : Component.ComponentTags)
+		{
+			const int32 TagId = TagIds.FindOrAdd(Tag, NodesByTag.Num());
+			if (TagId == NodesByTag.Num())
+			{
+				NodesByTag.Emplace(false, NumNodes);
+			}
+
+			NodesByTag[TagId][NodeIdx] = true;
+		}
+
+		const UClass* const Class = Component.GetClass();
+		int32 ClassId = Classes.Find(Class);
+		if (ClassId == INDEX_NONE)
+		{
+			ClassId = Classes.Emplace(Class);
+			NodesByClass.Emplace(false, NumNodes);
+		}
+
+		NodesByClass[ClassId][NodeIdx] = true;
+	}
+}
+
+TBitArray<> FComponentQueryIndex::MakeTagMask(const TArrayView<const FName> Tags) const
+{
+	TBitArray<> Mask{false, Snapshot.Num()};
+
+	for (const FName Tag : Tags)
+	{
+		if (const int32* const TagId = TagIds.Find(Tag))
+		{
+			Mask.CombineWithBitwiseOR(NodesByTag[*TagId], EBitwiseOperatorFlags::MaintainSize);
+		}
+	}
+
+	return Mask;
+}
+
+TBitArray<> FComponentQueryIndex::MakeClassMask(const UClass& Class) const
+{
+	TBitArray<> Mask{false, Snapshot.Num()};
+
+	for (int32 ClassId = 0; ClassId < Classes.Num(); ++ClassId)
+	{
+		if (Classes[ClassId]->IsChildOf(&Class))
+		{
+			Mask.CombineWithBitwiseOR(NodesByClass[ClassId], EBitwiseOperatorFlags::MaintainSize);
+		}
+	}
+
+	return Mask;
+}
+
+TBitArray<> FComponentQueryIndex::MakeSubtreeTagMask(const int32 RootIdx, const TArrayView<const FName> Tags) const
+{
+	TBitArray<> SubtreeMask{false, Snapshot.GetSubtreeEnd(RootIdx) - RootIdx};
+
+	for (const FName Tag : Tags)
+	{
+		if (const int32* const TagId = TagIds.Find(Tag))
+		{
+			CombineSubtreeWithBitwiseOR(RootIdx, NodesByTag[*TagId], SubtreeMask);
+		}
+	}
+
+	return SubtreeMask;
+}
+
+TBitArray<> FComponentQueryIndex::MakeSubtreeClassMask(const int32 RootIdx, const UClass& Class) const
+{
+	TBitArray<> SubtreeMask{false, Snapshot.GetSubtreeEnd(RootIdx) - RootIdx};
+
+	for (int32 ClassId = 0; ClassId < Classes.Num(); ++ClassId)
+	{
+		if (Classes[ClassId]->IsChildOf(&Class))
+		{
+			CombineSubtreeWithBitwiseOR(RootIdx, NodesByClass[ClassId], SubtreeMask);
+		}
+	}
+
+	return SubtreeMask;
+}
+
+void FComponentQueryIndex::CombineSubtreeWithBitwiseOR(
+	const int32 RootIdx, const TBitArray<>& Nodes, TBitArray<>& SubtreeMask) const
+{
+	const int32 EndIdx = RootIdx + SubtreeMask.Num();
+	for (TConstSetBitIterator<> It{Nodes, RootIdx}; It && It.GetIndex() < EndIdx; ++It)
+	{
+		SubtreeMask[It.GetIndex() - RootIdx] = true;
+	}
+}
+
+bool FComponentQueryIndex::HasAnyTag(const int32 NodeIdx, const TArrayView<const FName> Tags) const
+{
+	for (const FName Tag : Tags)
+	{
+		const int32* const TagId = TagIds.Find(Tag);
+		ZKZ_RETURN_IF(TagId != nullptr && NodesByTag[*TagId][NodeIdx], true);
+	}
+
+	return false;
+}
+
+}  // namespace Zkz
@@ -0,0 +1,306 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ComponentSubtreePool.h"
+
+#include "Algo/AllOf.h"
+#include "Algo/Count.h"
+#include "Components/PrimitiveComponent.h"
+#include "Zakazane/Component.h"
+#include "Zakazane/ComponentHierarchySnapshot.h"
+#include "Zakazane/ContinueIfMacros.h"
+#include "Zakazane/ReturnIfMacros.h"
+
+namespace Zkz
+{
+
+FComponentSubtreePool::FComponentSubtreePool(TArray<FName> InPropertiesToReset, const int32 InMaxPooledPerTemplate)
+	: PropertiesToReset{MoveTemp(InPropertiesToReset)}, MaxPooledPerTemplate{InMaxPooledPerTemplate}
+{
+}
+
+USceneComponent* FComponentSubtreePool::Acquire(
+	const USceneComponent& TemplateRoot, AActor& Owner, USceneComponent& AttachParent, const FName SocketName)
+{
+	FTemplateSubtree* const TemplateSubtreePtr = FindOrAddTemplateSubtree(TemplateRoot);
+	ZKZ_RETURN_IF(TemplateSubtreePtr == nullptr, nullptr);
+	FTemplateSubtree& TemplateSubtree = *TemplateSubtreePtr;
+
+	RemoveDeadInstances(TemplateSubtree);
+	RemoveDeadAcquiredInstances();
+
+	TOptional<FInstance> Instance;
+
+	// Most recently released first, it's the most likely to still be in cache
+	for (int32 InstanceIdx = TemplateSubtree.FreeInstances.Num() - 1; InstanceIdx >= 0; --InstanceIdx)
+	{
+		ZKZ_CONTINUE_IF(TemplateSubtree.FreeInstances[InstanceIdx].Owner != &Owner);
+
+		FInstance FreeInstance = MoveTemp(TemplateSubtree.FreeInstances[InstanceIdx]);
+		TemplateSubtree.FreeInstances.RemoveAtSwap(InstanceIdx, EAllowShrinking::No);
+
+		// Templates may have been destroyed in the meantime
+		if (ResetInstance(TemplateSubtree, FreeInstance))
+		{
+			Instance = MoveTemp(FreeInstance);
+			break;
+		}
+
+		DestroyInstance(FreeInstance);
+	}
+
+	if (!Instance.IsSet())
+	{
+		Instance = CloneSubtree(TemplateSubtree, Owner);
+		ZKZ_RETURN_IF(!Instance.IsSet(), nullptr);
+	}
+
+	USceneComponent* const InstanceRoot = Instance->Components[0].Get();
+	InstanceRoot->AttachToComponent(&AttachParent, FAttachmentTransformRules::KeepRelativeTransform, SocketName);
+
+	AcquiredInstances.Emplace(InstanceRoot, FAcquiredInstance{&TemplateRoot, MoveTemp(*Instance)});
+
+	return InstanceRoot;
+}
+
+void FComponentSubtreePool::Release(USceneComponent& InstanceRoot)
+{
+	FAcquiredInstance AcquiredInstance;
+	ZKZ_RETURN_IF_ENSUREALWAYSMSGF(
+		!AcquiredInstances.RemoveAndCopyValue(&InstanceRoot, AcquiredInstance),
+		"Releasing a subtree which wasn't acquired from this pool");
+
+	RemoveDeadAcquiredInstances();
+
+	FTemplateSubtree* const TemplateSubtree = TemplateSubtrees.Find(AcquiredInstance.TemplateRoot);
+	if (TemplateSubtree != nullptr)
+	{
+		RemoveDeadInstances(*TemplateSubtree);
+	}
+
+	const AActor* const Owner = AcquiredInstance.Instance.Owner.Get();
+	if (TemplateSubtree == nullptr || !IsValid(Owner)
+		|| CountFreeInstances(*TemplateSubtree, *Owner) >= MaxPooledPerTemplate)
+	{
+		DestroyInstance(AcquiredInstance.Instance);
+		return;
+	}
+
+	InstanceRoot.DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+	DisableInstance(AcquiredInstance.Instance);
+
+	TemplateSubtree->FreeInstances.Emplace(MoveTemp(AcquiredInstance.Instance));
+}
+
+int32 FComponentSubtreePool::GetNumPooled(const USceneComponent& TemplateRoot) const
+{
+	const FTemplateSubtree* const TemplateSubtree = TemplateSubtrees.Find(&TemplateRoot);
+	return TemplateSubtree == nullptr ? 0 : TemplateSubtree->FreeInstances.Num();
+}
+
+void FComponentSubtreePool::Reset()
+{
+	for (const TPair<TObjectKey<USceneComponent>, FTemplateSubtree>& TemplateSubtree : TemplateSubtrees)
+	{
+		for (const FInstance& Instance : TemplateSubtree.Value.FreeInstances)
+		{
+			DestroyInstance(Instance);
+		}
+	}
+
+	TemplateSubtrees.Reset();
+	AcquiredInstances.Reset();
+}
+
+FComponentSubtreePool::FTemplateSubtree* FComponentSubtreePool::FindOrAddTemplateSubtree(
+	const USceneComponent& TemplateRoot)
+{
+	if (FTemplateSubtree* const TemplateSubtree = TemplateSubtrees.Find(&TemplateRoot))
+	{
+		return TemplateSubtree;
+	}
+
+	// Gathered separately, so a failure doesn't leave a partial entry behind
+	FTemplateSubtree TemplateSubtree;
+
+	const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{TemplateRoot}};
+	const int32 RootIdx = Snapshot.FindIndex(TemplateRoot);
+	ZKZ_RETURN_IF_ENSUREALWAYS(RootIdx == INDEX_NONE, nullptr);
+
+	for (int32 NodeIdx = RootIdx; NodeIdx < Snapshot.GetSubtreeEnd(RootIdx); ++NodeIdx)
+	{
+		const USceneComponent* const Template = Cast<USceneComponent>(&Snapshot.GetComponent(NodeIdx));
+		ZKZ_RETURN_IF_ENSUREALWAYS(Template == nullptr, nullptr);
+
+		TemplateSubtree.Components.Emplace(Template);
+		TemplateSubtree.ParentIndices.Emplace(
+			NodeIdx == RootIdx ? INDEX_NONE : Snapshot.GetParentIndex(NodeIdx) - RootIdx);
+
+		TArray<FProperty*>& ComponentProperties = TemplateSubtree.PropertiesToResetByComponent.AddDefaulted_GetRef();
+		for (const FName PropertyName : PropertiesToReset)
+		{
+			if (FProperty* const Property = FindFProperty<FProperty>(Template->GetClass(), PropertyName))
+			{
+				ComponentProperties.Emplace(Property);
+			}
+		}
+	}
+
+	return &TemplateSubtrees.Emplace(&TemplateRoot, MoveTemp(TemplateSubtree));
+}
+
+void FComponentSubtreePool::RemoveDeadInstances(FTemplateSubtree& TemplateSubtree)
+{
+	// Keeps the order, Acquire prefers the most recently released instances
+	TemplateSubtree.FreeInstances.RemoveAll(
+		[](const FInstance& Instance)
+		{
+			const auto IsComponentValid = [](const TWeakObjectPtr<USceneComponent>& Component)
+			{ return IsValid(Component.Get()); };
+			ZKZ_RETURN_IF(IsValid(Instance.Owner.Get()) && Algo::AllOf(Instance.Components, IsComponentValid), false);
+
+			// Whatever is left of the subtree would never be reused
+			DestroyInstance(Instance);
+			return true;
+		});
+}
+
+void FComponentSubtreePool::RemoveDeadAcquiredInstances()
+{
+	// Nothing to destroy, the components went away with their owner
+	for (auto It = AcquiredInstances.CreateIterator(); It; ++It)
+	{
+		if (!IsValid(It->Value.Instance.Owner.Get()) || !IsValid(It->Key.ResolveObjectPtr()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+int32 FComponentSubtreePool::CountFreeInstances(const FTemplateSubtree& TemplateSubtree, const AActor& Owner)
+{
+	return Algo::CountIf(
+		TemplateSubtree.FreeInstances, [&Owner](const FInstance& Instance) { return Instance.Owner == &Owner; });
+}
+
+TOptional<FComponentSubtreePool::FInstance> FComponentSubtreePool::CloneSubtree(
+	const FTemplateSubtree& TemplateSubtree, AActor& Owner)
+{
+	ZKZ_RETURN_IF(TemplateSubtree.Components.IsEmpty(), NullOpt);
+
+	FInstance Instance;
+	Instance.Owner = &Owner;
+
+	for (int32 NodeIdx = 0; NodeIdx < TemplateSubtree.Components.Num(); ++NodeIdx)
+	{
+		const USceneComponent* const Template = TemplateSubtree.Components[NodeIdx].Get();
+		if (!IsValid(Template))
+		{
+			DestroyInstance(Instance);
+			return NullOpt;
+		}
+
+		// Transient properties come from the class defaults, otherwise an instanced template's AttachChildren would be
+		// copied and the clone would list the template's live children as its own. The attach parent is set below.
+		constexpr bool bCopyTransientsFromClassDefaults = true;
+
+		// The template is only read from, NewObject just doesn't take a const one
+		USceneComponent* const Component = NewObject<USceneComponent>(
+			&Owner,
+			Template->GetClass(),
+			NAME_None,
+			RF_Transient,
+			const_cast<USceneComponent*>(Template),
+			bCopyTransientsFromClassDefaults);
+		ensureAlways(Component->GetAttachChildren().IsEmpty());
+
+		const int32 ParentIdx = TemplateSubtree.ParentIndices[NodeIdx];
+		if (ParentIdx != INDEX_NONE)
+		{
+			Component->SetupAttachment(Instance.Components[ParentIdx].Get(), Template->GetAttachSocketName());
+		}
+		else
+		{
+			// The template root's parent isn't part of the subtree, the instance root is attached by Acquire
+			Component->SetupAttachment(nullptr);
+		}
+
+		Instance.Components.Emplace(Component);
+	}
+
+	// Parents first, so children are registered attached to registered parents
+	for (const TWeakObjectPtr<USceneComponent>& Component : Instance.Components)
+	{
+		Component->RegisterComponent();
+	}
+
+	return Instance;
+}
+
+bool FComponentSubtreePool::ResetInstance(const FTemplateSubtree& TemplateSubtree, const FInstance& Instance)
+{
+	ZKZ_RETURN_IF(Instance.Components.Num() != TemplateSubtree.Components.Num(), false);
+
+	for (int32 NodeIdx = 0; NodeIdx < Instance.Components.Num(); ++NodeIdx)
+	{
+		const USceneComponent* const Template = TemplateSubtree.Components[NodeIdx].Get();
+		USceneComponent* const Component = Instance.Components[NodeIdx].Get();
+		ZKZ_RETURN_IF(!IsValid(Template) || !IsValid(Component), false);
+
+		const TArray<FProperty*>& ComponentProperties = TemplateSubtree.PropertiesToResetByComponent[NodeIdx];
+		for (const FProperty* const Property : ComponentProperties)
+		{
+			Property->CopyCompleteValue_InContainer(Component, Template);
+		}
+
+		if (!ComponentProperties.IsEmpty())
+		{
+			Component->MarkRenderStateDirty();
+		}
+
+		Component->SetRelativeTransform(Template->GetRelativeTransform());
+		Component->SetVisibility(Template->GetVisibleFlag());
+
+		if (UPrimitiveComponent* const PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+		{
+			PrimitiveComponent->SetCollisionEnabled(CastChecked<UPrimitiveComponent>(Template)->GetCollisionEnabled());
+		}
+
+		if (Template->bAutoActivate)
+		{
+			Component->Activate(true);
+		}
+	}
+
+	return true;
+}
+
+void FComponentSubtreePool::DisableInstance(const FInstance& Instance)
+{
+	for (const TWeakObjectPtr<USceneComponent>& WeakComponent : Instance.Components)
+	{
+		USceneComponent* const Component = WeakComponent.Get();
+		ZKZ_CONTINUE_IF_INVALID(Component);
+
+		Component->SetVisibility(false);
+		Component->Deactivate();
+
+		if (UPrimitiveComponent* const PrimitiveComponent = Cast<UPrimitiveComponent>(Component))
+		{
+			PrimitiveComponent->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		}
+	}
+}
+
+void FComponentSubtreePool::DestroyInstance(const FInstance& Instance)
+{
+	// Children first, so no component is promoted in place of its destroyed parent
+	for (int32 NodeIdx = Instance.Components.Num() - 1; NodeIdx >= 0; --NodeIdx)
+	{
+		USceneComponent* const Component = Instance.Components[NodeIdx].Get();
+		ZKZ_CONTINUE_IF_INVALID(Component);
+
+		Component->DestroyComponent();
+	}
+}
+
+}  // namespace Zkz
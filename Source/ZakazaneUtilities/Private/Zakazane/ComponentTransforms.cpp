@@ -0,0 +1,147 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ComponentTransforms.h"
+
+#include "Components/SceneComponent.h"
+
+namespace Zkz
+{
+
+namespace ComponentTransformsPrivate
+{
+
+void ReadWorldTransform(const USceneComponent& SceneComp, FComponentTransforms& Transforms, const int32 EntryIdx)
+{
+	const FTransform& ComponentToWorld = SceneComp.GetComponentTransform();
+	Transforms.WorldLocations[EntryIdx] = ComponentToWorld.GetLocation();
+	Transforms.WorldRotations[EntryIdx] = ComponentToWorld.GetRotation();
+	Transforms.WorldScales[EntryIdx] = ComponentToWorld.GetScale3D();
+}
+
+}  // namespace ComponentTransformsPrivate
+
+void FComponentTransforms::SetRelativeTransform(const int32 EntryIdx, const FTransform& Transform)
+{
+	RelativeLocations[EntryIdx] = Transform.GetLocation();
+	RelativeRotations[EntryIdx] = Transform.GetRotation();
+	RelativeScales[EntryIdx] = Transform.GetScale3D();
+	DirtyEntries[EntryIdx] = true;
+}
+
+void FComponentTransforms::Reset()
+{
+	NodeIndices.Reset();
+	ParentEntries.Reset();
+	RelativeLocations.Reset();
+	RelativeRotations.Reset();
+	RelativeScales.Reset();
+	WorldLocations.Reset();
+	WorldRotations.Reset();
+	WorldScales.Reset();
+	DirtyEntries.Reset();
+}
+
+void GatherTransforms(
+	const FComponentHierarchySnapshot& Snapshot, const int32 RootIdx, FComponentTransforms& OutTransforms)
+{
+	OutTransforms.Reset();
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Snapshot.IsValidIndex(RootIdx));
+
+	const int32 EndIdx = Snapshot.GetSubtreeEnd(RootIdx);
+	const int32 NumNodes = EndIdx - RootIdx;
+
+	OutTransforms.NodeIndices.Reserve(NumNodes);
+	OutTransforms.ParentEntries.Reserve(NumNodes);
+	OutTransforms.RelativeLocations.Reserve(NumNodes);
+	OutTransforms.RelativeRotations.Reserve(NumNodes);
+	OutTransforms.RelativeScales.Reserve(NumNodes);
+	OutTransforms.WorldLocations.Reserve(NumNodes);
+	OutTransforms.WorldRotations.Reserve(NumNodes);
+	OutTransforms.WorldScales.Reserve(NumNodes);
+
+	// Entry of each node in the subtree, offset by RootIdx. Parents precede their children in preorder, so the entry of
+	// the parent is always known by the time a child is added.
+	TArray<int32> EntriesByNode;
+	EntriesByNode.Init(INDEX_NONE, NumNodes);
+
+	for (int32 NodeIdx = RootIdx; NodeIdx < EndIdx; ++NodeIdx)
+	{
+		const USceneComponent* const SceneComp = Cast<USceneComponent>(&Snapshot.GetComponent(NodeIdx));
+		ZKZ_CONTINUE_IF(SceneComp == nullptr);
+
+		const int32 ParentIdx = Snapshot.GetParentIndex(NodeIdx);
+		const int32 EntryIdx = OutTransforms.NodeIndices.Emplace(NodeIdx);
+		EntriesByNode[NodeIdx - RootIdx] = EntryIdx;
+
+		// The parent of the root is outside of the subtree
+		OutTransforms.ParentEntries.Emplace(ParentIdx >= RootIdx ? EntriesByNode[ParentIdx - RootIdx] : INDEX_NONE);
+
+		OutTransforms.RelativeLocations.Emplace(SceneComp->GetRelativeLocation());
+		OutTransforms.RelativeRotations.Emplace(
+			SceneComp->GetRelativeRotationCache().RotatorToQuat(SceneComp->GetRelativeRotation()));
+		OutTransforms.RelativeScales.Emplace(SceneComp->GetRelativeScale3D());
+
+		const FTransform& ComponentToWorld = SceneComp->GetComponentTransform();
+		OutTransforms.WorldLocations.Emplace(ComponentToWorld.GetLocation());
+		OutTransforms.WorldRotations.Emplace(ComponentToWorld.GetRotation());
+		OutTransforms.WorldScales.Emplace(ComponentToWorld.GetScale3D());
+	}
+
+	OutTransforms.DirtyEntries.Init(false, OutTransforms.Num());
+}
+
+void ScatterTransforms(
+	const FComponentHierarchySnapshot& Snapshot, FComponentTransforms& Transforms, const ETeleportType Teleport)
+{
+	using namespace ComponentTransformsPrivate;
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Snapshot.ComponentsMutable());
+	ZKZ_RETURN_IF_ENSUREALWAYS(Transforms.DirtyEntries.Num() != Transforms.Num());
+
+	// Topmost dirty entries. Updating the world transform of a component updates its whole subtree, so the dirty
+	// entries below them only need their relative transforms set.
+	TArray<int32> UpdateRootEntries;
+	int32 UpdatedSubtreeEnd = INDEX_NONE;
+
+	for (TConstSetBitIterator<> It{Transforms.DirtyEntries}; It; ++It)
+	{
+		const int32 EntryIdx = It.GetIndex();
+		const int32 NodeIdx = Transforms.NodeIndices[EntryIdx];
+		ZKZ_CONTINUE_IF_ENSUREALWAYS(!Snapshot.IsValidIndex(NodeIdx));
+
+		USceneComponent* const SceneComp = Cast<USceneComponent>(&Snapshot.GetMutableComponent(NodeIdx));
+		ZKZ_CONTINUE_IF_ENSUREALWAYS(SceneComp == nullptr);
+
+		SceneComp->SetRelativeLocation_Direct(Transforms.RelativeLocations[EntryIdx]);
+		SceneComp->SetRelativeRotation_Direct(
+			SceneComp->GetRelativeRotationCache().QuatToRotator(Transforms.RelativeRotations[EntryIdx]));
+		SceneComp->SetRelativeScale3D_Direct(Transforms.RelativeScales[EntryIdx]);
+
+		if (NodeIdx >= UpdatedSubtreeEnd)
+		{
+			UpdateRootEntries.Emplace(EntryIdx);
+			UpdatedSubtreeEnd = Snapshot.GetSubtreeEnd(NodeIdx);
+		}
+	}
+
+	for (const int32 RootEntryIdx : UpdateRootEntries)
+	{
+		const int32 RootNodeIdx = Transforms.NodeIndices[RootEntryIdx];
+		const int32 EndNodeIdx = Snapshot.GetSubtreeEnd(RootNodeIdx);
+
+		USceneComponent& RootComp = *CastChecked<USceneComponent>(&Snapshot.GetMutableComponent(RootNodeIdx));
+		RootComp.UpdateComponentToWorld(EUpdateTransformFlags::None, Teleport);
+
+		for (int32 EntryIdx = RootEntryIdx;
+			 EntryIdx < Transforms.Num() && Transforms.NodeIndices[EntryIdx] < EndNodeIdx;
+			 ++EntryIdx)
+		{
+			const UActorComponent& Component = Snapshot.GetComponent(Transforms.NodeIndices[EntryIdx]);
+			ReadWorldTransform(*CastChecked<USceneComponent>(&Component), Transforms, EntryIdx);
+		}
+	}
+
+	Transforms.DirtyEntries.Init(false, Transforms.Num());
+}
+
+}  // namespace Zkz
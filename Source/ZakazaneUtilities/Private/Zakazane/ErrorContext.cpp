@@ -0,0 +1,40 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/ErrorContext.h"
+
+#include "Misc/Paths.h"
+
+namespace Zkz
+{
+
+FErrorContext FErrorContext::WithContext(FErrorContext&& Outer) &&
+{
+	Frames.Append(MoveTemp(Outer.Frames));
+	return MoveTemp(*this);
+}
+
+FString FErrorContext::ToString() const
+{
+	TStringBuilder<256> Result;
+
+	for (int32 FrameIdx = Frames.Num() - 1; FrameIdx >= 0; --FrameIdx)
+	{
+		const FFrame& Frame = Frames[FrameIdx];
+
+		if (FrameIdx != Frames.Num() - 1)
+		{
+			Result.Append(TEXT("\n\tcaused by: "));
+		}
+
+		Result.Append(Frame.Formatter.IsValid() ? Frame.Formatter->Format() : FString{TEXT("Unknown error")});
+
+		if (Frame.File != nullptr)
+		{
+			Result.Appendf(TEXT(" (%s:%d)"), *FPaths::GetCleanFilename(ANSI_TO_TCHAR(Frame.File)), Frame.Line);
+		}
+	}
+
+	return Result.ToString();
+}
+
+}  // namespace Zkz
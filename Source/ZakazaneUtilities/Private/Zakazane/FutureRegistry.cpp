@@ -0,0 +1,206 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/FutureRegistry.h"
+
+#if ZKZ_WITH_FUTURE_REGISTRY
+
+#include "Algo/Sort.h"
+#include "HAL/IConsoleManager.h"
+#include "Zakazane/ReturnIfMacros.h"
+
+namespace Zkz::FutureRegistry
+{
+
+namespace Private
+{
+
+struct FEntry
+{
+	FCreationSite Site;
+	double StartSeconds = 0.0;
+};
+
+struct FRegistry
+{
+	FCriticalSection Mutex;
+	TMap<uint64, FEntry> Pending;
+	uint64 NextId = 1;
+	FLifetimeHistogram LifetimeHistogram{InPlace, 0};
+};
+
+FRegistry& GetRegistry()
+{
+	// Intentionally leaked, promises may be destroyed after static destruction has started
+	static FRegistry* const Registry = new FRegistry;
+	return *Registry;
+}
+
+int32 GetLifetimeBucket(const double LifetimeSeconds)
+{
+	const double LifetimeMs = LifetimeSeconds * 1000.0;
+	ZKZ_RETURN_IF(LifetimeMs < 1.0, 0);
+
+	return FMath::Min(FMath::FloorToInt32(FMath::Log2(LifetimeMs)) + 1, NumLifetimeBuckets - 1);
+}
+
+void DumpPendingCommand(const TArray<FString>& Args, FOutputDevice& Output)
+{
+	int32 MaxEntries = 20;
+	if (!Args.IsEmpty())
+	{
+		LexFromString(MaxEntries, *Args[0]);
+	}
+
+	DumpPending(Output, MaxEntries);
+}
+
+void DumpLifetimesCommand(const TArray<FString>& Args, FOutputDevice& Output)
+{
+	DumpLifetimes(Output);
+}
+
+FAutoConsoleCommand DumpPendingConsoleCommand(
+	TEXT("Zkz.Futures.DumpPending"),
+	TEXT("Lists the oldest pending promises. Usage: Zkz.Futures.DumpPending [MaxEntries]"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&DumpPendingCommand));
+
+FAutoConsoleCommand DumpLifetimesConsoleCommand(
+	TEXT("Zkz.Futures.DumpLifetimes"),
+	TEXT("Prints a histogram of the time it took to fulfil or cancel promises"),
+	FConsoleCommandWithArgsAndOutputDeviceDelegate::CreateStatic(&DumpLifetimesCommand));
+
+}  // namespace Private
+
+FRegistration::FRegistration(const FCreationSite& Site)
+{
+	Private::FRegistry& Registry = Private::GetRegistry();
+	FScopeLock Lock{&Registry.Mutex};
+
+	Id = Registry.NextId++;
+	Registry.Pending.Add(Id, {Site, FPlatformTime::Seconds()});
+}
+
+FRegistration::FRegistration(FRegistration&& Other) : Id{Other.Id}
+{
+	Other.Id = 0;
+}
+
+FRegistration& FRegistration::operator=(FRegistration&& Other)
+{
+	ZKZ_RETURN_IF(this == &Other, *this);
+
+	Complete();
+	Id = Other.Id;
+	Other.Id = 0;
+	return *this;
+}
+
+FRegistration::~FRegistration()
+{
+	Complete();
+}
+
+void FRegistration::Complete()
+{
+	ZKZ_RETURN_IF(Id == 0);
+
+	Private::FRegistry& Registry = Private::GetRegistry();
+	FScopeLock Lock{&Registry.Mutex};
+
+	Private::FEntry Entry;
+	if (Registry.Pending.RemoveAndCopyValue(Id, Entry))
+	{
+		++Registry.LifetimeHistogram[Private::GetLifetimeBucket(FPlatformTime::Seconds() - Entry.StartSeconds)];
+	}
+
+	Id = 0;
+}
+
+int32 GetNumPending()
+{
+	Private::FRegistry& Registry = Private::GetRegistry();
+	FScopeLock Lock{&Registry.Mutex};
+	return Registry.Pending.Num();
+}
+
+TArray<FPendingEntry> GetOldestPending(const int32 MaxEntries)
+{
+	TArray<Private::FEntry> Entries;
+
+	{
+		Private::FRegistry& Registry = Private::GetRegistry();
+		FScopeLock Lock{&Registry.Mutex};
+		Registry.Pending.GenerateValueArray(Entries);
+	}
+
+	Algo::SortBy(Entries, &Private::FEntry::StartSeconds);
+
+	const double NowSeconds = FPlatformTime::Seconds();
+
+	TArray<FPendingEntry> Result;
+	Result.Reserve(FMath::Min(MaxEntries, Entries.Num()));
+
+	for (int32 Idx = 0; Idx < Entries.Num() && Idx < MaxEntries; ++Idx)
+	{
+		Result.Add({Entries[Idx].Site, NowSeconds - Entries[Idx].StartSeconds});
+	}
+
+	return Result;
+}
+
+FLifetimeHistogram GetLifetimeHistogram()
+{
+	Private::FRegistry& Registry = Private::GetRegistry();
+	FScopeLock Lock{&Registry.Mutex};
+	return Registry.LifetimeHistogram;
+}
+
+void DumpPending(FOutputDevice& Output, const int32 MaxEntries)
+{
+	const TArray<FPendingEntry> OldestPending = GetOldestPending(MaxEntries);
+
+	Output.Logf(TEXT("%d pending promise(s), oldest %d:"), GetNumPending(), OldestPending.Num());
+
+	for (const FPendingEntry& Entry : OldestPending)
+	{
+		if (Entry.Site.File == nullptr)
+		{
+			Output.Logf(TEXT("  %.3fs - unknown site"), Entry.AgeSeconds);
+		}
+		else
+		{
+			Output.Logf(
+				TEXT("  %.3fs - %hs (%hs:%d)"),
+				Entry.AgeSeconds,
+				Entry.Site.Function,
+				Entry.Site.File,
+				Entry.Site.Line);
+		}
+	}
+}
+
+void DumpLifetimes(FOutputDevice& Output)
+{
+	const FLifetimeHistogram Histogram = GetLifetimeHistogram();
+
+	Output.Logf(TEXT("Promise lifetimes:"));
+	Output.Logf(TEXT("  < 1 ms: %lld"), Histogram[0]);
+
+	for (int32 Bucket = 1; Bucket < NumLifetimeBuckets; ++Bucket)
+	{
+		const int64 MinMs = int64{1} << (Bucket - 1);
+
+		if (Bucket == NumLifetimeBuckets - 1)
+		{
+			Output.Logf(TEXT("  >= %lld ms: %lld"), MinMs, Histogram[Bucket]);
+		}
+		else
+		{
+			Output.Logf(TEXT("  %lld - %lld ms: %lld"), MinMs, MinMs * 2, Histogram[Bucket]);
+		}
+	}
+}
+
+}  // namespace Zkz::FutureRegistry
+
+#endif
@@ -0,0 +1,14 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/Parallel.h"
+
+namespace Zkz::ParallelPrivate
+{
+
+int32 GetNumChunks(const int32 NumElements)
+{
+	const int32 NumWorkers = FTaskGraphInterface::IsRunning() ? FTaskGraphInterface::Get().GetNumWorkerThreads() : 1;
+	return FMath::Clamp(NumWorkers, 1, FMath::Max(NumElements, 1));
+}
+
+}  // namespace Zkz::ParallelPrivate
@@ -1,12 +1,22 @@
 ﻿#include "Zakazane/Serialization.h"
 
+#include "Algo/AnyOf.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
 #include "Misc/ScopeExit.h"
+#include "Misc/ScopeRWLock.h"
 #include "Misc/SlowTask.h"
 #include "Serialization/Csv/CsvParser.h"
+#include "UObject/EnumProperty.h"
 #include "UObject/Field.h"
 #include "UObject/TextProperty.h"
+#include "UObject/UnrealType.h"
 #include "Zakazane/ContinueIfMacros.h"
 #include "Zakazane/OutputDeviceStatsWrapper.h"
+#include "Zakazane/Parallel.h"
 #include "Zakazane/ReturnIfMacros.h"
 
 #define LOCTEXT_NAMESPACE "ZakazaneUtilitiesSerialization"
@@ -14,24 +24,1684 @@
 namespace Zkz::Serialization
 {
 
-FString GetSerializedString(const FProperty& Property, const void* Object)
+namespace SerializationPrivate
 {
-	if (const FTextProperty* const TextProperty = ExactCastField<const FTextProperty>(&Property))
+
+/// How FCSVPropertyCodec converts a property
+enum class ECSVPropertyCodecType : uint8
+{
+	SignedInteger,
+	UnsignedInteger,
+	Float,
+	Double,
+	Bool,
+	Name,
+	String,
+	Text,
+	Enum,
+	/// Converted with the property's ImportText and ExportText
+	Generic,
+};
+
+/// Parses a decimal integer, optionally preceded by a minus sign, which makes up the whole cell. Fails on overflow.
+bool TryParseCSVInteger(const TCHAR* Cell, bool& bOutNegative, uint64& OutMagnitude)
+{
+	bOutNegative = *Cell == TEXT('-');
+	if (bOutNegative)
+	{
+		++Cell;
+	}
+
+	ZKZ_RETURN_IF(*Cell == TEXT('\0'), false);
+
+	uint64 Magnitude = 0;
+	for (; *Cell != TEXT('\0'); ++Cell)
+	{
+		ZKZ_RETURN_IF(!FChar::IsDigit(*Cell), false);
+
+		const uint64 Digit = *Cell - TEXT('0');
+		ZKZ_RETURN_IF(Magnitude > (MAX_uint64 - Digit) / 10, false);
+
+		Magnitude = Magnitude * 10 + Digit;
+	}
+
+	OutMagnitude = Magnitude;
+	return true;
+}
+
+/// Whether the whole cell is a plain decimal floating point number, with an optional exponent
+bool IsCSVFloatingPointLiteral(const TCHAR* Cell)
+{
+	if (*Cell == TEXT('-'))
+	{
+		++Cell;
+	}
+
+	int32 NumDigits = 0;
+	for (; FChar::IsDigit(*Cell); ++Cell)
+	{
+		++NumDigits;
+	}
+
+	if (*Cell == TEXT('.'))
+	{
+		for (++Cell; FChar::IsDigit(*Cell); ++Cell)
+		{
+			++NumDigits;
+		}
+	}
+
+	ZKZ_RETURN_IF(NumDigits == 0, false);
+
+	if (*Cell == TEXT('e') || *Cell == TEXT('E'))
+	{
+		++Cell;
+		if (*Cell == TEXT('-') || *Cell == TEXT('+'))
+		{
+			++Cell;
+		}
+
+		ZKZ_RETURN_IF(!FChar::IsDigit(*Cell), false);
+		while (FChar::IsDigit(*Cell))
+		{
+			++Cell;
+		}
+	}
+
+	return *Cell == TEXT('\0');
+}
+
+int32 GetIntegerNumBits(const FNumericProperty& Property)
+{
+	ZKZ_RETURN_IF(Property.IsA<FInt64Property>() || Property.IsA<FUInt64Property>(), 64);
+	ZKZ_RETURN_IF(Property.IsA<FIntProperty>() || Property.IsA<FUInt32Property>(), 32);
+	ZKZ_RETURN_IF(Property.IsA<FInt16Property>() || Property.IsA<FUInt16Property>(), 16);
+	return 8;
+}
+
+bool IsUnsignedInteger(const FNumericProperty& Property)
+{
+	return Property.IsA<FByteProperty>() || Property.IsA<FUInt16Property>() || Property.IsA<FUInt32Property>()
+		|| Property.IsA<FUInt64Property>();
+}
+
+/// Converts a property to and from CSV cells. Common property types are converted directly, the rest through the
+/// generic text import and export of the property.
+/// The fast paths only accept cells the generic import reads the same way and leave anything else (such as values
+/// out of range or unknown enum names) to it, so both the imported values and the warnings don't depend on the path.
+class FCSVPropertyCodec
+{
+public:
+	explicit FCSVPropertyCodec(const FProperty& InProperty);
+
+	const FProperty& GetProperty() const
+	{
+		return *Property;
+	}
+
+	/// Imports the cell into Value, which points to the property of an object. Returns false if the cell needs the
+	/// generic import.
+	bool TryImport(const TCHAR* Cell, void* Value) const;
+
+	/// Imports the cell into Value, through the generic import if the fast path can't handle it. Returns false and the
+	/// reason in OutError if the cell couldn't be imported.
+	bool Import(const TCHAR* Cell, void* Value, FString& OutError) const;
+
+	/// Appends the exported value to OutCell. Value points to the property of an object.
+	void Export(const void* Value, FString& OutCell) const;
+
+private:
+	const FProperty* Property;
+	ECSVPropertyCodecType Type = ECSVPropertyCodecType::Generic;
+
+	/// Property of numeric types and the underlying property of enums
+	const FNumericProperty* NumericProperty = nullptr;
+	const UEnum* Enum = nullptr;
+	int32 NumBits = 0;
+};
+
+FCSVPropertyCodec::FCSVPropertyCodec(const FProperty& InProperty) : Property{&InProperty}
+{
+	if (const FEnumProperty* const EnumProperty = CastField<const FEnumProperty>(&InProperty))
+	{
+		NumericProperty = EnumProperty->GetUnderlyingProperty();
+		Enum = EnumProperty->GetEnum();
+		Type = NumericProperty != nullptr && Enum != nullptr ? ECSVPropertyCodecType::Enum
+															 : ECSVPropertyCodecType::Generic;
+	}
+	else if (const FNumericProperty* const InNumericProperty = CastField<const FNumericProperty>(&InProperty))
+	{
+		NumericProperty = InNumericProperty;
+
+		if (const UEnum* const IntEnum = InNumericProperty->GetIntPropertyEnum())
+		{
+			Enum = IntEnum;
+			Type = ECSVPropertyCodecType::Enum;
+		}
+		else if (InNumericProperty->IsFloatingPoint())
+		{
+			Type = InProperty.IsA<FFloatProperty>() ? ECSVPropertyCodecType::Float : ECSVPropertyCodecType::Double;
+		}
+		else if (InNumericProperty->IsInteger())
+		{
+			Type = IsUnsignedInteger(*InNumericProperty) ? ECSVPropertyCodecType::UnsignedInteger
+														 : ECSVPropertyCodecType::SignedInteger;
+			NumBits = GetIntegerNumBits(*InNumericProperty);
+		}
+	}
+	else if (InProperty.IsA<FBoolProperty>())
+	{
+		Type = ECSVPropertyCodecType::Bool;
+	}
+	else if (InProperty.IsA<FNameProperty>())
+	{
+		Type = ECSVPropertyCodecType::Name;
+	}
+	else if (InProperty.IsA<FStrProperty>())
+	{
+		Type = ECSVPropertyCodecType::String;
+	}
+	else if (ExactCastField<const FTextProperty>(&InProperty) != nullptr)
+	{
+		Type = ECSVPropertyCodecType::Text;
+	}
+}
+
+bool FCSVPropertyCodec::TryImport(const TCHAR* const Cell, void* const Value) const
+{
+	switch (Type)
+	{
+		case ECSVPropertyCodecType::SignedInteger:
+		{
+			bool bNegative = false;
+			uint64 Magnitude = 0;
+			ZKZ_RETURN_IF(!TryParseCSVInteger(Cell, bNegative, Magnitude), false);
+
+			const uint64 MaxMagnitude = (uint64{1} << (NumBits - 1)) - (bNegative ? 0 : 1);
+			ZKZ_RETURN_IF(Magnitude > MaxMagnitude, false);
+
+			NumericProperty->SetIntPropertyValue(
+				Value, bNegative ? static_cast<int64>(0 - Magnitude) : static_cast<int64>(Magnitude));
+			return true;
+		}
+		case ECSVPropertyCodecType::UnsignedInteger:
+		{
+			bool bNegative = false;
+			uint64 Magnitude = 0;
+			ZKZ_RETURN_IF(!TryParseCSVInteger(Cell, bNegative, Magnitude) || bNegative, false);
+			ZKZ_RETURN_IF(NumBits < 64 && Magnitude >= (uint64{1} << NumBits), false);
+
+			NumericProperty->SetIntPropertyValue(Value, Magnitude);
+			return true;
+		}
+		case ECSVPropertyCodecType::Float:
+		case ECSVPropertyCodecType::Double:
+		{
+			ZKZ_RETURN_IF(!IsCSVFloatingPointLiteral(Cell), false);
+
+			NumericProperty->SetFloatingPointPropertyValue(Value, FCString::Atod(Cell));
+			return true;
+		}
+		case ECSVPropertyCodecType::Bool:
+		{
+			const FBoolProperty& BoolProperty = *CastFieldChecked<const FBoolProperty>(Property);
+			if (FCString::Stricmp(Cell, TEXT("True")) == 0 || FCString::Strcmp(Cell, TEXT("1")) == 0)
+			{
+				BoolProperty.SetPropertyValue(Value, true);
+				return true;
+			}
+			if (FCString::Stricmp(Cell, TEXT("False")) == 0 || FCString::Strcmp(Cell, TEXT("0")) == 0)
+			{
+				BoolProperty.SetPropertyValue(Value, false);
+				return true;
+			}
+			return false;
+		}
+		case ECSVPropertyCodecType::Name:
+		{
+			*static_cast<FName*>(Value) = FName{Cell};
+			return true;
+		}
+		case ECSVPropertyCodecType::String:
+		{
+			*static_cast<FString*>(Value) = Cell;
+			return true;
+		}
+		case ECSVPropertyCodecType::Text:
+		{
+			*static_cast<FText*>(Value) = FText::FromStringView(Cell);
+			return true;
+		}
+		case ECSVPropertyCodecType::Enum:
+		{
+			const int64 EnumValue = Enum->GetValueByNameString(Cell);
+			ZKZ_RETURN_IF(EnumValue == INDEX_NONE, false);
+
+			NumericProperty->SetIntPropertyValue(Value, EnumValue);
+			return true;
+		}
+		case ECSVPropertyCodecType::Generic:
+		default:
+			return false;
+	}
+}
+
+bool FCSVPropertyCodec::Import(const TCHAR* const Cell, void* const Value, FString& OutError) const
+{
+	ZKZ_RETURN_IF(TryImport(Cell, Value), true);
+
+	FStringOutputDevice PropertyImportOutput;
+	FOutputDeviceStatsWrapper StatsWrapperOutput{&PropertyImportOutput};
+	const TCHAR* const RemainingCell = Property->ImportText_Direct(Cell, Value, nullptr, 0, &StatsWrapperOutput);
+
+	// Property import logs on Log, and doesn't always log when it fails
+	if (RemainingCell == nullptr || StatsWrapperOutput.GetNumMessagesWorseThan(ELogVerbosity::Log) > 0)
+	{
+		OutError = FString::Format(
+			TEXT("failed to import property. Line ignored. Detailed message: {0}"), {*PropertyImportOutput});
+		return false;
+	}
+
+	if (*RemainingCell != TEXT('\0'))
+	{
+		OutError = FString::Format(TEXT("unexpected trailing text in value: {0}"), {RemainingCell});
+		return false;
+	}
+
+	return true;
+}
+
+void FCSVPropertyCodec::Export(const void* const Value, FString& OutCell) const
+{
+	switch (Type)
+	{
+		// Values are formatted straight into the cell, without a temporary string
+		case ECSVPropertyCodecType::SignedInteger:
+			OutCell.Appendf(TEXT("%lld"), static_cast<long long>(NumericProperty->GetSignedIntPropertyValue(Value)));
+			return;
+		case ECSVPropertyCodecType::UnsignedInteger:
+			OutCell.Appendf(
+				TEXT("%llu"), static_cast<unsigned long long>(NumericProperty->GetUnsignedIntPropertyValue(Value)));
+			return;
+		// Floating point numbers get enough digits to be imported exactly, unlike with the generic export, which rounds
+		// them. Non-finite values are left to the generic export.
+		case ECSVPropertyCodecType::Float:
+		{
+			const float FloatValue = *static_cast<const float*>(Value);
+			if (FMath::IsFinite(FloatValue))
+			{
+				OutCell.Appendf(TEXT("%.9g"), FloatValue);
+				return;
+			}
+			break;
+		}
+		case ECSVPropertyCodecType::Double:
+		{
+			const double DoubleValue = *static_cast<const double*>(Value);
+			if (FMath::IsFinite(DoubleValue))
+			{
+				OutCell.Appendf(TEXT("%.17g"), DoubleValue);
+				return;
+			}
+			break;
+		}
+		case ECSVPropertyCodecType::Bool:
+		{
+			const bool bValue = CastFieldChecked<const FBoolProperty>(Property)->GetPropertyValue(Value);
+			OutCell += bValue ? TEXT("True") : TEXT("False");
+			return;
+		}
+		case ECSVPropertyCodecType::Name:
+			static_cast<const FName*>(Value)->AppendString(OutCell);
+			return;
+		case ECSVPropertyCodecType::String:
+			OutCell += *static_cast<const FString*>(Value);
+			return;
+		case ECSVPropertyCodecType::Text:
+			OutCell += static_cast<const FText*>(Value)->ToString();
+			return;
+		case ECSVPropertyCodecType::Enum:
+		{
+			// The generic export writes the autogenerated _MAX value and values without a name differently
+			const int64 EnumValue = NumericProperty->GetSignedIntPropertyValue(Value);
+			if (EnumValue != Enum->GetMaxEnumValue())
+			{
+				const FName EnumName = Enum->GetNameByValue(EnumValue);
+				if (!EnumName.IsNone())
+				{
+					// Same as GetNameStringByValue, which strips the enum's namespace, but without copying the name
+					const int32 NameStart = OutCell.Len();
+					EnumName.AppendString(OutCell);
+
+					const int32 ScopeIdx =
+						OutCell.Find(TEXT("::"), ESearchCase::CaseSensitive, ESearchDir::FromStart, NameStart);
+					if (ScopeIdx != INDEX_NONE)
+					{
+						OutCell.RemoveAt(NameStart, ScopeIdx + 2 - NameStart, EAllowShrinking::No);
+					}
+					return;
+				}
+			}
+			break;
+		}
+		case ECSVPropertyCodecType::Generic:
+		default:
+			break;
+	}
+
+	// Passing the value as the delta exports it even if it's the default value
+	Property->ExportText_Direct(OutCell, Value, Value, nullptr, PPF_None);
+}
+
+/// Codecs of all properties of a struct, in field order
+class FCSVStructCodec
+{
+public:
+	explicit FCSVStructCodec(const UStruct& Struct)
+	{
+		for (TFieldIterator<FProperty> FieldIt{&Struct}; FieldIt; ++FieldIt)
+		{
+			const FProperty* const Property = *FieldIt;
+			ZKZ_CONTINUE_IF_ENSUREALWAYS(Property == nullptr);
+
+			PropertyIndices.Emplace(Property->GetFName(), Properties.Num());
+			Properties.Emplace(*Property);
+		}
+	}
+
+	TConstArrayView<FCSVPropertyCodec> GetProperties() const
+	{
+		return Properties;
+	}
+
+	const FCSVPropertyCodec* FindProperty(const TCHAR* const Name) const
+	{
+		const FName PropertyName{Name, FNAME_Find};
+		ZKZ_RETURN_IF(PropertyName.IsNone(), nullptr);
+
+		const int32* const PropertyIdx = PropertyIndices.Find(PropertyName);
+		return PropertyIdx == nullptr ? nullptr : &Properties[*PropertyIdx];
+	}
+
+private:
+	TArray<FCSVPropertyCodec> Properties;
+	TMap<FName, int32> PropertyIndices;
+};
+
+bool IsNativeStruct(const UStruct& Struct)
+{
+	if (const UClass* const Class = Cast<UClass>(&Struct))
+	{
+		return Class->HasAnyClassFlags(CLASS_Native);
+	}
+	if (const UScriptStruct* const ScriptStruct = Cast<UScriptStruct>(&Struct))
+	{
+		return (ScriptStruct->StructFlags & STRUCT_Native) != 0;
+	}
+	return false;
+}
+
+/// Process-wide cache of the codecs of native structs, whose properties never change. Other structs (user defined
+/// structs are modified in place when recompiled) get a new codec every time.
+class FCSVStructCodecCache
+{
+public:
+	using FCodecRef = TSharedRef<const FCSVStructCodec, ESPMode::ThreadSafe>;
+
+	static FCSVStructCodecCache& Get()
+	{
+		static FCSVStructCodecCache Cache;
+		return Cache;
+	}
+
+	FCodecRef FindOrAdd(const UStruct& Struct)
+	{
+		ZKZ_RETURN_IF(!IsNativeStruct(Struct), MakeShared<FCSVStructCodec, ESPMode::ThreadSafe>(Struct));
+
+		{
+			FReadScopeLock Lock{Mutex};
+			if (const FCodecRef* const FoundCodec = Entries.Find(&Struct))
+			{
+				return *FoundCodec;
+			}
+		}
+
+		FCodecRef Codec = MakeShared<FCSVStructCodec, ESPMode::ThreadSafe>(Struct);
+
+		FWriteScopeLock Lock{Mutex};
+
+		// Another thread may have added it in the meantime
+		if (const FCodecRef* const FoundCodec = Entries.Find(&Struct))
+		{
+			return *FoundCodec;
+		}
+
+		// Entries of structs which are gone are only dropped here, as additions are rare
+		for (auto It = Entries.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		Entries.Emplace(&Struct, Codec);
+		return Codec;
+	}
+
+private:
+	mutable FRWLock Mutex;
+	TMap<TWeakObjectPtr<const UStruct>, FCodecRef> Entries;
+};
+
+/// Size of the chunks read from archives by FCSVReader
+constexpr int32 CSVReadChunkSize = 64 * 1024;
+
+/// Incremental CSV tokenizer over an archive. Rows are read one at a time, so memory use is bounded by the chunk size
+/// and the longest row, regardless of the size of the archive.
+/// Reads UTF-8 and UTF-16LE (which must start with a byte order mark). CSV syntax only uses ASCII characters, which
+/// never occur inside multi-unit characters in either encoding, so code units are tokenized as they are and only
+/// complete cells are converted.
+class FCSVReader
+{
+public:
+	explicit FCSVReader(FArchive& InArchive)
+		: Archive{InArchive}
+		, BeginOffset{InArchive.Tell()}
+		, EndOffset{InArchive.TotalSize()}
+	{
+	}
+
+	/// Archives which don't know their size can't be read, as reading past their end is an error
+	bool HasKnownSize() const
+	{
+		return EndOffset >= BeginOffset;
+	}
+
+	int64 GetNumBytes() const
+	{
+		return EndOffset - BeginOffset;
+	}
+
+	int64 GetNumBytesConsumed() const
+	{
+		return Archive.Tell() - (Chunk.Num() - ChunkPos) - BeginOffset;
+	}
+
+	/// Reads the next row, skipping empty lines, and appends its cells to OutCells.
+	/// @returns false at the end of the archive
+	bool ReadRow(TArray<FString>& OutCells);
+
+private:
+	enum class EState
+	{
+		Unquoted,
+		Quoted,
+		/// A quote in a quoted cell, which either closes the cell or is the first of an escaped pair
+		QuoteInQuoted,
+	};
+
+	FArchive& Archive;
+	const int64 BeginOffset;
+	const int64 EndOffset;
+
+	TArray<uint8> Chunk;
+	int32 ChunkPos = 0;
+
+	bool bEncodingDetected = false;
+	bool bUTF16 = false;
+
+	/// Set after a carriage return ending a row, so the line feed of a CRLF doesn't end another, empty one
+	bool bSkipLineFeed = false;
+
+	/// Raw code units of the cell being read
+	TArray<uint8> CellBytes;
+
+	bool ReadCodeUnit(uint16& OutCodeUnit);
+	void AppendCodeUnit(uint16 CodeUnit);
+	void FinishCell(TArray<FString>& OutCells);
+};
+
+bool FCSVReader::ReadRow(TArray<FString>& OutCells)
+{
+	const int32 NumCellsBefore = OutCells.Num();
+	CellBytes.Reset();
+
+	EState State = EState::Unquoted;
+	bool bCellStarted = false;
+	bool bRowEnded = false;
+
+	uint16 CodeUnit = 0;
+	while (!bRowEnded && ReadCodeUnit(CodeUnit))
+	{
+		if (bSkipLineFeed)
+		{
+			bSkipLineFeed = false;
+			ZKZ_CONTINUE_IF(CodeUnit == '\n');
+		}
+
+		if (State == EState::QuoteInQuoted)
+		{
+			if (CodeUnit == '"')
+			{
+				AppendCodeUnit(CodeUnit);
+				State = EState::Quoted;
+				continue;
+			}
+
+			// The quote closed the cell, the code unit is handled as unquoted
+			State = EState::Unquoted;
+		}
+
+		if (State == EState::Quoted)
+		{
+			if (CodeUnit == '"')
+			{
+				State = EState::QuoteInQuoted;
+			}
+			else
+			{
+				AppendCodeUnit(CodeUnit);
+			}
+			continue;
+		}
+
+		switch (CodeUnit)
+		{
+		case '"':
+			if (bCellStarted)
+			{
+				AppendCodeUnit(CodeUnit);
+			}
+			else
+			{
+				State = EState::Quoted;
+				bCellStarted = true;
+			}
+			break;
+		case ',':
+			FinishCell(OutCells);
+			bCellStarted = false;
+			break;
+		case '\r':
+		case '\n':
+			bSkipLineFeed = CodeUnit == '\r';
+			ZKZ_CONTINUE_IF(OutCells.Num() == NumCellsBefore && !bCellStarted);  // empty line
+			FinishCell(OutCells);
+			bRowEnded = true;
+			break;
+		default:
+			AppendCodeUnit(CodeUnit);
+			bCellStarted = true;
+			break;
+		}
+	}
+
+	if (!bRowEnded)
+	{
+		ZKZ_RETURN_IF(OutCells.Num() == NumCellsBefore && !bCellStarted, false);
+		FinishCell(OutCells);
+	}
+
+	return true;
+}
+
+bool FCSVReader::ReadCodeUnit(uint16& OutCodeUnit)
+{
+	while (ChunkPos + (bUTF16 ? 2 : 1) > Chunk.Num())
+	{
+		const int64 NumRemaining = EndOffset - Archive.Tell();
+		ZKZ_RETURN_IF(NumRemaining <= 0 || Archive.IsError(), false);
+
+		const int32 NumToRead = static_cast<int32>(FMath::Min<int64>(NumRemaining, CSVReadChunkSize));
+		Chunk.SetNumUninitialized(NumToRead, EAllowShrinking::No);
+		Archive.Serialize(Chunk.GetData(), Chunk.Num());
+		ChunkPos = 0;
+
+		if (!bEncodingDetected)
+		{
+			bEncodingDetected = true;
+
+			if (Chunk.Num() >= 2 && Chunk[0] == 0xFF && Chunk[1] == 0xFE)
+			{
+				bUTF16 = true;
+				ChunkPos = 2;
+			}
+			else if (Chunk.Num() >= 3 && Chunk[0] == 0xEF && Chunk[1] == 0xBB && Chunk[2] == 0xBF)
+			{
+				ChunkPos = 3;
+			}
+		}
+	}
+
+	if (bUTF16)
+	{
+		OutCodeUnit = static_cast<uint16>(Chunk[ChunkPos] | (Chunk[ChunkPos + 1] << 8));
+		ChunkPos += 2;
+	}
+	else
+	{
+		OutCodeUnit = Chunk[ChunkPos];
+		ChunkPos += 1;
+	}
+
+	return true;
+}
+
+void FCSVReader::AppendCodeUnit(const uint16 CodeUnit)
+{
+	CellBytes.Emplace(static_cast<uint8>(CodeUnit & 0xFF));
+	if (bUTF16)
+	{
+		CellBytes.Emplace(static_cast<uint8>(CodeUnit >> 8));
+	}
+}
+
+void FCSVReader::FinishCell(TArray<FString>& OutCells)
+{
+	if (bUTF16)
+	{
+		const auto Converted =
+			StringCast<TCHAR>(reinterpret_cast<const UTF16CHAR*>(CellBytes.GetData()), CellBytes.Num() / 2);
+		OutCells.Emplace(FString::ConstructFromPtrSize(Converted.Get(), Converted.Length()));
+	}
+	else
+	{
+		const auto Converted =
+			StringCast<TCHAR>(reinterpret_cast<const UTF8CHAR*>(CellBytes.GetData()), CellBytes.Num());
+		OutCells.Emplace(FString::ConstructFromPtrSize(Converted.Get(), Converted.Length()));
+	}
+
+	CellBytes.Reset();
+}
+
+/// Rows read ahead for import, with the cells of all rows in a single array
+struct FCSVRowBatch
+{
+	/// Owns the cells if they were read from an archive, otherwise empty
+	TArray<FString> CellStorage;
+	TArray<const TCHAR*> Cells;
+
+	/// Cells of row N are [RowBegins[N], RowBegins[N + 1])
+	TArray<int32> RowBegins{0};
+
+	int32 FirstLineNumber = 0;
+
+	int32 Num() const
+	{
+		return RowBegins.Num() - 1;
+	}
+
+	TArrayView<const TCHAR* const> GetRow(const int32 RowIdx) const
+	{
+		return MakeArrayView(Cells.GetData() + RowBegins[RowIdx], RowBegins[RowIdx + 1] - RowBegins[RowIdx]);
+	}
+
+	void Reset(const int32 InFirstLineNumber)
+	{
+		CellStorage.Reset();
+		Cells.Reset();
+		RowBegins.Reset();
+		RowBegins.Emplace(0);
+		FirstLineNumber = InFirstLineNumber;
+	}
+};
+
+/// Rows decoded at once in parallel modes, which bounds the memory used for decoded objects
+constexpr int32 ParallelCSVImportBatchNumRows = 16 * 1024;
+
+/// A few chunks per worker, so workers which get cheaper rows pick up more of them
+constexpr int32 NumParallelCSVImportChunksPerWorker = 4;
+
+int32 GetBatchNumRows(const ECSVImportMode Mode)
+{
+	// Serial import passes each row on as soon as it's read
+	return Mode == ECSVImportMode::Serial ? 1 : ParallelCSVImportBatchNumRows;
+}
+
+/// Appends up to MaxRows rows to the batch. Returns false if there were no rows left.
+bool ReadBatch(FCSVReader& Reader, FCSVRowBatch& Batch, const int32 MaxRows)
+{
+	while (Batch.Num() < MaxRows && Reader.ReadRow(Batch.CellStorage))
+	{
+		Batch.RowBegins.Emplace(Batch.CellStorage.Num());
+	}
+
+	// Pointers are only taken once all cells are read, as reading may reallocate the storage
+	Batch.Cells.Reset(Batch.CellStorage.Num());
+	for (const FString& Cell : Batch.CellStorage)
+	{
+		Batch.Cells.Emplace(*Cell);
+	}
+
+	return Batch.Num() > 0;
+}
+
+bool TickSlowTask(FSlowTask* const SlowTask, const float Work)
+{
+	ZKZ_RETURN_IF(SlowTask == nullptr, true);
+
+	SlowTask->EnterProgressFrame(Work);
+	return !SlowTask->ShouldCancel();
+}
+
+/// Maps CSV columns to the properties of a struct and imports rows into objects of that struct. ImportRow only writes
+/// to the given object and output, so a single importer can be shared by worker threads.
+class FCSVStructImporter
+{
+public:
+	explicit FCSVStructImporter(const UStruct& InStruct)
+		: Struct{InStruct}
+		, Codec{FCSVStructCodecCache::Get().FindOrAdd(InStruct)}
+	{
+	}
+
+	const UStruct& GetStruct() const
+	{
+		return Struct;
+	}
+
+	/// Maps the columns to properties. Logs an error and returns false if a column doesn't name a property.
+	bool ImportHeader(TArrayView<const TCHAR* const> Cells, FOutputDevice* Output);
+
+	/// Imports a row into Object, which must be an initialized object of the struct. Logs a warning and returns false
+	/// if the row can't be imported. Cells must be null terminated.
+	bool ImportRow(TArrayView<const TCHAR* const> Cells, int32 LineNumber, void* Object, FOutputDevice* Output) const;
+
+private:
+	const UStruct& Struct;
+	const FCSVStructCodecCache::FCodecRef Codec;
+
+	/// Codec of the property of each column, null for empty columns
+	TArray<const FCSVPropertyCodec*, TInlineAllocator<16>> Columns;
+};
+
+bool FCSVStructImporter::ImportHeader(const TArrayView<const TCHAR* const> Cells, FOutputDevice* const Output)
+{
+	Columns.Reset();
+
+	for (const TCHAR* const Cell : Cells)
+	{
+		if (FStringView{Cell}.IsEmpty())
+		{
+			Columns.Emplace(nullptr);
+			continue;
+		}
+
+		const FCSVPropertyCodec* const Column = Codec->FindProperty(Cell);
+		if (Column == nullptr)
+		{
+			if (Output != nullptr)
+			{
+				Output->Log(
+					ELogVerbosity::Error,
+					FString::Format(TEXT("Invalid column name: {0}. Property not found."), {Cell}));
+			}
+			return false;
+		}
+
+		Columns.Emplace(Column);
+	}
+
+	return true;
+}
+
+bool FCSVStructImporter::ImportRow(
+	const TArrayView<const TCHAR* const> Cells,
+	const int32 LineNumber,
+	void* const Object,
+	FOutputDevice* const Output) const
+{
+	const int32 NumCells = Cells.Num();
+	if (NumCells != Columns.Num())
+	{
+		if (Output != nullptr)
+		{
+			Output->Log(
+				ELogVerbosity::Warning,
+				FString::Format(
+					TEXT("Warning in line {0}: invalid number of columns. Expected {1} but got {2}. Line ignored.\n"),
+					{LineNumber, Columns.Num(), NumCells}));
+		}
+		return false;
+	}
+
+	for (int32 CellIdx = 0; CellIdx < NumCells; CellIdx++)
+	{
+		const FCSVPropertyCodec* const Column = Columns[CellIdx];
+		const TCHAR* const Cell = Cells[CellIdx];
+
+		if (Column == nullptr)  // column empty
+		{
+			if (*Cell != TEXT('\0'))
+			{
+				if (Output != nullptr)
+				{
+					Output->Log(
+						ELogVerbosity::Warning,
+						FString::Format(
+							TEXT("Warning in line {0}, column {1}: expected empty column. Line ignored.\n"),
+							{LineNumber, CellIdx + 1}));
+				}
+
+				return false;
+			}
+
+			continue;
+		}
+
+		void* const Value = Column->GetProperty().ContainerPtrToValuePtr<void>(Object);
+		FString Error;
+		if (!Column->Import(Cell, Value, Error))
+		{
+			if (Output != nullptr)
+			{
+				Output->Log(
+					ELogVerbosity::Warning,
+					FString::Format(TEXT("Warning in line {0}, column {1}: {2}\n"), {LineNumber, CellIdx + 1, Error}));
+			}
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/// Memory for a number of objects of a struct. Objects are initialized and destroyed by the user.
+class FStructBuffer
+{
+public:
+	FStructBuffer(const UStruct& Struct, const int32 NumObjects)
+		: Stride{static_cast<SIZE_T>(Align(Struct.GetStructureSize(), Struct.GetMinAlignment()))}
+		, Memory{FMemory::Malloc(FMath::Max<SIZE_T>(Stride * NumObjects, 1), Struct.GetMinAlignment())}
+	{
+		check(Memory);
+	}
+
+	~FStructBuffer()
+	{
+		FMemory::Free(Memory);
+	}
+
+	FStructBuffer(const FStructBuffer&) = delete;
+	FStructBuffer& operator=(const FStructBuffer&) = delete;
+
+	void* GetObject(const int32 ObjectIdx) const
+	{
+		return static_cast<uint8*>(Memory) + Stride * ObjectIdx;
+	}
+
+private:
+	const SIZE_T Stride;
+	void* const Memory;
+};
+
+/// Collects the messages of a worker, to be passed on to the actual output in file order
+class FCSVMessageBuffer : public FOutputDevice
+{
+public:
+	virtual void Serialize(const TCHAR* V, const ELogVerbosity::Type Verbosity, const FName& Category) override
+	{
+		Messages.Emplace(Verbosity, V);
+	}
+
+	void RedirectTo(FOutputDevice& Output) const
+	{
+		for (const TPair<ELogVerbosity::Type, FString>& Message : Messages)
+		{
+			Output.Log(Message.Key, Message.Value);
+		}
+	}
+
+private:
+	TArray<TPair<ELogVerbosity::Type, FString>> Messages;
+};
+
+/// Imports the rows of the batch and passes them to LineCallback. Returns Warning if any row was skipped.
+/// SerialObject is the memory for the single object reused by all rows in serial mode, ignored in parallel modes.
+EImportResult ImportBatch(
+	const FCSVStructImporter& Importer,
+	const FCSVRowBatch& Batch,
+	void* const SerialObject,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* const Output,
+	const ECSVImportMode Mode)
+{
+	const UStruct& Struct = Importer.GetStruct();
+	bool bAllRowsImported = true;
+
+	if (Mode == ECSVImportMode::Serial)
+	{
+		check(SerialObject != nullptr);
+		void* const Object = SerialObject;
+
+		for (int32 RowIdx = 0; RowIdx < Batch.Num(); ++RowIdx)
+		{
+			Struct.InitializeStruct(Object);
+
+			ON_SCOPE_EXIT
+			{
+				Struct.DestroyStruct(Object);
+			};
+
+			if (Importer.ImportRow(Batch.GetRow(RowIdx), Batch.FirstLineNumber + RowIdx, Object, Output))
+			{
+				LineCallback(Object);
+			}
+			else
+			{
+				bAllRowsImported = false;
+			}
+		}
+
+		return bAllRowsImported ? EImportResult::Success : EImportResult::Warning;
+	}
+
+	const bool bOrdered = Mode == ECSVImportMode::Parallel;
+	const int32 NumRows = Batch.Num();
+	const int32 NumChunks =
+		FMath::Min(ParallelPrivate::GetNumChunks(NumRows) * NumParallelCSVImportChunksPerWorker, NumRows);
+
+	// Each row gets its own object, so ordered rows can be kept until they're delivered
+	const FStructBuffer Buffer{Struct, NumRows};
+	TArray<bool> ImportedRows;
+	ImportedRows.SetNumZeroed(NumRows);
+	TArray<FCSVMessageBuffer> ChunkMessages;
+	ChunkMessages.SetNum(NumChunks);
+
+	ParallelFor(
+		NumChunks,
+		[&](const int32 ChunkIdx)
+		{
+			const int32 Begin = static_cast<int32>(static_cast<int64>(NumRows) * ChunkIdx / NumChunks);
+			const int32 End = static_cast<int32>(static_cast<int64>(NumRows) * (ChunkIdx + 1) / NumChunks);
+
+			for (int32 RowIdx = Begin; RowIdx < End; ++RowIdx)
+			{
+				void* const Object = Buffer.GetObject(RowIdx);
+				Struct.InitializeStruct(Object);
+
+				ImportedRows[RowIdx] = Importer.ImportRow(
+					Batch.GetRow(RowIdx), Batch.FirstLineNumber + RowIdx, Object, &ChunkMessages[ChunkIdx]);
+
+				// Ordered rows are delivered and destroyed on the calling thread
+				ZKZ_CONTINUE_IF(bOrdered && ImportedRows[RowIdx]);
+
+				if (ImportedRows[RowIdx])
+				{
+					LineCallback(Object);
+				}
+				Struct.DestroyStruct(Object);
+			}
+		});
+
+	// Messages are passed on in file order, regardless of which worker finished first
+	if (Output != nullptr)
+	{
+		for (const FCSVMessageBuffer& Messages : ChunkMessages)
+		{
+			Messages.RedirectTo(*Output);
+		}
+	}
+
+	for (int32 RowIdx = 0; RowIdx < NumRows; ++RowIdx)
+	{
+		if (!ImportedRows[RowIdx])
+		{
+			bAllRowsImported = false;
+			continue;
+		}
+
+		ZKZ_CONTINUE_IF(!bOrdered);
+
+		void* const Object = Buffer.GetObject(RowIdx);
+		LineCallback(Object);
+		Struct.DestroyStruct(Object);
+	}
+
+	return bAllRowsImported ? EImportResult::Success : EImportResult::Warning;
+}
+
+/// Imports the rows following the header, batch by batch. ReadNextBatch(FCSVRowBatch&) fills the batch and returns
+/// false once there are no rows left. TickProgress(const FCSVRowBatch&) is called for each batch and returns false if
+/// the import was cancelled.
+template <class ReadNextBatchType, class TickProgressType>
+EImportResult ImportRows(
+	const FCSVStructImporter& Importer,
+	ReadNextBatchType&& ReadNextBatch,
+	TickProgressType&& TickProgress,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* const Output,
+	const ECSVImportMode Mode)
+{
+	EImportResult AggregatedResult = EImportResult::Success;
+
+	// Serial batches hold a single row, so the memory for the object is allocated once for the whole import
+	TOptional<FStructBuffer> SerialBuffer;
+	if (Mode == ECSVImportMode::Serial)
+	{
+		SerialBuffer.Emplace(Importer.GetStruct(), 1);
+	}
+	void* const SerialObject = SerialBuffer.IsSet() ? SerialBuffer->GetObject(0) : nullptr;
+
+	FCSVRowBatch Batch;
+	while (ReadNextBatch(Batch))
+	{
+		ZKZ_RETURN_IF(!TickProgress(Batch), EImportResult::CancelledByUser);
+
+		if (ImportBatch(Importer, Batch, SerialObject, LineCallback, Output, Mode) == EImportResult::Warning)
+		{
+			AggregatedResult = EImportResult::Warning;
+		}
+	}
+
+	return AggregatedResult;
+}
+
+/// Size of the chunks written to archives by serial exports
+constexpr int32 CSVWriteChunkSize = 64 * 1024;
+
+/// Rows exported at once in parallel mode, which bounds the memory used for the encoded rows
+constexpr int32 ParallelCSVExportBatchNumRows = 16 * 1024;
+
+/// Encodes CSV rows as UTF-8 into a byte buffer. Cells are exported into a scratch string which is reused for all
+/// cells and quotes are escaped while encoding, so cells don't need temporary strings of their own.
+class FCSVWriter
+{
+public:
+	explicit FCSVWriter(const FCSVStructCodec& InCodec) : Codec{InCodec}
+	{
+	}
+
+	const TArray<uint8>& GetBytes() const
+	{
+		return Bytes;
+	}
+
+	void ResetBytes()
+	{
+		Bytes.Reset();
+	}
+
+	/// Writes the property names, in the same format as ExportToCSV
+	void WriteHeader();
+
+	/// Writes the quoted values of all properties of Object, in the same format as ExportToCSV
+	void WriteRow(const void* Object);
+
+private:
+	const FCSVStructCodec& Codec;
+	TArray<uint8> Bytes;
+	FString Cell;
+
+	void WriteUTF8(const TCHAR* Text, int32 Len);
+
+	void WriteASCII(const ANSICHAR Char)
+	{
+		Bytes.Emplace(static_cast<uint8>(Char));
+	}
+};
+
+void FCSVWriter::WriteHeader()
+{
+	for (const FCSVPropertyCodec& PropertyCodec : Codec.GetProperties())
+	{
+		PropertyCodec.GetProperty().GetFName().ToString(Cell);
+		WriteUTF8(*Cell, Cell.Len());
+		WriteASCII(',');
+	}
+
+	WriteASCII('\n');
+}
+
+void FCSVWriter::WriteRow(const void* const Object)
+{
+	for (const FCSVPropertyCodec& PropertyCodec : Codec.GetProperties())
+	{
+		Cell.Reset();
+		PropertyCodec.Export(PropertyCodec.GetProperty().ContainerPtrToValuePtr<void>(Object), Cell);
+
+		WriteASCII('"');
+
+		// Each quote is written along with the text preceding it and then once more
+		int32 SpanBegin = 0;
+		for (int32 CharIdx = 0; CharIdx < Cell.Len(); ++CharIdx)
+		{
+			ZKZ_CONTINUE_IF(Cell[CharIdx] != TEXT('"'));
+
+			WriteUTF8(*Cell + SpanBegin, CharIdx + 1 - SpanBegin);
+			WriteASCII('"');
+			SpanBegin = CharIdx + 1;
+		}
+		WriteUTF8(*Cell + SpanBegin, Cell.Len() - SpanBegin);
+
+		WriteASCII('"');
+		WriteASCII(',');
+	}
+
+	WriteASCII('\n');
+}
+
+void FCSVWriter::WriteUTF8(const TCHAR* const Text, const int32 Len)
+{
+	ZKZ_RETURN_IF(Len == 0);
+
+	const int32 NumBytes = FPlatformString::ConvertedLength<UTF8CHAR>(Text, Len);
+	const int32 Offset = Bytes.AddUninitialized(NumBytes);
+	FPlatformString::Convert(reinterpret_cast<UTF8CHAR*>(Bytes.GetData() + Offset), NumBytes, Text, Len);
+}
+
+void SerializeBytes(FArchive& Archive, const TArray<uint8>& Bytes)
+{
+	Archive.Serialize(const_cast<uint8*>(Bytes.GetData()), Bytes.Num());
+}
+
+/// Writes the rows in batches, each split into one chunk per worker which is encoded by its own writer. Chunks are
+/// written to the archive in order.
+void ExportRowsInParallel(const FCSVStructCodec& Codec, const TArrayView<const void*> Objects, FArchive& Archive)
+{
+	TArray<FCSVWriter> ChunkWriters;
+
+	for (int32 BatchBegin = 0; BatchBegin < Objects.Num() && !Archive.IsError();
+		 BatchBegin += ParallelCSVExportBatchNumRows)
+	{
+		const TArrayView<const void*> BatchObjects =
+			Objects.Mid(BatchBegin, FMath::Min(ParallelCSVExportBatchNumRows, Objects.Num() - BatchBegin));
+		const int32 NumRows = BatchObjects.Num();
+		const int32 NumChunks = ParallelPrivate::GetNumChunks(NumRows);
+
+		while (ChunkWriters.Num() < NumChunks)
+		{
+			ChunkWriters.Emplace(Codec);
+		}
+
+		ParallelFor(
+			NumChunks,
+			[&](const int32 ChunkIdx)
+			{
+				const int32 Begin = static_cast<int32>(static_cast<int64>(NumRows) * ChunkIdx / NumChunks);
+				const int32 End = static_cast<int32>(static_cast<int64>(NumRows) * (ChunkIdx + 1) / NumChunks);
+
+				FCSVWriter& Writer = ChunkWriters[ChunkIdx];
+				Writer.ResetBytes();
+				for (int32 RowIdx = Begin; RowIdx < End; ++RowIdx)
+				{
+					Writer.WriteRow(BatchObjects[RowIdx]);
+				}
+			});
+
+		for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+		{
+			SerializeBytes(Archive, ChunkWriters[ChunkIdx].GetBytes());
+		}
+	}
+}
+
+// Columnar tables are written and mapped as they are, in the byte order of little endian platforms
+static_assert(PLATFORM_LITTLE_ENDIAN, "Columnar tables are only supported on little endian platforms");
+
+/// "ZKCT"
+constexpr uint32 ColumnarTableMagic = 0x54434B5A;
+constexpr uint32 ColumnarTableVersion = 1;
+
+/// Column data is aligned in the file, so columns of a mapped file are aligned in memory
+constexpr int64 ColumnarTableColumnAlignment = 16;
+
+/// Rows imported at once, column by column
+constexpr int32 ColumnarTableImportBatchNumRows = 1024;
+
+/// How the values of a column are stored
+enum class EColumnarTableStorage : uint8
+{
+	/// The bytes of each value, as they are in memory
+	PlainOldData,
+	/// A byte per value, for bools. Any byte other than 0 reads back as true.
+	Bool,
+	/// Values exported to text, as by ExportToCSV. The column holds NumRows + 1 int64 offsets followed by the UTF-8
+	/// bytes of all values. Value N is [Offsets[N], Offsets[N + 1]) of the bytes.
+	String,
+};
+
+/// Whether the memory of values of the property can be written and read back in another process as it is. Object
+/// references and names can't, as they're only valid in the process which wrote them. Bools can't either, as any
+/// byte other than 0 or 1 read into a bool is undefined behaviour.
+bool IsPortablePlainOldData(const FProperty& Property)
+{
+	ZKZ_RETURN_IF(Property.IsA<FNumericProperty>() || Property.IsA<FEnumProperty>(), true);
+
+	if (const FStructProperty* const StructProperty = CastField<const FStructProperty>(&Property))
+	{
+		ZKZ_RETURN_IF(
+			!StructProperty->HasAnyPropertyFlags(CPF_IsPlainOldData) || StructProperty->Struct == nullptr, false);
+
+		for (TFieldIterator<FProperty> FieldIt{StructProperty->Struct}; FieldIt; ++FieldIt)
+		{
+			ZKZ_RETURN_IF(!IsPortablePlainOldData(**FieldIt), false);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+EColumnarTableStorage GetColumnarTableStorage(const FProperty& Property)
+{
+	ZKZ_RETURN_IF(IsPortablePlainOldData(Property), EColumnarTableStorage::PlainOldData);
+
+	// Static arrays of bools are exported as text, a column holds a single bool per row
+	const FBoolProperty* const BoolProperty = CastField<const FBoolProperty>(&Property);
+	ZKZ_RETURN_IF(
+		BoolProperty != nullptr && (!BoolProperty->IsNativeBool() || Property.GetSize() == sizeof(bool)),
+		EColumnarTableStorage::Bool);
+
+	return EColumnarTableStorage::String;
+}
+
+/// Copies a portable plain old data value field by field, skipping the padding of structs, which keeps what Dest held
+void CopyPortableValue(const FProperty& Property, const uint8* const Src, uint8* const Dest)
+{
+	const FStructProperty* const StructProperty = CastField<const FStructProperty>(&Property);
+	if (StructProperty == nullptr)
+	{
+		FMemory::Memcpy(Dest, Src, Property.GetSize());
+		return;
+	}
+
+	const int32 StructSize = StructProperty->Struct->GetStructureSize();
+	for (int32 ElementOffset = 0; ElementOffset < Property.GetSize(); ElementOffset += StructSize)
+	{
+		for (TFieldIterator<FProperty> FieldIt{StructProperty->Struct}; FieldIt; ++FieldIt)
+		{
+			CopyPortableValue(
+				**FieldIt,
+				FieldIt->ContainerPtrToValuePtr<uint8>(Src + ElementOffset),
+				FieldIt->ContainerPtrToValuePtr<uint8>(Dest + ElementOffset));
+		}
+	}
+}
+
+void AppendUTF8(TArray<uint8>& Bytes, const FStringView String)
+{
+	ZKZ_RETURN_IF(String.IsEmpty());
+
+	const int32 NumBytes = FPlatformString::ConvertedLength<UTF8CHAR>(String.GetData(), String.Len());
+	const int32 Offset = Bytes.AddUninitialized(NumBytes);
+	FPlatformString::Convert(
+		reinterpret_cast<UTF8CHAR*>(Bytes.GetData() + Offset), NumBytes, String.GetData(), String.Len());
+}
+
+/// A column being written
+struct FColumnarTableColumn
+{
+	const FCSVPropertyCodec* Codec = nullptr;
+	EColumnarTableStorage Storage = EColumnarTableStorage::String;
+	TArray<uint8> Name;
+	TArray<uint8> TypeName;
+	uint32 ElementSize = 0;
+	TArray64<uint8> Data;
+	int64 DataOffset = 0;
+};
+
+void WriteColumnData(FColumnarTableColumn& Column, const TArrayView<const void*> Objects)
+{
+	const FProperty& Property = Column.Codec->GetProperty();
+
+	switch (Column.Storage)
+	{
+		case EColumnarTableStorage::PlainOldData:
+		{
+			// Zeroed, as struct values are copied without their padding
+			Column.Data.SetNumZeroed(static_cast<int64>(Objects.Num()) * Column.ElementSize);
+
+			uint8* Dest = Column.Data.GetData();
+			for (const void* const Object : Objects)
+			{
+				CopyPortableValue(Property, Property.ContainerPtrToValuePtr<uint8>(Object), Dest);
+				Dest += Column.ElementSize;
+			}
+			return;
+		}
+		case EColumnarTableStorage::Bool:
+		{
+			const FBoolProperty& BoolProperty = *CastFieldChecked<const FBoolProperty>(&Property);
+
+			Column.Data.Reserve(Objects.Num());
+			for (const void* const Object : Objects)
+			{
+				Column.Data.Emplace(static_cast<uint8>(BoolProperty.GetPropertyValue_InContainer(Object)));
+			}
+			return;
+		}
+		case EColumnarTableStorage::String:
+		default:
+		{
+			TArray<int64> Offsets;
+			Offsets.Reserve(Objects.Num() + 1);
+			Offsets.Emplace(0);
+
+			TArray<uint8> Bytes;
+			FString Cell;
+			for (const void* const Object : Objects)
+			{
+				Cell.Reset();
+				Column.Codec->Export(Property.ContainerPtrToValuePtr<void>(Object), Cell);
+
+				AppendUTF8(Bytes, Cell);
+				Offsets.Emplace(Bytes.Num());
+			}
+
+			Column.Data.Append(reinterpret_cast<const uint8*>(Offsets.GetData()), Offsets.Num() * sizeof(int64));
+			Column.Data.Append(Bytes);
+			return;
+		}
+	}
+}
+
+void SerializeLengthPrefixedBytes(FArchive& Archive, TArray<uint8>& Bytes)
+{
+	int32 Len = Bytes.Num();
+	Archive << Len;
+	Archive.Serialize(Bytes.GetData(), Len);
+}
+
+int64 GetLengthPrefixedSize(const TArray<uint8>& Bytes)
+{
+	return sizeof(int32) + Bytes.Num();
+}
+
+void SerializePadding(FArchive& Archive, const int64 NumBytes)
+{
+	uint8 Zeros[ColumnarTableColumnAlignment] = {};
+	Archive.Serialize(Zeros, NumBytes);
+}
+
+/// Bounds checked reads from the bytes of a columnar table
+class FColumnarTableReader
+{
+public:
+	explicit FColumnarTableReader(const TArrayView64<const uint8> InData) : Data{InData}
+	{
+	}
+
+	template <class T>
+	bool Read(T& OutValue)
+	{
+		ZKZ_RETURN_IF(Position + static_cast<int64>(sizeof(T)) > Data.Num(), false);
+
+		FMemory::Memcpy(&OutValue, Data.GetData() + Position, sizeof(T));
+		Position += sizeof(T);
+		return true;
+	}
+
+	bool ReadString(FString& OutString)
+	{
+		int32 Len = 0;
+		ZKZ_RETURN_IF(!Read(Len) || Len < 0 || Position + Len > Data.Num(), false);
+
+		OutString = DecodeUTF8(Data.GetData() + Position, Len);
+		Position += Len;
+		return true;
+	}
+
+	int64 GetNumRemaining() const
+	{
+		return Data.Num() - Position;
+	}
+
+	static FString DecodeUTF8(const uint8* const Bytes, const int32 Len)
+	{
+		const auto Converted = StringCast<TCHAR>(reinterpret_cast<const UTF8CHAR*>(Bytes), Len);
+		return FString::ConstructFromPtrSize(Converted.Get(), Converted.Length());
+	}
+
+private:
+	const TArrayView64<const uint8> Data;
+	int64 Position = 0;
+};
+
+/// A column being read, mapped to a property of the imported struct
+struct FColumnarTableSourceColumn
+{
+	FString Name;
+	FString TypeName;
+	EColumnarTableStorage Storage = EColumnarTableStorage::String;
+	uint32 ElementSize = 0;
+	const uint8* Data = nullptr;
+	int64 DataSize = 0;
+
+	/// UTF-8 bytes of string columns, following the offsets
+	const uint8* StringBytes = nullptr;
+
+	/// Null if the struct has no property of the column's name
+	const FCSVPropertyCodec* Codec = nullptr;
+
+	/// Offsets are read by copying, as the data of columns passed in memory may not be aligned
+	int64 GetStringOffset(const int64 RowIdx) const
+	{
+		int64 Offset = 0;
+		FMemory::Memcpy(&Offset, Data + RowIdx * sizeof(int64), sizeof(int64));
+		return Offset;
+	}
+};
+
+/// Reads the header and checks that the columns fit in the data and match the struct
+EImportResult ReadColumnarTableHeader(
+	const TArrayView64<const uint8> Data,
+	const FCSVStructCodec& Codec,
+	int32& OutNumRows,
+	TArray<FColumnarTableSourceColumn>& OutColumns,
+	FOutputDevice* const Output)
+{
+	const auto LogError = [Output](const FString& Message)
+	{
+		if (Output != nullptr)
+		{
+			Output->Log(ELogVerbosity::Error, Message);
+		}
+		return EImportResult::Error;
+	};
+
+	FColumnarTableReader Reader{Data};
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	FString StructPath;
+	int32 NumColumns = 0;
+	if (!Reader.Read(Magic) || Magic != ColumnarTableMagic || !Reader.Read(Version))
+	{
+		return LogError(TEXT("Failed to read columnar table. The data isn't a columnar table."));
+	}
+
+	if (Version != ColumnarTableVersion)
 	{
-		FText Text;
-		TextProperty->GetValue_InContainer(Object, &Text);
+		return LogError(FString::Format(TEXT("Failed to read columnar table. Unsupported version {0}."), {Version}));
+	}
+
+	// Name and type name lengths, storage, element size, data offset and size
+	constexpr int64 MinColumnHeaderSize = sizeof(int32) * 2 + sizeof(uint8) + sizeof(uint32) + sizeof(int64) * 2;
+
+	// Checked against the bytes left before anything is allocated for the columns
+	if (!Reader.ReadString(StructPath) || !Reader.Read(OutNumRows) || !Reader.Read(NumColumns) || OutNumRows < 0
+		|| NumColumns < 0 || NumColumns > Reader.GetNumRemaining() / MinColumnHeaderSize)
+	{
+		return LogError(TEXT("Failed to read columnar table. The header is truncated."));
+	}
+
+	EImportResult Result = EImportResult::Success;
+
+	OutColumns.Reset(NumColumns);
+	for (int32 ColumnIdx = 0; ColumnIdx < NumColumns; ++ColumnIdx)
+	{
+		FColumnarTableSourceColumn& Column = OutColumns.Emplace_GetRef();
+
+		uint8 Storage = 0;
+		int64 DataOffset = 0;
+		if (!Reader.ReadString(Column.Name) || !Reader.ReadString(Column.TypeName) || !Reader.Read(Storage)
+			|| !Reader.Read(Column.ElementSize) || !Reader.Read(DataOffset) || !Reader.Read(Column.DataSize))
+		{
+			return LogError(TEXT("Failed to read columnar table. The header is truncated."));
+		}
+
+		Column.Storage = static_cast<EColumnarTableStorage>(Storage);
+
+		int64 ExpectedDataSize = 0;
+		switch (Column.Storage)
+		{
+			case EColumnarTableStorage::PlainOldData:
+				// Columns of empty values wouldn't bound the number of rows by the size of the data
+				if (Column.ElementSize == 0)
+				{
+					return LogError(FString::Format(
+						TEXT("Failed to read columnar table. Invalid element size of column {0}."), {Column.Name}));
+				}
+				ExpectedDataSize = static_cast<int64>(OutNumRows) * Column.ElementSize;
+				break;
+			case EColumnarTableStorage::Bool:
+				ExpectedDataSize = OutNumRows;
+				break;
+			case EColumnarTableStorage::String:
+				ExpectedDataSize = (static_cast<int64>(OutNumRows) + 1) * sizeof(int64);
+				break;
+			default:
+				return LogError(FString::Format(
+					TEXT("Failed to read columnar table. Unknown storage of column {0}."), {Column.Name}));
+		}
+
+		if (DataOffset < 0 || Column.DataSize < ExpectedDataSize || DataOffset > Data.Num() - Column.DataSize
+			|| (Column.Storage == EColumnarTableStorage::PlainOldData && Column.DataSize != ExpectedDataSize))
+		{
+			return LogError(FString::Format(
+				TEXT("Failed to read columnar table. Data of column {0} is out of bounds."), {Column.Name}));
+		}
+
+		Column.Data = Data.GetData() + DataOffset;
+
+		if (Column.Storage == EColumnarTableStorage::String)
+		{
+			Column.StringBytes = Column.Data + ExpectedDataSize;
+
+			// Offsets are checked once here, so rows can be read without checks
+			const int64 NumStringBytes = Column.DataSize - ExpectedDataSize;
+			for (int32 RowIdx = 0; RowIdx < OutNumRows; ++RowIdx)
+			{
+				const int64 Begin = Column.GetStringOffset(RowIdx);
+				const int64 End = Column.GetStringOffset(RowIdx + 1);
+				if (Begin < 0 || Begin > End || End > NumStringBytes || End - Begin > MAX_int32)
+				{
+					return LogError(FString::Format(
+						TEXT("Failed to read columnar table. Invalid string offsets in column {0}."), {Column.Name}));
+				}
+			}
+		}
+
+		Column.Codec = Codec.FindProperty(*Column.Name);
+		if (Column.Codec == nullptr)
+		{
+			if (Output != nullptr)
+			{
+				Output->Log(
+					ELogVerbosity::Warning,
+					FString::Format(TEXT("Column {0} not found in {1}. Column ignored."), {Column.Name, StructPath}));
+			}
+			Result = EImportResult::Warning;
+			continue;
+		}
+
+		// Values stored as text are imported as text, so they can be read into properties of other types. Other
+		// values are only read into properties of the same type and size.
+		const FProperty& Property = Column.Codec->GetProperty();
+		const bool bTypeMatches = Column.Storage == EColumnarTableStorage::String
+			|| (Column.Storage == EColumnarTableStorage::Bool
+				&& GetColumnarTableStorage(Property) == EColumnarTableStorage::Bool)
+			|| (Column.Storage == EColumnarTableStorage::PlainOldData && IsPortablePlainOldData(Property)
+				&& static_cast<uint32>(Property.GetSize()) == Column.ElementSize
+				&& Property.GetCPPType() == Column.TypeName);
+		if (!bTypeMatches)
+		{
+			return LogError(FString::Format(
+				TEXT("Failed to read columnar table. Column {0} of type {1} doesn't match property of type {2}."),
+				{Column.Name, Column.TypeName, Property.GetCPPType()}));
+		}
+	}
 
-		return Text.ToString();
+	// The data of the columns bounds the number of rows, so without any, a corrupt number of rows would make the import
+	// produce that many default objects
+	const bool bAnyColumnImported = Algo::AnyOf(
+		OutColumns, [](const FColumnarTableSourceColumn& Column) { return Column.Codec != nullptr; });
+	if (OutNumRows > 0 && !bAnyColumnImported)
+	{
+		return LogError(FString::Format(
+			TEXT("Failed to read columnar table. None of the columns match a property of {0}."), {StructPath}));
 	}
-	else
+
+	return Result;
+}
+
+/// Reads a batch of rows into initialized objects, column by column. Clears the bits of rows which failed to import.
+void ReadColumnarTableBatch(
+	const TArray<FColumnarTableSourceColumn>& Columns,
+	const int32 FirstRowIdx,
+	const FStructBuffer& Buffer,
+	const int32 NumRows,
+	TBitArray<>& ImportedRows,
+	FOutputDevice* const Output)
+{
+	FString Cell;
+	FString Error;
+
+	for (int32 ColumnIdx = 0; ColumnIdx < Columns.Num(); ++ColumnIdx)
 	{
-		FString String;
-		Property.ExportText_Direct(String, Object, nullptr, nullptr, 0);
+		const FColumnarTableSourceColumn& Column = Columns[ColumnIdx];
+		ZKZ_CONTINUE_IF(Column.Codec == nullptr);
+
+		const FProperty& Property = Column.Codec->GetProperty();
+
+		for (int32 RowIdx = 0; RowIdx < NumRows; ++RowIdx)
+		{
+			void* const Value = Property.ContainerPtrToValuePtr<void>(Buffer.GetObject(RowIdx));
+			const int64 SourceRowIdx = FirstRowIdx + RowIdx;
+
+			switch (Column.Storage)
+			{
+				case EColumnarTableStorage::PlainOldData:
+					FMemory::Memcpy(Value, Column.Data + SourceRowIdx * Column.ElementSize, Column.ElementSize);
+					break;
+				case EColumnarTableStorage::Bool:
+					CastFieldChecked<const FBoolProperty>(&Property)->SetPropertyValue(
+						Value, Column.Data[SourceRowIdx] != 0);
+					break;
+				case EColumnarTableStorage::String:
+				default:
+				{
+					ZKZ_CONTINUE_IF(!ImportedRows[RowIdx]);
+
+					const int64 Begin = Column.GetStringOffset(SourceRowIdx);
+					const int64 End = Column.GetStringOffset(SourceRowIdx + 1);
+					Cell =
+						FColumnarTableReader::DecodeUTF8(Column.StringBytes + Begin, static_cast<int32>(End - Begin));
 
-		return String;
+					if (!Column.Codec->Import(*Cell, Value, Error))
+					{
+						ImportedRows[RowIdx] = false;
+
+						if (Output != nullptr)
+						{
+							Output->Log(
+								ELogVerbosity::Warning,
+								FString::Format(
+									TEXT("Warning in row {0}, column {1}: {2}\n"),
+									{SourceRowIdx + 1, ColumnIdx + 1, Error}));
+						}
+					}
+					break;
+				}
+			}
+		}
 	}
 }
 
+}  // namespace SerializationPrivate
+
 FString GetCSVSanitizedString(FString String)
 {
 	String = MoveTemp(String).Replace(TEXT(R"(")"), TEXT(R"("")"));	 // " -> ""
@@ -41,27 +1711,27 @@ FString GetCSVSanitizedString(FString String)
 
 FString ExportToCSV(const UStruct& Struct, const TArrayView<const void*> Objects)
 {
+	using namespace SerializationPrivate;
+
+	const FCSVStructCodecCache::FCodecRef Codec = FCSVStructCodecCache::Get().FindOrAdd(Struct);
+
 	FStringBuilderBase Builder;
 
-	for (TFieldIterator<FProperty> FieldIt{&Struct}; FieldIt; ++FieldIt)
+	for (const FCSVPropertyCodec& PropertyCodec : Codec->GetProperties())
 	{
-		const FProperty* const Property = *FieldIt;
-		ZKZ_CONTINUE_IF_ENSUREALWAYS(Property == nullptr);
-
-		Builder.Append(FString{*Property->GetName()}).Append(",");
+		Builder.Append(PropertyCodec.GetProperty().GetName()).Append(",");
 	}
 
 	Builder.Append("\n");
 
+	FString Cell;
 	for (const void* Object : Objects)
 	{
-		for (TFieldIterator<FProperty> FieldIt{&Struct}; FieldIt; ++FieldIt)
+		for (const FCSVPropertyCodec& PropertyCodec : Codec->GetProperties())
 		{
-			const FProperty* const Property = *FieldIt;
-			ZKZ_CONTINUE_IF_ENSUREALWAYS(Property == nullptr);
-
-			FString SerializedString = GetSerializedString(*Property, Object);
-			Builder.Append(R"(")").Append(GetCSVSanitizedString(MoveTemp(SerializedString))).Append(R"(",)");
+			Cell.Reset();
+			PropertyCodec.Export(PropertyCodec.GetProperty().ContainerPtrToValuePtr<void>(Object), Cell);
+			Builder.Append(R"(")").Append(GetCSVSanitizedString(Cell)).Append(R"(",)");
 		}
 
 		Builder.Append("\n");
@@ -70,16 +1740,72 @@ FString ExportToCSV(const UStruct& Struct, const TArrayView<const void*> Objects
 	return Builder.ToString();
 }
 
+bool ExportToCSV(
+	const UStruct& Struct, const TArrayView<const void*> Objects, FArchive& Archive, const ECSVExportMode Mode)
+{
+	using namespace SerializationPrivate;
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Archive.IsSaving(), false);
+
+	const FCSVStructCodecCache::FCodecRef Codec = FCSVStructCodecCache::Get().FindOrAdd(Struct);
+
+	FCSVWriter Writer{*Codec};
+	Writer.WriteHeader();
+
+	if (Mode == ECSVExportMode::Parallel)
+	{
+		SerializeBytes(Archive, Writer.GetBytes());
+		ExportRowsInParallel(*Codec, Objects, Archive);
+
+		return !Archive.IsError();
+	}
+
+	for (const void* Object : Objects)
+	{
+		Writer.WriteRow(Object);
+
+		if (Writer.GetBytes().Num() >= CSVWriteChunkSize)
+		{
+			SerializeBytes(Archive, Writer.GetBytes());
+			Writer.ResetBytes();
+			ZKZ_RETURN_IF(Archive.IsError(), false);
+		}
+	}
+
+	SerializeBytes(Archive, Writer.GetBytes());
+
+	return !Archive.IsError();
+}
+
+bool ExportToCSVFile(
+	const UStruct& Struct,
+	const TArrayView<const void*> Objects,
+	const TCHAR* const FileName,
+	const ECSVExportMode Mode)
+{
+	const TUniquePtr<FArchive> FileWriter{IFileManager::Get().CreateFileWriter(FileName)};
+	ZKZ_RETURN_IF(!FileWriter, false);
+
+	ExportToCSV(Struct, Objects, *FileWriter, Mode);
+
+	// Closing flushes the remaining data, which may fail as well
+	return FileWriter->Close();
+}
+
 EImportResult ImportFromCSV(
 	const UStruct& Struct,
 	const FString& CSV,
 	const TFunction<void(const void*)>& LineCallback,
 	FOutputDevice* const Output,
-	FSlowTask* const SlowTask)
+	FSlowTask* const SlowTask,
+	const ECSVImportMode Mode)
 {
+	using namespace SerializationPrivate;
+
 	const FCsvParser Parser{CSV};
+	const FCsvParser::FRows& Rows = Parser.GetRows();
 
-	if (Parser.GetRows().IsEmpty())
+	if (Rows.IsEmpty())
 	{
 		if (Output != nullptr)
 		{
@@ -89,162 +1815,353 @@ EImportResult ImportFromCSV(
 		return EImportResult::Error;
 	}
 
-	void* const Object = FMemory::Malloc(Struct.GetStructureSize(), Struct.GetMinAlignment());
-	check(Object);
+	FCSVStructImporter Importer{Struct};
+
+	ZKZ_RETURN_IF(!TickSlowTask(SlowTask, 1.0f / Rows.Num()), EImportResult::CancelledByUser);
+	ZKZ_RETURN_IF(!Importer.ImportHeader(Rows[0], Output), EImportResult::Error);
+
+	const int32 BatchNumRows = GetBatchNumRows(Mode);
+	int32 NextRowIdx = 1;
+
+	return ImportRows(
+		Importer,
+		[&](FCSVRowBatch& Batch)
+		{
+			Batch.Reset(NextRowIdx + 1);
+			for (; NextRowIdx < Rows.Num() && Batch.Num() < BatchNumRows; ++NextRowIdx)
+			{
+				Batch.Cells.Append(Rows[NextRowIdx]);
+				Batch.RowBegins.Emplace(Batch.Cells.Num());
+			}
+
+			return Batch.Num() > 0;
+		},
+		[SlowTask, &Rows](const FCSVRowBatch& Batch)
+		{ return TickSlowTask(SlowTask, static_cast<float>(Batch.Num()) / Rows.Num()); },
+		LineCallback,
+		Output,
+		Mode);
+}
+
+EImportResult ImportFromCSV(
+	const UStruct& Struct,
+	FArchive& Archive,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* const Output,
+	FSlowTask* const SlowTask,
+	const ECSVImportMode Mode)
+{
+	using namespace SerializationPrivate;
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Archive.IsLoading(), EImportResult::Error);
+
+	FCSVReader Reader{Archive};
+
+	if (!Reader.HasKnownSize())
+	{
+		if (Output != nullptr)
+		{
+			Output->Log(ELogVerbosity::Error, "Failed to read CSV. The archive doesn't know its size.");
+		}
+		return EImportResult::Error;
+	}
 
-	ON_SCOPE_EXIT
+	int64 NumBytesTicked = 0;
+	const auto TickProgress = [SlowTask, &Reader, &NumBytesTicked]
 	{
-		FMemory::Free(Object);
+		const int64 NumBytesConsumed = Reader.GetNumBytesConsumed();
+		const float Work = Reader.GetNumBytes() > 0
+			? static_cast<float>(NumBytesConsumed - NumBytesTicked) / Reader.GetNumBytes()
+			: 0.0f;
+		NumBytesTicked = NumBytesConsumed;
+
+		return TickSlowTask(SlowTask, Work);
 	};
 
-	const auto TickSlowTask = [SlowTask, Work = 1.0f / (Parser.GetRows().Num())]
+	FCSVStructImporter Importer{Struct};
+
+	FCSVRowBatch Header;
+	if (!ReadBatch(Reader, Header, 1))
 	{
-		if (SlowTask != nullptr)
+		if (Output != nullptr)
 		{
-			SlowTask->EnterProgressFrame(Work);
-			ZKZ_RETURN_IF(SlowTask->ShouldCancel(), false);
+			Output->Log(ELogVerbosity::Error, "Failed to parse CSV. No header row found. Is the imported file empty?");
 		}
+		return EImportResult::Error;
+	}
 
-		return true;
-	};
+	ZKZ_RETURN_IF(!TickProgress(), EImportResult::CancelledByUser);
+	ZKZ_RETURN_IF(!Importer.ImportHeader(Header.GetRow(0), Output), EImportResult::Error);
+
+	const int32 BatchNumRows = GetBatchNumRows(Mode);
+	int32 NextLineNumber = 2;
+
+	const EImportResult Result = ImportRows(
+		Importer,
+		[&](FCSVRowBatch& Batch)
+		{
+			Batch.Reset(NextLineNumber);
+			ZKZ_RETURN_IF(!ReadBatch(Reader, Batch, BatchNumRows), false);
+
+			NextLineNumber += Batch.Num();
+			return true;
+		},
+		[&TickProgress](const FCSVRowBatch&) { return TickProgress(); },
+		LineCallback,
+		Output,
+		Mode);
 
-	TArray<const FProperty*, TInlineAllocator<16>> Properties;
+	ZKZ_RETURN_IF(Result == EImportResult::CancelledByUser, Result);
 
-	ZKZ_RETURN_IF(!TickSlowTask(), EImportResult::CancelledByUser);
-	for (const TCHAR* const Cell : Parser.GetRows()[0])
+	if (Archive.IsError())
 	{
-		if (FStringView{Cell}.IsEmpty())
+		if (Output != nullptr)
 		{
-			Properties.Emplace(nullptr);
-			continue;
+			Output->Log(ELogVerbosity::Error, "Failed to read CSV. Archive reported an error.");
+		}
+		return EImportResult::Error;
+	}
+
+	return Result;
+}
+
+EImportResult ImportFromCSVFile(
+	const UStruct& Struct,
+	const TCHAR* const FileName,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* const Output,
+	FSlowTask* const SlowTask,
+	const ECSVImportMode Mode)
+{
+	const TUniquePtr<FArchive> FileReader{IFileManager::Get().CreateFileReader(FileName)};
+	if (!FileReader)
+	{
+		if (Output != nullptr)
+		{
+			Output->Log(ELogVerbosity::Error, FString::Format(TEXT("Failed to open CSV file: {0}."), {FileName}));
 		}
+		return EImportResult::Error;
+	}
+
+	return ImportFromCSV(Struct, *FileReader, LineCallback, Output, SlowTask, Mode);
+}
+
+bool ExportToColumnarTable(const UStruct& Struct, const TArrayView<const void*> Objects, FArchive& Archive)
+{
+	using namespace SerializationPrivate;
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Archive.IsSaving(), false);
 
-		const FProperty* const Property = Struct.FindPropertyByName(Cell);
-		if (Property == nullptr)
+	const FCSVStructCodecCache::FCodecRef Codec = FCSVStructCodecCache::Get().FindOrAdd(Struct);
+
+	TArray<uint8> StructPath;
+	AppendUTF8(StructPath, Struct.GetPathName());
+
+	// Magic, version, struct path, number of rows and columns
+	int64 HeaderSize = sizeof(uint32) * 2 + GetLengthPrefixedSize(StructPath) + sizeof(int32) * 2;
+
+	TArray<FColumnarTableColumn> Columns;
+	for (const FCSVPropertyCodec& PropertyCodec : Codec->GetProperties())
+	{
+		const FProperty& Property = PropertyCodec.GetProperty();
+
+		FColumnarTableColumn& Column = Columns.Emplace_GetRef();
+		Column.Codec = &PropertyCodec;
+		Column.Storage = GetColumnarTableStorage(Property);
+		if (Column.Storage == EColumnarTableStorage::PlainOldData)
 		{
-			if (Output != nullptr)
-			{
-				Output->Log(
-					ELogVerbosity::Error,
-					FString::Format(TEXT("Invalid column name: {0}. Property not found."), {Cell}));
-			}
-			return EImportResult::Error;
+			Column.ElementSize = static_cast<uint32>(Property.GetSize());
+		}
+		else if (Column.Storage == EColumnarTableStorage::Bool)
+		{
+			Column.ElementSize = 1;
 		}
+		AppendUTF8(Column.Name, Property.GetName());
+		AppendUTF8(Column.TypeName, Property.GetCPPType());
+		WriteColumnData(Column, Objects);
 
-		Properties.Emplace(Property);
+		// Name, type name, storage, element size, data offset and size
+		HeaderSize += GetLengthPrefixedSize(Column.Name) + GetLengthPrefixedSize(Column.TypeName) + sizeof(uint8)
+			+ sizeof(uint32) + sizeof(int64) * 2;
 	}
 
-	EImportResult AggregatedResult = EImportResult::Success;
-	FTextBuilder AggregatedMessageBuilder;
+	int64 DataEnd = HeaderSize;
+	for (FColumnarTableColumn& Column : Columns)
+	{
+		Column.DataOffset = Align(DataEnd, ColumnarTableColumnAlignment);
+		DataEnd = Column.DataOffset + Column.Data.Num();
+	}
 
-	for (int32 RowIdx = 1; RowIdx < Parser.GetRows().Num(); ++RowIdx)
+	uint32 Magic = ColumnarTableMagic;
+	uint32 Version = ColumnarTableVersion;
+	int32 NumRows = Objects.Num();
+	int32 NumColumns = Columns.Num();
+	Archive << Magic << Version;
+	SerializeLengthPrefixedBytes(Archive, StructPath);
+	Archive << NumRows << NumColumns;
+
+	for (FColumnarTableColumn& Column : Columns)
+	{
+		uint8 Storage = static_cast<uint8>(Column.Storage);
+		int64 DataSize = Column.Data.Num();
+
+		SerializeLengthPrefixedBytes(Archive, Column.Name);
+		SerializeLengthPrefixedBytes(Archive, Column.TypeName);
+		Archive << Storage << Column.ElementSize << Column.DataOffset << DataSize;
+	}
+
+	DataEnd = HeaderSize;
+	for (FColumnarTableColumn& Column : Columns)
 	{
-		const TArray<const TCHAR*>& Row = Parser.GetRows()[RowIdx];
+		SerializePadding(Archive, Column.DataOffset - DataEnd);
+		Archive.Serialize(Column.Data.GetData(), Column.Data.Num());
+		DataEnd = Column.DataOffset + Column.Data.Num();
+	}
+
+	return !Archive.IsError();
+}
+
+bool ExportToColumnarTableFile(
+	const UStruct& Struct, const TArrayView<const void*> Objects, const TCHAR* const FileName)
+{
+	const TUniquePtr<FArchive> FileWriter{IFileManager::Get().CreateFileWriter(FileName)};
+	ZKZ_RETURN_IF(!FileWriter, false);
+
+	ExportToColumnarTable(Struct, Objects, *FileWriter);
+
+	// Closing flushes the remaining data, which may fail as well
+	return FileWriter->Close();
+}
+
+EImportResult ImportFromColumnarTable(
+	const UStruct& Struct,
+	const TArrayView64<const uint8> Data,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* const Output)
+{
+	using namespace SerializationPrivate;
+
+	const FCSVStructCodecCache::FCodecRef Codec = FCSVStructCodecCache::Get().FindOrAdd(Struct);
 
-		ZKZ_RETURN_IF(!TickSlowTask(), EImportResult::CancelledByUser);
+	int32 NumRows = 0;
+	TArray<FColumnarTableSourceColumn> Columns;
+	EImportResult Result = ReadColumnarTableHeader(Data, *Codec, NumRows, Columns, Output);
+	ZKZ_RETURN_IF(Result == EImportResult::Error, Result);
 
-		Struct.InitializeStruct(Object);
+	const int32 BatchNumRows = FMath::Min(NumRows, ColumnarTableImportBatchNumRows);
+	const FStructBuffer Buffer{Struct, BatchNumRows};
+	TBitArray<> ImportedRows;
+
+	for (int32 FirstRowIdx = 0; FirstRowIdx < NumRows; FirstRowIdx += BatchNumRows)
+	{
+		const int32 NumBatchRows = FMath::Min(BatchNumRows, NumRows - FirstRowIdx);
 
-		ON_SCOPE_EXIT
+		for (int32 RowIdx = 0; RowIdx < NumBatchRows; ++RowIdx)
 		{
-			Struct.DestroyStruct(Object);
-		};
+			Struct.InitializeStruct(Buffer.GetObject(RowIdx));
+		}
 
-		const int32 NumCells = Row.Num();
-		if (NumCells != Properties.Num())
+		ImportedRows.Init(true, NumBatchRows);
+		ReadColumnarTableBatch(Columns, FirstRowIdx, Buffer, NumBatchRows, ImportedRows, Output);
+
+		for (int32 RowIdx = 0; RowIdx < NumBatchRows; ++RowIdx)
 		{
-			AggregatedResult = EImportResult::Warning;
-			if (Output != nullptr)
+			void* const Object = Buffer.GetObject(RowIdx);
+
+			if (ImportedRows[RowIdx])
 			{
-				Output->Log(
-					ELogVerbosity::Warning,
-					FString::Format(
-						TEXT(
-							"Warning in line {0}: invalid number of columns. Expected {1} but got {2}. Line ignored.\n"),
-						{RowIdx + 1, NumCells, Properties.Num()}));
+				LineCallback(Object);
 			}
-			continue;
+			else
+			{
+				Result = EImportResult::Warning;
+			}
+
+			Struct.DestroyStruct(Object);
 		}
+	}
+
+	return Result;
+}
+
+EImportResult ImportFromColumnarTableFile(
+	const UStruct& Struct,
+	const TCHAR* const FileName,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* const Output)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 
-		const bool bRowImportSuccessful = [&]
+	auto MappedFile = PlatformFile.OpenMappedEx(FileName);
+	if (MappedFile.HasValue() && MappedFile.GetValue()->GetFileSize() > 0)
+	{
+		const TUniquePtr<IMappedFileRegion> MappedRegion{MappedFile.GetValue()->MapRegion()};
+		if (MappedRegion)
 		{
-			for (int32 CellIdx = 0; CellIdx < NumCells; CellIdx++)
-			{
-				const FProperty* const Property = Properties[CellIdx];
-				const FStringView CellText = Row[CellIdx];
+			return ImportFromColumnarTable(
+				Struct,
+				TArrayView64<const uint8>{MappedRegion->GetMappedPtr(), MappedRegion->GetMappedSize()},
+				LineCallback,
+				Output);
+		}
+	}
 
-				if (Property == nullptr)  // column empty
-				{
-					if (!CellText.IsEmpty())
-					{
-						AggregatedResult = EImportResult::Warning;
-						if (Output != nullptr)
-						{
-							Output->Log(
-								ELogVerbosity::Warning,
-								FString::Format(
-									TEXT("Warning in line {0}, column {1}: expected empty column. Line ignored.\n"),
-									{RowIdx + 1, CellIdx + 1}));
-						}
+	// Platforms without mapped files, and empty files, which can't be mapped, are read into memory
+	TArray64<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, FileName))
+	{
+		if (Output != nullptr)
+		{
+			Output->Log(
+				ELogVerbosity::Error, FString::Format(TEXT("Failed to open columnar table file: {0}."), {FileName}));
+		}
+		return EImportResult::Error;
+	}
 
-						return false;
-					}
+	return ImportFromColumnarTable(Struct, Bytes, LineCallback, Output);
+}
 
-					continue;
-				}
+EImportResult ConvertColumnarTableToCSV(
+	const UStruct& Struct, const TArrayView64<const uint8> Data, FArchive& CSVArchive, FOutputDevice* const Output)
+{
+	using namespace SerializationPrivate;
 
-				if (const FTextProperty* const TextProperty = ExactCastField<const FTextProperty>(Property))
-				{
-					const FText Text = FText::FromStringView(CellText);
-					TextProperty->SetValue_InContainer(Object, Text);
-				}
-				else
-				{
-					FStringOutputDevice PropertyImportOutput;
-					FOutputDeviceStatsWrapper StatsWrapperOutput{&PropertyImportOutput};
-					const FStringView RemainingCellText =
-						Property->ImportText_Direct(CellText.GetData(), Object, nullptr, 0, &StatsWrapperOutput);
+	ZKZ_RETURN_IF_ENSUREALWAYS(!CSVArchive.IsSaving(), EImportResult::Error);
 
-					// Property import logs on Log
-					if (StatsWrapperOutput.GetNumMessagesWorseThan(ELogVerbosity::Log) > 0)
-					{
-						AggregatedResult = EImportResult::Warning;
-						if (Output != nullptr)
-						{
-							Output->Log(
-								ELogVerbosity::Warning,
-								FString::Format(
-									TEXT(
-										"Warning in line {0}, column {1}: failed to import property. Line ignored. Detailed message: {2}\n"),
-									{RowIdx + 1, CellIdx + 1, *PropertyImportOutput}));
-						}
-						return false;
-					}
-					else if (!RemainingCellText.IsEmpty())
-					{
-						AggregatedResult = EImportResult::Warning;
-						if (Output != nullptr)
-						{
-							Output->Log(
-								ELogVerbosity::Warning,
-								FString::Format(
-									TEXT("Warning in line {0}, column {1}: unexpected trailing text in value: {2}\n"),
-									{RowIdx + 1, CellIdx + 1, RemainingCellText}));
-						}
-						return false;
-					}
-				}
+	const FCSVStructCodecCache::FCodecRef Codec = FCSVStructCodecCache::Get().FindOrAdd(Struct);
+
+	FCSVWriter Writer{*Codec};
+	Writer.WriteHeader();
+
+	const EImportResult Result = ImportFromColumnarTable(
+		Struct,
+		Data,
+		[&Writer, &CSVArchive](const void* const Object)
+		{
+			Writer.WriteRow(Object);
+
+			if (Writer.GetBytes().Num() >= CSVWriteChunkSize)
+			{
+				SerializeBytes(CSVArchive, Writer.GetBytes());
+				Writer.ResetBytes();
 			}
+		},
+		Output);
 
-			return true;
-		}();
+	ZKZ_RETURN_IF(Result == EImportResult::Error, Result);
 
-		ZKZ_CONTINUE_IF(!bRowImportSuccessful);
+	SerializeBytes(CSVArchive, Writer.GetBytes());
 
-		LineCallback(Object);
+	if (CSVArchive.IsError())
+	{
+		if (Output != nullptr)
+		{
+			Output->Log(ELogVerbosity::Error, "Failed to write CSV. Archive reported an error.");
+		}
+		return EImportResult::Error;
 	}
 
-	return AggregatedResult;
+	return Result;
 }
 
 }  // namespace Zkz::Serialization
@@ -0,0 +1,185 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/SmallObjectPool.h"
+
+#include "Zakazane/ReturnIfMacros.h"
+
+#include <atomic>
+
+namespace Zkz::SmallObjectPool
+{
+
+namespace
+{
+
+/// Number of blocks moved between a thread cache and the global overflow list at once
+constexpr int32 TransferBatchSize = 32;
+
+/// Thread cache size (per size class) after which a batch is moved to the global overflow list
+constexpr int32 MaxThreadCacheBlocks = TransferBatchSize * 2;
+
+struct FFreeBlock
+{
+	FFreeBlock* Next = nullptr;
+};
+
+struct FFreeList
+{
+	FFreeBlock* Head = nullptr;
+	int32 Num = 0;
+
+	void Push(FFreeBlock* const Block)
+	{
+		Block->Next = Head;
+		Head = Block;
+		++Num;
+	}
+
+	FFreeBlock* Pop()
+	{
+		FFreeBlock* const Block = Head;
+		Head = Block->Next;
+		--Num;
+		return Block;
+	}
+
+	/// Moves up to MaxBlocks blocks from this list to Target
+	void TransferTo(FFreeList& Target, const int32 MaxBlocks)
+	{
+		for (int32 Idx = 0; Idx < MaxBlocks && Head != nullptr; ++Idx)
+		{
+			Target.Push(Pop());
+		}
+	}
+};
+
+struct FGlobalPool
+{
+	FCriticalSection Mutex;
+	FFreeList Overflow[NumSizeClasses];
+
+	std::atomic<uint64> NumHits{0};
+	std::atomic<uint64> NumMisses{0};
+	std::atomic<int64> NumLive{0};
+	std::atomic<int64> PeakLive{0};
+
+	void OnAllocated(const bool bHit)
+	{
+		(bHit ? NumHits : NumMisses).fetch_add(1, std::memory_order_relaxed);
+
+		const int64 NewNumLive = NumLive.fetch_add(1, std::memory_order_relaxed) + 1;
+		int64 PrevPeak = PeakLive.load(std::memory_order_relaxed);
+		while (NewNumLive > PrevPeak
+			   && !PeakLive.compare_exchange_weak(PrevPeak, NewNumLive, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	void OnFreed()
+	{
+		NumLive.fetch_sub(1, std::memory_order_relaxed);
+	}
+};
+
+FGlobalPool& GetGlobalPool()
+{
+	// Intentionally leaked, thread caches may be flushed after static destruction has started
+	static FGlobalPool* const GlobalPool = new FGlobalPool;
+	return *GlobalPool;
+}
+
+struct FThreadCache
+{
+	FFreeList FreeLists[NumSizeClasses];
+
+	~FThreadCache()
+	{
+		FGlobalPool& GlobalPool = GetGlobalPool();
+		FScopeLock Lock{&GlobalPool.Mutex};
+
+		for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+		{
+			FreeLists[SizeClass].TransferTo(GlobalPool.Overflow[SizeClass], MAX_int32);
+		}
+	}
+};
+
+thread_local FThreadCache ThreadCache;
+
+int32 GetSizeClass(const SIZE_T Size)
+{
+	return static_cast<int32>((FMath::Max<SIZE_T>(Size, 1) - 1) / SizeClassGranularity);
+}
+
+SIZE_T GetBlockSize(const int32 SizeClass)
+{
+	return (SizeClass + 1) * SizeClassGranularity;
+}
+
+}  // namespace
+
+void* Allocate(const SIZE_T Size)
+{
+	FGlobalPool& GlobalPool = GetGlobalPool();
+
+	if (Size > MaxPooledSize)
+	{
+		GlobalPool.OnAllocated(false);
+		return FMemory::Malloc(Size, BlockAlignment);
+	}
+
+	const int32 SizeClass = GetSizeClass(Size);
+	FFreeList& FreeList = ThreadCache.FreeLists[SizeClass];
+
+	if (FreeList.Head == nullptr)
+	{
+		FScopeLock Lock{&GlobalPool.Mutex};
+		GlobalPool.Overflow[SizeClass].TransferTo(FreeList, TransferBatchSize);
+	}
+
+	if (FreeList.Head == nullptr)
+	{
+		GlobalPool.OnAllocated(false);
+		return FMemory::Malloc(GetBlockSize(SizeClass), BlockAlignment);
+	}
+
+	GlobalPool.OnAllocated(true);
+	return FreeList.Pop();
+}
+
+void Free(void* const Ptr, const SIZE_T Size)
+{
+	ZKZ_RETURN_IF(Ptr == nullptr);
+
+	FGlobalPool& GlobalPool = GetGlobalPool();
+	GlobalPool.OnFreed();
+
+	if (Size > MaxPooledSize)
+	{
+		FMemory::Free(Ptr);
+		return;
+	}
+
+	FFreeList& FreeList = ThreadCache.FreeLists[GetSizeClass(Size)];
+	FreeList.Push(new (Ptr) FFreeBlock);
+
+	if (FreeList.Num > MaxThreadCacheBlocks)
+	{
+		FScopeLock Lock{&GlobalPool.Mutex};
+		FreeList.TransferTo(GlobalPool.Overflow[GetSizeClass(Size)], TransferBatchSize);
+	}
+}
+
+FStats GetStats()
+{
+	const FGlobalPool& GlobalPool = GetGlobalPool();
+
+	FStats Stats;
+	Stats.NumHits = GlobalPool.NumHits.load(std::memory_order_relaxed);
+	Stats.NumMisses = GlobalPool.NumMisses.load(std::memory_order_relaxed);
+	Stats.NumLive = GlobalPool.NumLive.load(std::memory_order_relaxed);
+	Stats.PeakLive = GlobalPool.PeakLive.load(std::memory_order_relaxed);
+	return Stats;
+}
+
+}  // namespace Zkz::SmallObjectPool
@@ -0,0 +1,345 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/TimerWheel.h"
+
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Zakazane/ReturnIfMacros.h"
+
+#include <atomic>
+
+namespace Zkz
+{
+
+namespace TimerWheelPrivate
+{
+
+constexpr uint64 SlotMask = FTimerWheel::NumSlots - 1;
+
+/// Number of ticks covered by all levels of the wheel
+constexpr uint64 WheelSpan = uint64{1} << (FTimerWheel::SlotBits * FTimerWheel::NumLevels);
+
+/// Ticks the wheel it's given according to real time
+class FTickThread final : public FRunnable
+{
+public:
+	explicit FTickThread(FTimerWheel& InWheel)
+		: Wheel{InWheel}, WakeUpEvent{FPlatformProcess::GetSynchEventFromPool()}
+	{
+	}
+
+	virtual ~FTickThread() override
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeUpEvent);
+	}
+
+	virtual uint32 Run() override
+	{
+		const double TickSeconds = Wheel.GetTickInterval().GetTotalSeconds();
+		const double StartSeconds = FPlatformTime::Seconds();
+		int64 NumTicksDone = 0;
+
+		while (!bStopRequested.load(std::memory_order_relaxed))
+		{
+			WakeUpEvent->Wait(Wheel.GetTickInterval());
+
+			// Catches up if the thread was not scheduled in time, so timers never fire late by more than a tick
+			const int64 NumTicksDue = static_cast<int64>((FPlatformTime::Seconds() - StartSeconds) / TickSeconds);
+			Wheel.Tick(NumTicksDue - NumTicksDone);
+			NumTicksDone = NumTicksDue;
+		}
+
+		return 0;
+	}
+
+	virtual void Stop() override
+	{
+		bStopRequested = true;
+		WakeUpEvent->Trigger();
+	}
+
+private:
+	FTimerWheel& Wheel;
+	FEvent* const WakeUpEvent;
+	std::atomic<bool> bStopRequested{false};
+};
+
+struct FSharedTimerWheel
+{
+	const TSharedRef<FTimerWheel, ESPMode::ThreadSafe> Wheel = MakeShared<FTimerWheel, ESPMode::ThreadSafe>();
+	FTickThread TickThread{*Wheel};
+	TUniquePtr<FRunnableThread> Thread;
+
+	FSharedTimerWheel()
+	{
+		Thread.Reset(FRunnableThread::Create(&TickThread, TEXT("ZkzTimerWheel"), 0, TPri_AboveNormal));
+	}
+
+	~FSharedTimerWheel()
+	{
+		if (Thread.IsValid())
+		{
+			Thread->Kill(true);
+		}
+	}
+};
+
+FCriticalSection SharedTimerWheelMutex;
+TUniquePtr<FSharedTimerWheel> SharedTimerWheel;
+bool bSharedTimerWheelShutDown = false;
+
+}  // namespace TimerWheelPrivate
+
+FTimerWheel::FTimerWheel(const FTimespan InTickInterval) : TickInterval{InTickInterval}
+{
+	check(TickInterval > FTimespan::Zero());
+
+	for (int32& SlotHead : SlotHeads)
+	{
+		SlotHead = INDEX_NONE;
+	}
+}
+
+FTimerWheel::~FTimerWheel()
+{
+	// Callbacks may own objects which call back into the wheel when destroyed
+	TArray<TUniqueFunction<void()>> DiscardedCallbacks;
+
+	{
+		FScopeLock Lock{&Mutex};
+
+		for (FTimer& Timer : Timers)
+		{
+			if (Timer.Callback)
+			{
+				DiscardedCallbacks.Emplace(MoveTemp(Timer.Callback));
+			}
+		}
+	}
+}
+
+FTimerWheelHandle FTimerWheel::Schedule(const FTimespan Delay, TUniqueFunction<void()> Callback)
+{
+	const uint64 DelayTicks = FMath::Max<int64>(1, FMath::DivideAndRoundUp(Delay.GetTicks(), TickInterval.GetTicks()));
+
+	FScopeLock Lock{&Mutex};
+
+	const int32 TimerIdx = AllocateTimer();
+	FTimer& Timer = Timers[TimerIdx];
+	Timer.Callback = MoveTemp(Callback);
+	Timer.ExpiryTick = CurrentTick + DelayTicks;
+
+	Link(TimerIdx);
+	++NumPending;
+
+	return {TimerIdx, Timer.Generation};
+}
+
+bool FTimerWheel::Cancel(const FTimerWheelHandle Handle)
+{
+	TUniqueFunction<void()> DiscardedCallback;
+
+	{
+		FScopeLock Lock{&Mutex};
+
+		ZKZ_RETURN_IF(!Timers.IsValidIndex(Handle.Index), false);
+
+		FTimer& Timer = Timers[Handle.Index];
+		ZKZ_RETURN_IF(Timer.Generation != Handle.Generation || Timer.SlotIdx == INDEX_NONE, false);
+
+		DiscardedCallback = MoveTemp(Timer.Callback);
+		Unlink(Handle.Index);
+		FreeTimer(Handle.Index);
+		--NumPending;
+	}
+
+	return true;
+}
+
+void FTimerWheel::Tick(const int64 NumTicks)
+{
+	TArray<TUniqueFunction<void()>> ExpiredCallbacks;
+
+	for (int64 TickIdx = 0; TickIdx < NumTicks; ++TickIdx)
+	{
+		{
+			FScopeLock Lock{&Mutex};
+			AdvanceTick(ExpiredCallbacks);
+		}
+
+		for (TUniqueFunction<void()>& Callback : ExpiredCallbacks)
+		{
+			Callback();
+		}
+
+		ExpiredCallbacks.Reset();
+	}
+}
+
+int32 FTimerWheel::GetNumPending() const
+{
+	FScopeLock Lock{&Mutex};
+	return NumPending;
+}
+
+TSharedPtr<FTimerWheel, ESPMode::ThreadSafe> FTimerWheel::GetShared()
+{
+	using namespace TimerWheelPrivate;
+
+	FScopeLock Lock{&SharedTimerWheelMutex};
+
+	ZKZ_RETURN_IF(bSharedTimerWheelShutDown, nullptr);
+
+	if (!SharedTimerWheel.IsValid())
+	{
+		SharedTimerWheel = MakeUnique<FSharedTimerWheel>();
+	}
+
+	return SharedTimerWheel->Wheel;
+}
+
+void FTimerWheel::ShutdownShared()
+{
+	using namespace TimerWheelPrivate;
+
+	TUniquePtr<FSharedTimerWheel> ShutdownTimerWheel;
+
+	{
+		FScopeLock Lock{&SharedTimerWheelMutex};
+		ShutdownTimerWheel = MoveTemp(SharedTimerWheel);
+		bSharedTimerWheelShutDown = true;
+	}
+}
+
+int32 FTimerWheel::AllocateTimer()
+{
+	if (FirstFreeTimer == INDEX_NONE)
+	{
+		return Timers.AddDefaulted();
+	}
+
+	const int32 TimerIdx = FirstFreeTimer;
+	FirstFreeTimer = Timers[TimerIdx].Next;
+	Timers[TimerIdx].Next = INDEX_NONE;
+	return TimerIdx;
+}
+
+void FTimerWheel::FreeTimer(const int32 TimerIdx)
+{
+	FTimer& Timer = Timers[TimerIdx];
+	++Timer.Generation;
+	Timer.SlotIdx = INDEX_NONE;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = FirstFreeTimer;
+	FirstFreeTimer = TimerIdx;
+}
+
+void FTimerWheel::Link(const int32 TimerIdx)
+{
+	using namespace TimerWheelPrivate;
+
+	FTimer& Timer = Timers[TimerIdx];
+	check(Timer.ExpiryTick >= CurrentTick);
+
+	// Timers further away than the wheel span wait in the top level and get reinserted when their slot cascades
+	const uint64 ClampedExpiryTick = FMath::Min(Timer.ExpiryTick, CurrentTick + WheelSpan - 1);
+	const uint64 Delta = ClampedExpiryTick - CurrentTick;
+
+	int32 Level = 0;
+	while (Level < NumLevels - 1 && Delta >= (uint64{1} << (SlotBits * (Level + 1))))
+	{
+		++Level;
+	}
+
+	const int32 Slot = static_cast<int32>((ClampedExpiryTick >> (SlotBits * Level)) & SlotMask);
+	const int32 SlotIdx = Level * NumSlots + Slot;
+
+	Timer.SlotIdx = SlotIdx;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = SlotHeads[SlotIdx];
+
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = TimerIdx;
+	}
+
+	SlotHeads[SlotIdx] = TimerIdx;
+}
+
+void FTimerWheel::Unlink(const int32 TimerIdx)
+{
+	FTimer& Timer = Timers[TimerIdx];
+
+	if (Timer.Prev != INDEX_NONE)
+	{
+		Timers[Timer.Prev].Next = Timer.Next;
+	}
+	else
+	{
+		SlotHeads[Timer.SlotIdx] = Timer.Next;
+	}
+
+	if (Timer.Next != INDEX_NONE)
+	{
+		Timers[Timer.Next].Prev = Timer.Prev;
+	}
+
+	Timer.SlotIdx = INDEX_NONE;
+	Timer.Prev = INDEX_NONE;
+	Timer.Next = INDEX_NONE;
+}
+
+void FTimerWheel::Cascade(const int32 Level)
+{
+	using namespace TimerWheelPrivate;
+
+	const int32 SlotIdx = Level * NumSlots + static_cast<int32>((CurrentTick >> (SlotBits * Level)) & SlotMask);
+
+	int32 TimerIdx = SlotHeads[SlotIdx];
+	SlotHeads[SlotIdx] = INDEX_NONE;
+
+	while (TimerIdx != INDEX_NONE)
+	{
+		const int32 NextTimerIdx = Timers[TimerIdx].Next;
+		Link(TimerIdx);
+		TimerIdx = NextTimerIdx;
+	}
+}
+
+void FTimerWheel::AdvanceTick(TArray<TUniqueFunction<void()>>& OutCallbacks)
+{
+	using namespace TimerWheelPrivate;
+
+	++CurrentTick;
+
+	// A level's slot cascades when all the levels below it wrap around
+	for (int32 Level = 1; Level < NumLevels; ++Level)
+	{
+		if ((CurrentTick & ((uint64{1} << (SlotBits * Level)) - 1)) != 0)
+		{
+			break;
+		}
+
+		Cascade(Level);
+	}
+
+	const int32 SlotIdx = static_cast<int32>(CurrentTick & SlotMask);
+
+	int32 TimerIdx = SlotHeads[SlotIdx];
+	SlotHeads[SlotIdx] = INDEX_NONE;
+
+	while (TimerIdx != INDEX_NONE)
+	{
+		FTimer& Timer = Timers[TimerIdx];
+		const int32 NextTimerIdx = Timer.Next;
+
+		check(Timer.ExpiryTick == CurrentTick);
+		OutCallbacks.Emplace(MoveTemp(Timer.Callback));
+		FreeTimer(TimerIdx);
+		--NumPending;
+
+		TimerIdx = NextTimerIdx;
+	}
+}
+
+}  // namespace Zkz
@@ -0,0 +1,66 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#include "Zakazane/Trampoline.h"
+
+namespace Zkz::Trampoline::Private
+{
+
+struct FThreadState
+{
+	int32 Depth = 0;
+	TArray<TUniqueFunction<void()>> Queue;
+	int32 QueueHead = 0;
+};
+
+thread_local FThreadState ThreadState;
+
+bool ShouldDefer()
+{
+	return ThreadState.Depth >= MaxInlineDepth;
+}
+
+void Enqueue(TUniqueFunction<void()>&& Function)
+{
+	check(ThreadState.Depth > 0);
+	ThreadState.Queue.Emplace(MoveTemp(Function));
+}
+
+void BeginRun()
+{
+	check(ThreadState.Depth < MaxInlineDepth);
+	++ThreadState.Depth;
+}
+
+void EndRun()
+{
+	FThreadState& State = ThreadState;
+	check(State.Depth > 0);
+
+	if (State.Depth > 1)
+	{
+		--State.Depth;
+		return;
+	}
+
+	// Queued functions run at the depth of the outermost call, so their own nested calls are inlined again
+	while (State.QueueHead < State.Queue.Num())
+	{
+		// The function may enqueue more functions, which can reallocate the queue
+		TUniqueFunction<void()> Function = MoveTemp(State.Queue[State.QueueHead++]);
+
+		if (State.QueueHead == State.Queue.Num())
+		{
+			// Keeps the queue small for long chains, where each function enqueues the next one
+			State.Queue.Reset();
+			State.QueueHead = 0;
+		}
+
+		Function();
+	}
+
+	State.Queue.Reset();
+	State.QueueHead = 0;
+	State.Depth = 0;
+}
+
+}  // namespace Zkz::Trampoline::Private
@@ -2,6 +2,8 @@
 
 #include "ZakazaneUtilities.h"
 
+#include "Zakazane/TimerWheel.h"
+
 #define LOCTEXT_NAMESPACE "FZakazaneUtilitiesModule"
 
 void FZakazaneUtilitiesModule::StartupModule()
@@ -13,6 +15,8 @@ void FZakazaneUtilitiesModule::ShutdownModule()
 {
 	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
 	// we call this function before unloading the module.
+
+	Zkz::FTimerWheel::ShutdownShared();
 }
 
 #undef LOCTEXT_NAMESPACE
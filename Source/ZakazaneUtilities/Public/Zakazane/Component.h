@@ -4,13 +4,19 @@
 
 #include "CoreMinimal.h"
 
+#include "Algo/Reverse.h"
 #include "GameFramework/Actor.h"
 #include "Templates/IsInvocable.h"
 #include "Templates/SubclassOf.h"
+#include "Zakazane/ComponentEvents.h"
 #include "Zakazane/ContinueIfMacros.h"
+#include "Zakazane/Delegate.h"
 #include "Zakazane/ReturnIfMacros.h"
 
+class UBlueprint;
 class USCS_Node;
+class USubobjectDataSubsystem;
+struct FSubobjectDataHandle;
 
 namespace Zkz
 {
@@ -20,6 +26,60 @@ namespace ComponentPrivate
 
 ZAKAZANEUTILITIES_API USCS_Node* FindCorrespondingSCSNode(const USceneComponent& SceneComponent);
 
+/// Component hierarchy of an archetype, gathered from the class' construction scripts or default subobjects
+struct FArchetypeComponents
+{
+	using FCompsByParent = TMultiMap<TWeakObjectPtr<UActorComponent>, TWeakObjectPtr<UActorComponent>>;
+	using FCompsByChild = TMap<TWeakObjectPtr<UActorComponent>, TWeakObjectPtr<UActorComponent>>;
+	using FCompsByName = TMap<FName, TWeakObjectPtr<UActorComponent>>;
+	using FNamesByComp = TMap<TWeakObjectPtr<UActorComponent>, FName>;
+
+	FCompsByParent CompsByParent;
+	FCompsByChild CompsByChild;
+	FCompsByName CompsByName;
+	/// Inverse of CompsByName, so removed components, which may have been renamed already, are found without a scan
+	FNamesByComp NamesByComp;
+
+	/// Whether the components come from a blueprint generated class, see FComponentHierarchy::ComponentsMutable
+	bool bBlueprintComponents = false;
+};
+
+/// Pending component on the explicit stack of FComponentHierarchy::VisitComponentsInSubtree
+struct FSubtreeTraversalEntry
+{
+	UActorComponent* Component;
+	/// Only used in suffix traversal, where components are visited once their children have been
+	bool bChildrenPushed;
+};
+
+/// Enough for most hierarchies, deeper or wider ones spill over to the heap
+constexpr int32 NumInlineSubtreeTraversalEntries = 32;
+
+#if WITH_EDITOR
+/// Number of Editor::FSubobjectEditBatch objects open on a hierarchy, which must be gone before the hierarchy is.
+/// Copies of a hierarchy start with no batches.
+struct FOpenEditBatchCounter
+{
+	int32 Num = 0;
+
+	FOpenEditBatchCounter() = default;
+
+	FOpenEditBatchCounter(const FOpenEditBatchCounter&)
+	{
+	}
+
+	FOpenEditBatchCounter& operator=(const FOpenEditBatchCounter&)
+	{
+		return *this;
+	}
+
+	~FOpenEditBatchCounter()
+	{
+		ensureAlwaysMsgf(Num == 0, TEXT("Component hierarchy destroyed while a subobject edit batch is open on it"));
+	}
+};
+#endif
+
 }  // namespace ComponentPrivate
 
 ZAKAZANEUTILITIES_API FString GetComponentNameNoSuffix(FName ComponentName);
@@ -44,6 +104,8 @@ enum class EMarkBlueprintAsStructurallyModified
 	Enabled,
 };
 
+class FSubobjectEditBatch;
+
 }  // namespace Editor
 #endif
 
@@ -60,6 +122,16 @@ enum class EForEachComponentRecursionType
 	Suffix,
 };
 
+/// Returned by functors passed to FComponentHierarchy::VisitComponentsInSubtree
+enum class EComponentVisitResult
+{
+	Continue,
+	/// Don't visit the descendants of the current component. Ignored in suffix traversal, where they've been visited.
+	SkipDescendants,
+	/// Don't visit any more components
+	Stop,
+};
+
 enum class EForEachComponentAttachedActorsRecursionType
 {
 	NotRecursive,
@@ -127,6 +199,22 @@ public:
 	void ForEachComponentInSubtree(
 		const UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const;
 
+	/// Like ForEachComponentInSubtree, but Func returns an EComponentVisitResult, which allows skipping descendants
+	/// and stopping the traversal early with any RecursionType (PrefixCond behaves like Prefix).
+	/// The traversal is iterative, with an explicit stack, so it doesn't allocate unless the hierarchy is very large.
+	/// @returns false if the traversal was stopped by Func
+	template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
+	bool VisitComponentsInSubtree(
+		UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const;
+
+	/// Like ForEachComponentInSubtree, but Func returns an EComponentVisitResult, which allows skipping descendants
+	/// and stopping the traversal early with any RecursionType (PrefixCond behaves like Prefix).
+	/// The traversal is iterative, with an explicit stack, so it doesn't allocate unless the hierarchy is very large.
+	/// @returns false if the traversal was stopped by Func
+	template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
+	bool VisitComponentsInSubtree(
+		const UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const;
+
 	const UActorComponent* FindComponentByName(FName Name) const;
 
 #if WITH_EDITOR
@@ -171,6 +259,12 @@ public:
 		const TArray<const UActorComponent*>& Comps,
 		Editor::EMarkBlueprintAsStructurallyModified MarkBlueprintAsStructurallyModified =
 			Editor::EMarkBlueprintAsStructurallyModified::Enabled);
+
+	/// Hierarchies of archetypes are gathered once per class and shared between all FComponentHierarchy objects
+	/// constructed for that class, until a blueprint is compiled or objects are reinstanced. Subobjects added or
+	/// removed through FComponentHierarchy also invalidate the cache. Changes made in any other way require calling
+	/// this function.
+	static void InvalidateArchetypeCache();
 #endif
 
 	/// Whether the components in the hierarchy are mutable, or const-only. If false, ForEachChildComponent will only
@@ -181,29 +275,91 @@ public:
 	/// subobjects implemented in c++ are not.
 	bool ComponentsMutable() const;
 
+protected:
+#if WITH_EDITOR
+	/// Patch the archetype data after a component event, @see FLiveComponentHierarchy. Events about components of
+	/// other classes are ignored.
+	void PatchAddedArchetypeComponent(UActorComponent& Component);
+	void PatchRemovedArchetypeComponent(const UActorComponent& Component);
+	void PatchArchetypeAttachment(UActorComponent& Component);
+#endif
+
 private:
-	using FCompsByParent = TMultiMap<TWeakObjectPtr<UActorComponent>, TWeakObjectPtr<UActorComponent>>;
-	using FCompsByChild = TMap<TWeakObjectPtr<UActorComponent>, TWeakObjectPtr<UActorComponent>>;
-	using FCompsByName = TMap<FName, TWeakObjectPtr<UActorComponent>>;
+#if WITH_EDITOR
+	friend class Editor::FSubobjectEditBatch;
+#endif
+
+	using FArchetypeComponentsPtr = TSharedPtr<ComponentPrivate::FArchetypeComponents, ESPMode::ThreadSafe>;
 
 	TWeakObjectPtr<AActor> Actor;
 
-	FCompsByParent CompsByParent;
-	FCompsByChild CompsByChild;
-	FCompsByName CompsByName;
+	/// Only set for archetypes. Shared with the archetype cache and other hierarchies, so must not be modified
+	/// in place, @see GetMutableArchetypeComponents
+	FArchetypeComponentsPtr ArchetypeComponents;
 
 	/// @see ComponentsMutable
 	bool bComponentsMutable = false;
 
+#if WITH_EDITOR
+	ComponentPrivate::FOpenEditBatchCounter OpenEditBatches;
+#endif
+
 	void ConstructFromActor(AActor& InActor, const bool bAllowMutableComponents);
 
 #if WITH_EDITOR
 	void ConstructHierarchyFromCDO(const TSubclassOf<AActor>& ActorClass);
+
+	/// Copies the shared archetype components if anything else references them and invalidates the cache for the class
+	ComponentPrivate::FArchetypeComponents& GetMutableArchetypeComponents();
+
+	enum class EArchetypeChangeScope
+	{
+		/// The component isn't part of this hierarchy
+		None,
+		/// The component belongs to the class of this hierarchy, so the change can be patched in
+		Patch,
+		/// The component belongs to a superclass. Subclasses see their own copies of inherited components, so the
+		/// hierarchy is regathered instead.
+		Regather,
+	};
+
+	EArchetypeChangeScope GetArchetypeChangeScope(const UActorComponent& Component) const;
+
+	/// Regathers the hierarchy after a change to a superclass, @see EArchetypeChangeScope
+	void RegatherArchetypeComponents(const UActorComponent& ChangedComponent);
 #endif
 
+	/// Returns an empty hierarchy for instanced actors
+	const ComponentPrivate::FArchetypeComponents& GetArchetypeComponents() const;
+
 	UActorComponent* InternalFindParent(const UActorComponent& Child) const;
 };
 
+/// FComponentHierarchy which patches itself on component events (@see ComponentEvents) instead of going stale, for
+/// tools and systems which keep hierarchies alive. A change to the class of the hierarchy is patched in place, in time
+/// proportional to the number of children of the changed component. On top of that, each change drops the class from
+/// the archetype cache, which is linear in the number of cached classes, and the first change after the hierarchy data
+/// was shared with the cache copies it.
+/// Only archetype hierarchies store any data - hierarchies of instanced actors read the actor on each call, so they
+/// never go stale.
+/// Not copyable, as it's bound to the events.
+class ZAKAZANEUTILITIES_API FLiveComponentHierarchy : public FComponentHierarchy
+{
+public:
+	explicit FLiveComponentHierarchy(const AActor& InActor);
+	explicit FLiveComponentHierarchy(AActor& InActor, const bool bAllowMutableComponents = true);
+
+	FLiveComponentHierarchy(const FLiveComponentHierarchy&) = delete;
+	FLiveComponentHierarchy& operator=(const FLiveComponentHierarchy&) = delete;
+
+private:
+	TScopedDelegateHandle<ComponentEvents::FOnComponentEvent> OnComponentAddedHandle;
+	TScopedDelegateHandle<ComponentEvents::FOnComponentEvent> OnComponentRemovedHandle;
+	TScopedDelegateHandle<ComponentEvents::FOnComponentEvent> OnAttachmentChangedHandle;
+
+	void BindToComponentEvents(const AActor& InActor);
+};
+
 /// This function works both for instanced components and archetypes (components in blueprints). For instanced components
 /// returns owner, for archetype components returns default object of class generated by blueprint.
 ZAKAZANEUTILITIES_API AActor* GetOwner(const USceneComponent& SceneComp);
@@ -243,11 +399,14 @@ void ForEachDescendant(SceneComponentType& ParentComp, FuncType&& Func, Addition
 		Forward<AdditionalArgTypes>(AdditionalArgs)...);
 }
 
-ZAKAZANEUTILITIES_API UActorComponent* FindComponentInSubtree(
-	UActorComponent& RootComp, const TFunction<bool(const UActorComponent&)>& Predicate);
-ZAKAZANEUTILITIES_API const UActorComponent* FindComponentInSubtree(
-	const UActorComponent& RootComp, const TFunction<bool(const UActorComponent&)>& Predicate);
+/// Returns the first component in prefix order in the subtree of RootComp (including RootComp) for which
+/// Predicate(const UActorComponent&) returns true.
+template <class PredicateType>
+UActorComponent* FindComponentInSubtree(UActorComponent& RootComp, PredicateType&& Predicate);
+template <class PredicateType>
+const UActorComponent* FindComponentInSubtree(const UActorComponent& RootComp, PredicateType&& Predicate);
 
+/// Walks the subtree on each call. For repeated lookups, see FComponentHierarchySnapshot::FindIndexInSubtreeByName.
 ZAKAZANEUTILITIES_API UActorComponent* FindComponentInSubtreeByName(UActorComponent& RootComp, const FName& Name);
 ZAKAZANEUTILITIES_API const UActorComponent* FindComponentInSubtreeByName(
 	const UActorComponent& RootComp, const FName& Name);
@@ -276,6 +435,88 @@ ZAKAZANEUTILITIES_API int32 RemoveSubobject(
 	EMarkBlueprintAsStructurallyModified MarkBlueprintAsStructurallyModified =
 		EMarkBlueprintAsStructurallyModified::Enabled);
 
+/// Collects subobject additions and removals on a default object and applies them in one pass on Commit (or
+/// destruction): the subobject data is gathered once and the blueprint is marked as structurally modified once, instead
+/// of once per operation. Additions are applied in the order they were queued, then removals.
+/// Components added by the batch are only available after Commit, @see GetAddedComponent.
+/// The batch refers to the hierarchy and commits on destruction, so it must be a local scoped within the lifetime of
+/// the hierarchy. It can't be copied, moved or allocated on the heap, and destroying the hierarchy first ensures.
+class ZAKAZANEUTILITIES_API FSubobjectEditBatch
+{
+public:
+	/// Identifies a queued addition. Can be used as the parent of additions queued later in the same batch.
+	using FAddId = int32;
+
+	explicit FSubobjectEditBatch(
+		FComponentHierarchy& InHierarchy,
+		EMarkBlueprintAsStructurallyModified InMarkBlueprintAsStructurallyModified =
+			EMarkBlueprintAsStructurallyModified::Enabled);
+	~FSubobjectEditBatch();
+
+	FSubobjectEditBatch(const FSubobjectEditBatch&) = delete;
+	FSubobjectEditBatch& operator=(const FSubobjectEditBatch&) = delete;
+
+	static void* operator new(size_t) = delete;
+	static void* operator new[](size_t) = delete;
+
+	/// Queues adding a new subobject under ParentComp, or as a root if ParentComp is null.
+	/// @returns INDEX_NONE if Class isn't a component class
+	FAddId AddNewSubobject(UClass& Class, UActorComponent* ParentComp, const FName& Name);
+
+	/// Queues adding a new subobject under a subobject added earlier in this batch.
+	FAddId AddNewSubobject(UClass& Class, FAddId ParentAddId, const FName& Name);
+
+	/// Queues removing a subobject.
+	void RemoveSubobject(const UActorComponent& Comp);
+
+	/// Applies all queued edits. Edits queued afterwards are applied by the next Commit. If the default object can't
+	/// be edited (e.g. the hierarchy isn't mutable or the blueprint is gone), nothing is applied and the edits stay
+	/// queued, until they're dropped on destruction.
+	void Commit();
+
+	/// Returns the component created for the given addition, or null if it wasn't committed yet or failed.
+	UActorComponent* GetAddedComponent(FAddId AddId) const;
+
+	/// Returns the number of objects removed by all commits so far.
+	int32 GetNumRemoved() const
+	{
+		return NumRemoved;
+	}
+
+private:
+	struct FQueuedAdd
+	{
+		UClass* Class = nullptr;
+		TWeakObjectPtr<UActorComponent> ParentComp;
+		FAddId ParentAddId = INDEX_NONE;
+		FName Name;
+		TWeakObjectPtr<UActorComponent> AddedComp;
+	};
+
+	FComponentHierarchy& Hierarchy;
+	EMarkBlueprintAsStructurallyModified MarkBlueprintAsStructurallyModified;
+
+	TArray<FQueuedAdd> QueuedAdds;
+	int32 NumCommittedAdds = 0;
+	TArray<TWeakObjectPtr<const UActorComponent>> QueuedRemoves;
+	int32 NumRemoved = 0;
+
+	UActorComponent* ApplyAdd(
+		FQueuedAdd& Add,
+		USubobjectDataSubsystem& SubobjectDataSubsystem,
+		UBlueprint& Blueprint,
+		const FSubobjectDataHandle& OwnerDataHandle,
+		TArray<FSubobjectDataHandle>& SubobjectDataHandles);
+
+	int32 ApplyRemoves(
+		const TArray<TWeakObjectPtr<const UActorComponent>>& Removes,
+		TArray<UActorComponent*>& OutRemovedComps,
+		USubobjectDataSubsystem& SubobjectDataSubsystem,
+		UBlueprint& Blueprint,
+		const FSubobjectDataHandle& OwnerDataHandle,
+		const TArray<FSubobjectDataHandle>& SubobjectDataHandles);
+};
+
 }  // namespace Editor
 #endif
 
@@ -304,7 +545,7 @@ void FComponentHierarchy::ForEachComponent(FuncType&& Func, AdditionalArgTypes&&
 
 	if (ActorPtr->HasAllFlags(RF_ArchetypeObject))
 	{
-		for (const auto& [WeakParent, WeakComp] : CompsByParent)
+		for (const auto& [WeakParent, WeakComp] : GetArchetypeComponents().CompsByParent)
 		{
 			UActorComponent* const Comp = WeakComp.Get();
 			ZKZ_CONTINUE_IF_INVALID(Comp);
@@ -365,7 +606,7 @@ void FComponentHierarchy::ForEachChildComponent(
 
 	if (Component.HasAllFlags(RF_ArchetypeObject))
 	{
-		for (auto It = CompsByParent.CreateConstKeyIterator(&Component); It; ++It)
+		for (auto It = GetArchetypeComponents().CompsByParent.CreateConstKeyIterator(&Component); It; ++It)
 		{
 			UActorComponent* const CompPtr = It->Value.Get();
 			ZKZ_CONTINUE_IF_INVALID(CompPtr);
@@ -408,7 +649,7 @@ void FComponentHierarchy::ForEachRootComponent(FuncType&& Func, AdditionalArgTyp
 
 	if (Actor->HasAllFlags(RF_ArchetypeObject))
 	{
-		for (auto It = CompsByParent.CreateConstKeyIterator(nullptr); It; ++It)
+		for (auto It = GetArchetypeComponents().CompsByParent.CreateConstKeyIterator(nullptr); It; ++It)
 		{
 			UActorComponent* const CompPtr = It->Value.Get();
 			ZKZ_CONTINUE_IF_INVALID(CompPtr);
@@ -439,6 +680,53 @@ void FComponentHierarchy::ForEachRootComponent(FuncType&& Func, AdditionalArgTyp
 template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
 void FComponentHierarchy::ForEachComponentInSubtree(
 	UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const
+{
+	constexpr bool bIsConstInvocable = TIsInvocable<FuncType, const UActorComponent&, AdditionalArgTypes...>::Value;
+	constexpr bool bIsNonConstInvocable = TIsInvocable<FuncType, UActorComponent&, AdditionalArgTypes...>::Value;
+	static_assert(
+		bIsConstInvocable || bIsNonConstInvocable,
+		"Invalid functor signature. Expected functor taking a [const] UActorComponent, AdditionalArgTypes...");
+
+	using ComponentType = std::conditional_t<bIsConstInvocable, const UActorComponent, UActorComponent>;
+	VisitComponentsInSubtree<RecursionType>(
+		RootComp,
+		[&](ComponentType& Component)
+		{
+			if constexpr (RecursionType == EForEachComponentRecursionType::PrefixCond)
+			{
+				static_assert(
+					std::is_convertible_v<TInvokeResult_T<FuncType, ComponentType&, AdditionalArgTypes...>, bool>,
+					"PrefixCond recursion type expects functor to return a type convertible to bool");
+
+				const bool bContinue = ::Invoke(Func, Component, AdditionalArgs...);
+				return bContinue ? EComponentVisitResult::Continue : EComponentVisitResult::SkipDescendants;
+			}
+			else
+			{
+				::Invoke(Func, Component, AdditionalArgs...);
+				return EComponentVisitResult::Continue;
+			}
+		});
+}
+
+template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
+void FComponentHierarchy::ForEachComponentInSubtree(
+	const UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const
+{
+	constexpr bool bIsConstInvocable = TIsInvocable<FuncType, const UActorComponent&, AdditionalArgTypes...>::Value;
+	static_assert(
+		bIsConstInvocable,
+		"Invalid functor signature. Expected functor taking a const UActorComponent, AdditionalArgTypes...");
+
+	ForEachComponentInSubtree<RecursionType>(
+		const_cast<UActorComponent&>(RootComp),
+		Forward<FuncType>(Func),
+		Forward<AdditionalArgTypes>(AdditionalArgs)...);
+}
+
+template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
+bool FComponentHierarchy::VisitComponentsInSubtree(
+	UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const
 {
 	using namespace ComponentPrivate;
 
@@ -448,48 +736,77 @@ void FComponentHierarchy::ForEachComponentInSubtree(
 		bIsConstInvocable || bIsNonConstInvocable,
 		"Invalid functor signature. Expected functor taking a [const] UActorComponent, AdditionalArgTypes...");
 
-	// If Suffix - we'll call for root at end of function. Otherwise, call now (non-recursive will also call at this point).
-	if constexpr (RecursionType != EForEachComponentRecursionType::Suffix)
+	using ComponentType = std::conditional_t<bIsConstInvocable, const UActorComponent, UActorComponent>;
+	static_assert(
+		std::is_same_v<TInvokeResult_T<FuncType, ComponentType&, AdditionalArgTypes...>, EComponentVisitResult>,
+		"Invalid functor signature. Expected functor returning EComponentVisitResult");
+
+	if constexpr (RecursionType == EForEachComponentRecursionType::NotRecursive)
+	{
+		return ::Invoke(Func, RootComp, AdditionalArgs...) != EComponentVisitResult::Stop;
+	}
+	else
 	{
-		if constexpr (RecursionType == EForEachComponentRecursionType::PrefixCond)
+		// Same as in ForEachChildComponent - only the root is visited if non-const components can't be given out
+		const bool bCanDescend = bIsConstInvocable || ComponentsMutable();
+		ensureAlwaysMsgf(
+			bCanDescend,
+			TEXT("VisitComponentsInSubtree called with functor taking non-const components for an immutable "
+				 "hierarchy"));
+
+		TArray<FSubtreeTraversalEntry, TInlineAllocator<NumInlineSubtreeTraversalEntries>> Stack;
+		Stack.Add({&RootComp, false});
+
+		const auto PushChildComponents = [this, &Stack](const UActorComponent& Component)
 		{
-			static_assert(
-				std::is_convertible_v<TInvokeResult_T<FuncType, USceneComponent&, AdditionalArgTypes...>, bool>,
-				"PrefixCond recursion type expects functor to return a type convertible to bool");
+			const int32 FirstChildIdx = Stack.Num();
 
-			const bool bContinue = ::Invoke(Func, RootComp, AdditionalArgs...);
-			if (!bContinue)
-			{
-				return;
-			}
-		}
-		else
+			// This const cast is fine - non-const components are only given out if bCanDescend is true
+			ForEachChildComponent(
+				Component,
+				[&Stack](const UActorComponent& ChildComponent)
+				{ Stack.Add({const_cast<UActorComponent*>(&ChildComponent), false}); });
+
+			// Reversed, so children are popped in the same order as ForEachChildComponent gives them
+			TArrayView<FSubtreeTraversalEntry> ChildEntries =
+				MakeArrayView(Stack).Slice(FirstChildIdx, Stack.Num() - FirstChildIdx);
+			Algo::Reverse(ChildEntries);
+		};
+
+		while (!Stack.IsEmpty())
 		{
-			::Invoke(Func, RootComp, AdditionalArgs...);
+			const FSubtreeTraversalEntry Entry = Stack.Pop(EAllowShrinking::No);
 
-			if (RecursionType == EForEachComponentRecursionType::NotRecursive)
+			if constexpr (RecursionType == EForEachComponentRecursionType::Suffix)
 			{
-				return;
+				if (bCanDescend && !Entry.bChildrenPushed)
+				{
+					Stack.Add({Entry.Component, true});
+					PushChildComponents(*Entry.Component);
+					continue;
+				}
+
+				const EComponentVisitResult Result = ::Invoke(Func, *Entry.Component, AdditionalArgs...);
+				ZKZ_RETURN_IF(Result == EComponentVisitResult::Stop, false);
 			}
-		}
-	}
+			else
+			{
+				const EComponentVisitResult Result = ::Invoke(Func, *Entry.Component, AdditionalArgs...);
+				ZKZ_RETURN_IF(Result == EComponentVisitResult::Stop, false);
 
-	// Recursively call for children.
-	using ChildComponentType = std::conditional_t<bIsConstInvocable, const UActorComponent, UActorComponent>;
-	ForEachChildComponent(
-		RootComp,
-		[&](ChildComponentType& ChildComponent)
-		{ ForEachComponentInSubtree<RecursionType>(ChildComponent, Func, AdditionalArgs...); });
+				if (bCanDescend && Result == EComponentVisitResult::Continue)
+				{
+					PushChildComponents(*Entry.Component);
+				}
+			}
+		}
 
-	// If Suffix - call function for root now.
-	if constexpr (RecursionType == EForEachComponentRecursionType::Suffix)
-	{
-		::Invoke(Func, RootComp, AdditionalArgs...);
+		return true;
 	}
 }
 
 template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
-void FComponentHierarchy::ForEachComponentInSubtree(
+bool FComponentHierarchy::VisitComponentsInSubtree(
 	const UActorComponent& RootComp, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const
 {
 	constexpr bool bIsConstInvocable = TIsInvocable<FuncType, const UActorComponent&, AdditionalArgTypes...>::Value;
@@ -497,12 +814,42 @@ void FComponentHierarchy::ForEachComponentInSubtree(
 		bIsConstInvocable,
 		"Invalid functor signature. Expected functor taking a const UActorComponent, AdditionalArgTypes...");
 
-	ForEachComponentInSubtree<RecursionType>(
+	return VisitComponentsInSubtree<RecursionType>(
 		const_cast<UActorComponent&>(RootComp),
 		Forward<FuncType>(Func),
 		Forward<AdditionalArgTypes>(AdditionalArgs)...);
 }
 
+template <class PredicateType>
+UActorComponent* FindComponentInSubtree(UActorComponent& RootComp, PredicateType&& Predicate)
+{
+	// This const cast is fine - descendants of a mutable component are reachable through it anyway
+	return const_cast<UActorComponent*>(
+		FindComponentInSubtree(static_cast<const UActorComponent&>(RootComp), Forward<PredicateType>(Predicate)));
+}
+
+template <class PredicateType>
+const UActorComponent* FindComponentInSubtree(const UActorComponent& RootComp, PredicateType&& Predicate)
+{
+	static_assert(
+		std::is_convertible_v<TInvokeResult_T<PredicateType, const UActorComponent&>, bool>,
+		"Invalid predicate signature. Expected predicate taking a const UActorComponent and returning bool");
+
+	const UActorComponent* FoundComp = nullptr;
+
+	FComponentHierarchy{RootComp}.VisitComponentsInSubtree<EForEachComponentRecursionType::Prefix>(
+		RootComp,
+		[&FoundComp, &Predicate](const UActorComponent& Comp)
+		{
+			ZKZ_RETURN_IF(!::Invoke(Predicate, Comp), EComponentVisitResult::Continue);
+
+			FoundComp = &Comp;
+			return EComponentVisitResult::Stop;
+		});
+
+	return FoundComp;
+}
+
 #if WITH_EDITOR
 template <class T>
 T* FComponentHierarchy::AddNewSubobject(
@@ -0,0 +1,30 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// Hub of component structure change events, for systems which keep derived data about component hierarchies
+/// (@see FLiveComponentHierarchy, UZkzComponentIndexSubsystem) and want to patch it instead of rebuilding it.
+/// Registration and unregistration of instanced components are forwarded from the engine. Archetype components added
+/// and removed through FComponentHierarchy are broadcast by it. Attachment changes aren't broadcast by the engine, so
+/// code changing attachment of components which may be tracked should call BroadcastAttachmentChanged.
+/// Game thread only.
+namespace Zkz::ComponentEvents
+{
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnComponentEvent, UActorComponent&);
+
+/// Broadcast when an instanced component is registered or an archetype component is added.
+ZAKAZANEUTILITIES_API FOnComponentEvent& OnComponentAdded();
+
+/// Broadcast when an instanced component is unregistered or an archetype component is removed. Removed archetype
+/// components may already be marked as garbage.
+ZAKAZANEUTILITIES_API FOnComponentEvent& OnComponentRemoved();
+
+/// Broadcast by BroadcastAttachmentChanged.
+ZAKAZANEUTILITIES_API FOnComponentEvent& OnAttachmentChanged();
+
+ZAKAZANEUTILITIES_API void BroadcastAttachmentChanged(USceneComponent& Component);
+
+}  // namespace Zkz::ComponentEvents
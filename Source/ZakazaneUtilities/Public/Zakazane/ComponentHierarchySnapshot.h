@@ -0,0 +1,308 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Async/ParallelFor.h"
+#include "Templates/IsInvocable.h"
+#include "Zakazane/Component.h"
+#include "Zakazane/ReturnIfMacros.h"
+
+namespace Zkz
+{
+
+/// Flat, index-based copy of an FComponentHierarchy. Components are stored in preorder, so the subtree of the node at
+/// index N is the index range [N, GetSubtreeEnd(N)). Subtree traversal is a linear scan over an array and IsDescendant
+/// is a range check, no weak pointers are resolved and no maps are searched after construction.
+/// The snapshot stores raw component pointers and is not updated when the hierarchy changes. It's meant to be built,
+/// used for a batch of queries and thrown away. It must not be kept across garbage collection, unless the components
+/// are known to be referenced elsewhere (which is the case for components of a live actor or a class default object).
+class ZAKAZANEUTILITIES_API FComponentHierarchySnapshot
+{
+public:
+	explicit FComponentHierarchySnapshot(const FComponentHierarchy& Hierarchy);
+
+	int32 Num() const
+	{
+		return Components.Num();
+	}
+
+	bool IsValidIndex(const int32 NodeIdx) const
+	{
+		return Components.IsValidIndex(NodeIdx);
+	}
+
+	/// Returns the index of the given component or INDEX_NONE if it's not in the snapshot.
+	int32 FindIndex(const UActorComponent& Component) const;
+
+	/// Returns the index of the first component in preorder with the given name (template suffixes are ignored, as in
+	/// GetComponentNameNoSuffix) or INDEX_NONE. Works for both instanced actors and archetypes.
+	int32 FindIndexByName(FName Name) const;
+
+	/// Same as FindIndexByName, restricted to the subtree of the node at RootIdx (including the root). Costs a hash
+	/// lookup and a range check per component with that name, regardless of the subtree size.
+	int32 FindIndexInSubtreeByName(int32 RootIdx, FName Name) const;
+
+	const UActorComponent& GetComponent(const int32 NodeIdx) const
+	{
+		return *Components[NodeIdx];
+	}
+
+	/// Only allowed if ComponentsMutable()
+	UActorComponent& GetMutableComponent(int32 NodeIdx) const;
+
+	/// Returns INDEX_NONE for root components
+	int32 GetParentIndex(const int32 NodeIdx) const
+	{
+		return ParentIndices[NodeIdx];
+	}
+
+	/// Returns the index one past the last descendant of the given node
+	int32 GetSubtreeEnd(const int32 NodeIdx) const
+	{
+		return SubtreeEnds[NodeIdx];
+	}
+
+	/// Returns INDEX_NONE for leaves. In preorder, the first child always directly follows its parent.
+	int32 GetFirstChildIndex(const int32 NodeIdx) const
+	{
+		return GetSubtreeEnd(NodeIdx) > NodeIdx + 1 ? NodeIdx + 1 : INDEX_NONE;
+	}
+
+	/// Returns INDEX_NONE for the last child of a node
+	int32 GetNextSiblingIndex(const int32 NodeIdx) const
+	{
+		const int32 ParentIdx = ParentIndices[NodeIdx];
+		const int32 SiblingsEnd = ParentIdx == INDEX_NONE ? Components.Num() : SubtreeEnds[ParentIdx];
+		return SubtreeEnds[NodeIdx] < SiblingsEnd ? SubtreeEnds[NodeIdx] : INDEX_NONE;
+	}
+
+	/// Whether Descendant is in the subtree of Ancestor (and not Ancestor itself). O(1).
+	bool IsDescendant(const int32 AncestorIdx, const int32 DescendantIdx) const
+	{
+		return AncestorIdx < DescendantIdx && DescendantIdx < SubtreeEnds[AncestorIdx];
+	}
+
+	/// Whether Descendant is in the subtree of Ancestor (and not Ancestor itself). Costs two index lookups.
+	bool IsDescendant(const UActorComponent& Ancestor, const UActorComponent& Descendant) const;
+
+	/// Calls Func for each component, in preorder.
+	template <class FuncType, class... AdditionalArgTypes>
+	void ForEachComponent(FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const;
+
+	/// Calls Func for each component in the subtree of the node at RootIdx. Order of calls depends on provided
+	/// RecursionType, same as FComponentHierarchy::ForEachComponentInSubtree.
+	/// If RecursionType == PrefixCond, the given function is expected to return whether traversal should continue.
+	template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
+	void ForEachComponentInSubtree(int32 RootIdx, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const;
+
+	/// Calls Func(const UActorComponent&, ContextType&) for each component on worker threads and blocks until done.
+	/// The components are split into chunks of whole subtrees of similar size, a couple per worker thread. Each chunk
+	/// is processed in preorder, there is no ordering between chunks.
+	/// OutContexts is reset to one default constructed context per worker task. A context is only ever used by a single
+	/// thread at a time, so it can accumulate results without synchronization, to be combined after the call returns.
+	///
+	/// Func is called concurrently and must be read-only:
+	/// - It must not create, rename, modify or destroy objects, (un)register components, load assets or call anything
+	///   that checks IsInGameThread.
+	/// - The components are kept alive by the fact that garbage collection runs on the game thread, which can't happen
+	///   while the calling thread waits here. Call this from the game thread, or hold an FGCScopeGuard if calling from
+	///   any other thread.
+	/// - Component pointers stored in the contexts are subject to the same rules as the snapshot itself.
+	template <class ContextType, class FuncType>
+	void ParallelForEachComponent(TArray<ContextType>& OutContexts, const FuncType& Func) const;
+
+	/// Same as ParallelForEachComponent, for the subtree of the node at RootIdx.
+	template <class ContextType, class FuncType>
+	void ParallelForEachComponentInSubtree(int32 RootIdx, TArray<ContextType>& OutContexts, const FuncType& Func) const;
+
+	/// Splits [BeginIdx, EndIdx), which must consist of whole subtrees, into chunks of similar size for parallel
+	/// processing. Subtrees are only split if they're larger than the chunk size, in which case their root forms part
+	/// of the preceding chunk and their children are split recursively. Chunk N is [Bounds[N], Bounds[N + 1]).
+	TArray<int32> MakeParallelChunkBounds(int32 BeginIdx, int32 EndIdx) const;
+
+	/// @see FComponentHierarchy::ComponentsMutable
+	bool ComponentsMutable() const
+	{
+		return bComponentsMutable;
+	}
+
+private:
+	TArray<UActorComponent*> Components;
+	TArray<int32> ParentIndices;
+	TArray<int32> SubtreeEnds;
+
+	TMap<const UActorComponent*, int32> IndicesByComponent;
+
+	/// Names without template suffixes
+	TMultiMap<FName, int32> IndicesByName;
+
+	/// @see ComponentsMutable
+	bool bComponentsMutable = false;
+
+	void AddSubtree(const FComponentHierarchy& Hierarchy, const UActorComponent& Component, int32 ParentIdx);
+
+	int32 FindIndexInRangeByName(int32 BeginIdx, int32 EndIdx, FName Name) const;
+
+	template <class FuncType, class... AdditionalArgTypes>
+	decltype(auto) InvokeForNode(int32 NodeIdx, FuncType& Func, AdditionalArgTypes&... AdditionalArgs) const;
+
+	template <class ContextType, class FuncType>
+	void ParallelForEachInRange(
+		int32 BeginIdx, int32 EndIdx, TArray<ContextType>& OutContexts, const FuncType& Func) const;
+};
+
+/// Snapshots the hierarchy and calls FComponentHierarchySnapshot::ParallelForEachComponent on it, see there for the
+/// threading rules.
+template <class ContextType, class FuncType>
+void ParallelForEachComponent(
+	const FComponentHierarchy& Hierarchy, TArray<ContextType>& OutContexts, const FuncType& Func)
+{
+	FComponentHierarchySnapshot{Hierarchy}.ParallelForEachComponent(OutContexts, Func);
+}
+
+}  // namespace Zkz
+
+// -- Template implementations
+
+namespace Zkz
+{
+
+template <class FuncType, class... AdditionalArgTypes>
+decltype(auto) FComponentHierarchySnapshot::InvokeForNode(
+	const int32 NodeIdx, FuncType& Func, AdditionalArgTypes&... AdditionalArgs) const
+{
+	if constexpr (TIsInvocable<FuncType, const UActorComponent&, AdditionalArgTypes...>::Value)
+	{
+		return ::Invoke(Func, static_cast<const UActorComponent&>(*Components[NodeIdx]), AdditionalArgs...);
+	}
+	else
+	{
+		return ::Invoke(Func, *Components[NodeIdx], AdditionalArgs...);
+	}
+}
+
+template <class FuncType, class... AdditionalArgTypes>
+void FComponentHierarchySnapshot::ForEachComponent(FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const
+{
+	constexpr bool bIsConstInvocable = TIsInvocable<FuncType, const UActorComponent&, AdditionalArgTypes...>::Value;
+	constexpr bool bIsNonConstInvocable = TIsInvocable<FuncType, UActorComponent&, AdditionalArgTypes...>::Value;
+	static_assert(
+		bIsConstInvocable || bIsNonConstInvocable,
+		"Invalid functor signature. Expected functor taking a [const] UActorComponent, AdditionalArgTypes...");
+
+	ZKZ_RETURN_IF_ENSUREALWAYSMSGF(
+		!bIsConstInvocable && !ComponentsMutable(),
+		"ForEachComponent called with functor taking non-const components for an immutable hierarchy");
+
+	for (int32 NodeIdx = 0; NodeIdx < Components.Num(); ++NodeIdx)
+	{
+		InvokeForNode(NodeIdx, Func, AdditionalArgs...);
+	}
+}
+
+template <EForEachComponentRecursionType RecursionType, class FuncType, class... AdditionalArgTypes>
+void FComponentHierarchySnapshot::ForEachComponentInSubtree(
+	const int32 RootIdx, FuncType&& Func, AdditionalArgTypes&&... AdditionalArgs) const
+{
+	constexpr bool bIsConstInvocable = TIsInvocable<FuncType, const UActorComponent&, AdditionalArgTypes...>::Value;
+	constexpr bool bIsNonConstInvocable = TIsInvocable<FuncType, UActorComponent&, AdditionalArgTypes...>::Value;
+	static_assert(
+		bIsConstInvocable || bIsNonConstInvocable,
+		"Invalid functor signature. Expected functor taking a [const] UActorComponent, AdditionalArgTypes...");
+
+	ZKZ_RETURN_IF_ENSUREALWAYSMSGF(
+		!bIsConstInvocable && !ComponentsMutable(),
+		"ForEachComponentInSubtree called with functor taking non-const components for an immutable hierarchy");
+	ZKZ_RETURN_IF_ENSUREALWAYS(!IsValidIndex(RootIdx));
+
+	const int32 EndIdx = SubtreeEnds[RootIdx];
+
+	if constexpr (RecursionType == EForEachComponentRecursionType::NotRecursive)
+	{
+		InvokeForNode(RootIdx, Func, AdditionalArgs...);
+	}
+	else if constexpr (RecursionType == EForEachComponentRecursionType::Prefix)
+	{
+		for (int32 NodeIdx = RootIdx; NodeIdx < EndIdx; ++NodeIdx)
+		{
+			InvokeForNode(NodeIdx, Func, AdditionalArgs...);
+		}
+	}
+	else if constexpr (RecursionType == EForEachComponentRecursionType::PrefixCond)
+	{
+		for (int32 NodeIdx = RootIdx; NodeIdx < EndIdx;)
+		{
+			const bool bContinue = InvokeForNode(NodeIdx, Func, AdditionalArgs...);
+
+			// Skipping the subtree is just a jump to its end
+			NodeIdx = bContinue ? NodeIdx + 1 : SubtreeEnds[NodeIdx];
+		}
+	}
+	else
+	{
+		static_assert(RecursionType == EForEachComponentRecursionType::Suffix);
+
+		// Nodes whose subtrees are still being visited. A node is visited once the scan leaves its subtree.
+		TArray<int32, TInlineAllocator<32>> OpenNodes;
+
+		for (int32 NodeIdx = RootIdx; NodeIdx < EndIdx; ++NodeIdx)
+		{
+			while (!OpenNodes.IsEmpty() && SubtreeEnds[OpenNodes.Last()] <= NodeIdx)
+			{
+				InvokeForNode(OpenNodes.Pop(EAllowShrinking::No), Func, AdditionalArgs...);
+			}
+
+			OpenNodes.Emplace(NodeIdx);
+		}
+
+		while (!OpenNodes.IsEmpty())
+		{
+			InvokeForNode(OpenNodes.Pop(EAllowShrinking::No), Func, AdditionalArgs...);
+		}
+	}
+}
+
+template <class ContextType, class FuncType>
+void FComponentHierarchySnapshot::ParallelForEachComponent(TArray<ContextType>& OutContexts, const FuncType& Func) const
+{
+	ParallelForEachInRange(0, Components.Num(), OutContexts, Func);
+}
+
+template <class ContextType, class FuncType>
+void FComponentHierarchySnapshot::ParallelForEachComponentInSubtree(
+	const int32 RootIdx, TArray<ContextType>& OutContexts, const FuncType& Func) const
+{
+	OutContexts.Reset();
+	ZKZ_RETURN_IF_ENSUREALWAYS(!IsValidIndex(RootIdx));
+
+	ParallelForEachInRange(RootIdx, SubtreeEnds[RootIdx], OutContexts, Func);
+}
+
+template <class ContextType, class FuncType>
+void FComponentHierarchySnapshot::ParallelForEachInRange(
+	const int32 BeginIdx, const int32 EndIdx, TArray<ContextType>& OutContexts, const FuncType& Func) const
+{
+	static_assert(
+		TIsInvocable<const FuncType, const UActorComponent&, ContextType&>::Value,
+		"Invalid functor signature. Expected const functor taking a const UActorComponent and a ContextType");
+
+	const TArray<int32> ChunkBounds = MakeParallelChunkBounds(BeginIdx, EndIdx);
+
+	OutContexts.Reset();
+	ZKZ_RETURN_IF(ChunkBounds.Num() < 2);
+
+	ParallelForWithTaskContext(
+		OutContexts,
+		ChunkBounds.Num() - 1,
+		[this, &ChunkBounds, &Func](ContextType& Context, const int32 ChunkIdx)
+		{
+			for (int32 NodeIdx = ChunkBounds[ChunkIdx]; NodeIdx < ChunkBounds[ChunkIdx + 1]; ++NodeIdx)
+			{
+				::Invoke(Func, static_cast<const UActorComponent&>(*Components[NodeIdx]), Context);
+			}
+		});
+}
+
+}  // namespace Zkz
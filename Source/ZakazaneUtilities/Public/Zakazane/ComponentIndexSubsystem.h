@@ -0,0 +1,187 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/BitArray.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/IsInvocable.h"
+#include "UObject/ObjectKey.h"
+#include "Zakazane/ContinueIfMacros.h"
+#include "Zakazane/ReturnIfMacros.h"
+
+#include "ComponentIndexSubsystem.generated.h"
+
+/// World-wide index of the components of all actors in a world, for class, tag and attachment queries which would
+/// otherwise need an FComponentHierarchy per actor.
+/// Components are stored in flat arrays of entries, with a bit array per component class and per tag, so a query is a
+/// bitwise OR of a few bit arrays and a scan over the set bits, regardless of the number of actors.
+/// The index is built lazily on the first query and then maintained incrementally: spawned actors, destroyed actors,
+/// streamed levels and actors whose components were registered, unregistered or reattached (@see ComponentEvents) are
+/// reindexed on the next query. Other changes (tags changed, attachment changed without
+/// ComponentEvents::BroadcastAttachmentChanged) require calling InvalidateActor.
+/// Game thread only.
+UCLASS()
+class ZAKAZANEUTILITIES_API UZkzComponentIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/// Schedules the components of the actor to be reindexed before the next query.
+	void InvalidateActor(const AActor& Actor);
+
+	/// Returns the number of indexed components.
+	int32 GetNumComponents();
+
+	/// Returns a mask of the entries whose class is Class or derived from it.
+	TBitArray<> MakeClassMask(const UClass& Class);
+
+	/// Returns a mask of the entries with any of the given tags.
+	TBitArray<> MakeTagMask(TArrayView<const FName> Tags);
+
+	/// Calls Func(UActorComponent&) for each indexed component set in Mask. Masks are only valid until the index
+	/// changes, so they should be used right after they're made.
+	template <class FuncType>
+	void ForEachComponent(const TBitArray<>& Mask, FuncType&& Func);
+
+	/// Calls Func(ComponentType&) for each indexed component of the given class.
+	template <class ComponentType, class FuncType>
+	void ForEachComponentOfClass(FuncType&& Func);
+
+	/// Calls Func(UActorComponent&) for each indexed component with any of the given tags.
+	template <class FuncType>
+	void ForEachComponentWithAnyTag(TArrayView<const FName> Tags, FuncType&& Func);
+
+	/// Returns the parent of the component, if both are indexed. Unlike USceneComponent::GetAttachParent, only
+	/// reflects attachment at the time the component's actor was indexed.
+	UActorComponent* FindAttachParent(const UActorComponent& Component);
+
+	/// Calls Func(UActorComponent&) for each component attached (directly or indirectly) to Root, across actors.
+	/// Order is undetermined.
+	template <class FuncType>
+	void ForEachAttachedDescendant(const UActorComponent& Root, FuncType&& Func);
+
+private:
+	/// Data of entry N is at index N of each array. Entries are reused once their component is removed.
+	TArray<TWeakObjectPtr<UActorComponent>> Components;
+	TArray<TObjectKey<UActorComponent>> ComponentKeys;
+	TArray<TObjectKey<AActor>> OwnerKeys;
+	TArray<int32> ParentEntries;
+	TArray<int32> ClassIds;
+	TArray<TArray<int32, TInlineAllocator<2>>> TagIdsByEntry;
+	TArray<int32> FreeEntries;
+
+	TMap<TObjectKey<UActorComponent>, int32> EntriesByComponent;
+	TMap<TObjectKey<AActor>, TArray<int32>> EntriesByActor;
+	TMultiMap<int32, int32> ChildEntriesByParent;
+
+	TMap<FName, int32> TagIds;
+	TArray<TBitArray<>> EntriesByTag;
+
+	TArray<TWeakObjectPtr<UClass>> Classes;
+	TMap<TObjectKey<UClass>, int32> ClassIdsByClass;
+	TArray<TBitArray<>> EntriesByClass;
+
+	TSet<TObjectKey<AActor>> ActorsToRefresh;
+	TSet<TObjectKey<AActor>> ActorsToRemove;
+	bool bNeedsFullRebuild = true;
+
+	FDelegateHandle OnActorSpawnedHandle;
+	FDelegateHandle OnActorDestroyedHandle;
+	FDelegateHandle OnLevelAddedHandle;
+	FDelegateHandle OnLevelRemovedHandle;
+	FDelegateHandle OnComponentAddedHandle;
+	FDelegateHandle OnComponentRemovedHandle;
+	FDelegateHandle OnAttachmentChangedHandle;
+
+	/// Applies pending changes. Called by all queries.
+	void Flush();
+
+	void RefreshActor(AActor& Actor, TArray<int32>& OutRefreshedEntries);
+	void RemoveActor(const TObjectKey<AActor>& ActorKey);
+
+	int32 AllocateEntry();
+	void SetEntryComponent(int32 EntryIdx, UActorComponent& Component);
+	void RemoveEntry(int32 EntryIdx);
+	void ResolveParentEntry(int32 EntryIdx);
+
+	int32 FindOrAddClassId(UClass& Class);
+
+	void OnActorSpawned(AActor* Actor);
+	void OnActorDestroyed(AActor* Actor);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+	void OnComponentChanged(UActorComponent& Component);
+};
+
+// -- Template implementations
+
+template <class FuncType>
+void UZkzComponentIndexSubsystem::ForEachComponent(const TBitArray<>& Mask, FuncType&& Func)
+{
+	static_assert(
+		TIsInvocable<FuncType, UActorComponent&>::Value,
+		"Invalid functor signature. Expected functor taking a UActorComponent");
+
+	Flush();
+
+	for (TConstSetBitIterator<> It{Mask}; It; ++It)
+	{
+		ZKZ_CONTINUE_IF(!Components.IsValidIndex(It.GetIndex()));
+
+		if (UActorComponent* const Component = Components[It.GetIndex()].Get())
+		{
+			::Invoke(Func, *Component);
+		}
+	}
+}
+
+template <class ComponentType, class FuncType>
+void UZkzComponentIndexSubsystem::ForEachComponentOfClass(FuncType&& Func)
+{
+	static_assert(
+		TIsInvocable<FuncType, ComponentType&>::Value,
+		"Invalid functor signature. Expected functor taking a ComponentType");
+
+	ForEachComponent(
+		MakeClassMask(*ComponentType::StaticClass()),
+		[&Func](UActorComponent& Component) { ::Invoke(Func, *CastChecked<ComponentType>(&Component)); });
+}
+
+template <class FuncType>
+void UZkzComponentIndexSubsystem::ForEachComponentWithAnyTag(const TArrayView<const FName> Tags, FuncType&& Func)
+{
+	ForEachComponent(MakeTagMask(Tags), Forward<FuncType>(Func));
+}
+
+template <class FuncType>
+void UZkzComponentIndexSubsystem::ForEachAttachedDescendant(const UActorComponent& Root, FuncType&& Func)
+{
+	static_assert(
+		TIsInvocable<FuncType, UActorComponent&>::Value,
+		"Invalid functor signature. Expected functor taking a UActorComponent");
+
+	Flush();
+
+	const int32* const RootEntry = EntriesByComponent.Find(&Root);
+	ZKZ_RETURN_IF(RootEntry == nullptr);
+
+	TArray<int32, TInlineAllocator<32>> PendingEntries{*RootEntry};
+	while (!PendingEntries.IsEmpty())
+	{
+		const int32 ParentEntry = PendingEntries.Pop(EAllowShrinking::No);
+		for (auto It = ChildEntriesByParent.CreateConstKeyIterator(ParentEntry); It; ++It)
+		{
+			PendingEntries.Emplace(It.Value());
+
+			if (UActorComponent* const Component = Components[It.Value()].Get())
+			{
+				::Invoke(Func, *Component);
+			}
+		}
+	}
+}
@@ -0,0 +1,143 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/BitArray.h"
+#include "Templates/IsInvocable.h"
+#include "Zakazane/ComponentHierarchySnapshot.h"
+
+namespace Zkz
+{
+
+/// Tag and class index over the nodes of an FComponentHierarchySnapshot. For every distinct tag and every distinct
+/// component class there is a bit array with a bit per node, so a query is a bitwise OR of a few bit arrays followed
+/// by a scan over the set bits of a subtree, which is a contiguous bit range in preorder.
+/// The index refers to the snapshot, which must outlive it, and is subject to the same rules (@see
+/// FComponentHierarchySnapshot).
+class ZAKAZANEUTILITIES_API FComponentQueryIndex
+{
+public:
+	explicit FComponentQueryIndex(const FComponentHierarchySnapshot& InSnapshot);
+
+	/// The index keeps a reference to the snapshot, so it can't be built from a temporary
+	FComponentQueryIndex(FComponentHierarchySnapshot&&) = delete;
+
+	const FComponentHierarchySnapshot& GetSnapshot() const
+	{
+		return Snapshot;
+	}
+
+	/// Returns a mask of the nodes with any of the given tags. Masks can be combined with the bitwise operations of
+	/// TBitArray.
+	TBitArray<> MakeTagMask(TArrayView<const FName> Tags) const;
+
+	/// Returns a mask of the nodes whose class is Class or derived from it.
+	TBitArray<> MakeClassMask(const UClass& Class) const;
+
+	/// Version of ComponentHasAnyTag for a node of the snapshot, costing a bit test per tag.
+	bool HasAnyTag(int32 NodeIdx, TArrayView<const FName> Tags) const;
+
+	/// Calls Func(const UActorComponent&) for each node in the subtree of RootIdx (including the root) which is set in
+	/// Mask, in preorder.
+	template <class FuncType>
+	void ForEachInSubtree(int32 RootIdx, const TBitArray<>& Mask, FuncType&& Func) const;
+
+	/// Calls Func(const UActorComponent&) for each component with any of the given tags in the subtree of RootIdx.
+	/// The mask built for the query only covers the subtree.
+	template <class FuncType>
+	void ForEachWithAnyTagInSubtree(int32 RootIdx, TArrayView<const FName> Tags, FuncType&& Func) const;
+
+	/// Calls Func(const ComponentType&) for each component of the given class in the subtree of RootIdx.
+	template <class ComponentType, class FuncType>
+	void ForEachOfClassInSubtree(int32 RootIdx, FuncType&& Func) const;
+
+private:
+	/// Returns a mask of the nodes in the subtree of RootIdx with any of the given tags, bit 0 being RootIdx.
+	TBitArray<> MakeSubtreeTagMask(int32 RootIdx, TArrayView<const FName> Tags) const;
+
+	/// Returns a mask of the nodes in the subtree of RootIdx whose class is Class or derived from it, bit 0 being
+	/// RootIdx.
+	TBitArray<> MakeSubtreeClassMask(int32 RootIdx, const UClass& Class) const;
+
+	/// Sets the bits of SubtreeMask for the nodes of the subtree of RootIdx set in Nodes.
+	void CombineSubtreeWithBitwiseOR(int32 RootIdx, const TBitArray<>& Nodes, TBitArray<>& SubtreeMask) const;
+
+	/// Calls Func(const UActorComponent&) for each node set in a mask made by MakeSubtreeTagMask or
+	/// MakeSubtreeClassMask, in preorder.
+	template <class FuncType>
+	void ForEachInSubtreeMask(int32 RootIdx, const TBitArray<>& SubtreeMask, FuncType&& Func) const;
+
+	const FComponentHierarchySnapshot& Snapshot;
+
+	TMap<FName, int32> TagIds;
+	TArray<TBitArray<>> NodesByTag;
+
+	TArray<const UClass*> Classes;
+	TArray<TBitArray<>> NodesByClass;
+};
+
+}  // namespace Zkz
+
+// -- Template implementations
+
+namespace Zkz
+{
+
+template <class FuncType>
+void FComponentQueryIndex::ForEachInSubtree(const int32 RootIdx, const TBitArray<>& Mask, FuncType&& Func) const
+{
+	static_assert(
+		TIsInvocable<FuncType, const UActorComponent&>::Value,
+		"Invalid functor signature. Expected functor taking a const UActorComponent");
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Snapshot.IsValidIndex(RootIdx));
+	ZKZ_RETURN_IF(RootIdx >= Mask.Num());
+
+	const int32 EndIdx = Snapshot.GetSubtreeEnd(RootIdx);
+	for (TConstSetBitIterator<> It{Mask, RootIdx}; It && It.GetIndex() < EndIdx; ++It)
+	{
+		::Invoke(Func, Snapshot.GetComponent(It.GetIndex()));
+	}
+}
+
+template <class FuncType>
+void FComponentQueryIndex::ForEachWithAnyTagInSubtree(
+	const int32 RootIdx, const TArrayView<const FName> Tags, FuncType&& Func) const
+{
+	static_assert(
+		TIsInvocable<FuncType, const UActorComponent&>::Value,
+		"Invalid functor signature. Expected functor taking a const UActorComponent");
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Snapshot.IsValidIndex(RootIdx));
+
+	ForEachInSubtreeMask(RootIdx, MakeSubtreeTagMask(RootIdx, Tags), Forward<FuncType>(Func));
+}
+
+template <class ComponentType, class FuncType>
+void FComponentQueryIndex::ForEachOfClassInSubtree(const int32 RootIdx, FuncType&& Func) const
+{
+	static_assert(
+		TIsInvocable<FuncType, const ComponentType&>::Value,
+		"Invalid functor signature. Expected functor taking a const ComponentType");
+
+	ZKZ_RETURN_IF_ENSUREALWAYS(!Snapshot.IsValidIndex(RootIdx));
+
+	ForEachInSubtreeMask(
+		RootIdx,
+		MakeSubtreeClassMask(RootIdx, *ComponentType::StaticClass()),
+		[&Func](const UActorComponent& Component) { ::Invoke(Func, *CastChecked<ComponentType>(&Component)); });
+}
+
+template <class FuncType>
+void FComponentQueryIndex::ForEachInSubtreeMask(
+	const int32 RootIdx, const TBitArray<>& SubtreeMask, FuncType&& Func) const
+{
+	for (TConstSetBitIterator<> It{SubtreeMask}; It; ++It)
+	{
+		::Invoke(Func, Snapshot.GetComponent(RootIdx + It.GetIndex()));
+	}
+}
+
+}  // namespace Zkz
@@ -0,0 +1,97 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "UObject/ObjectKey.h"
+
+namespace Zkz
+{
+
+/// Pool of component subtrees cloned from template subtrees, for subtrees which are spawned and destroyed often (e.g.
+/// weapon attachments). The first time a subtree is acquired, the template subtree (as described by
+/// FComponentHierarchy, so templates may be archetype or instanced components) is cloned and registered. Released
+/// subtrees are detached, hidden, deactivated and have collision disabled, but stay registered, so acquiring them
+/// again only resets relative transforms and the configured properties from the templates and reattaches the root.
+/// Instances are created in their owner actor, so they're only reused by the same owner. Pooled instances whose owner
+/// or components are gone are dropped on the next Acquire or Release of their template, acquired instances whose owner
+/// or root is gone on the next Acquire or Release of any template.
+/// Game thread only.
+class ZAKAZANEUTILITIES_API FComponentSubtreePool
+{
+public:
+	/// @param InPropertiesToReset names of properties copied from the templates to reused instances. Properties which
+	///		don't exist in a component's class are skipped for that component.
+	/// @param InMaxPooledPerTemplate subtrees of a template released above this limit for the same owner are destroyed
+	explicit FComponentSubtreePool(TArray<FName> InPropertiesToReset = {}, int32 InMaxPooledPerTemplate = 8);
+
+	/// Returns the root of an instance of the subtree of TemplateRoot, owned by Owner and attached to AttachParent.
+	/// Returns null if any of the templates is no longer valid or TemplateRoot's subtree can't be gathered.
+	USceneComponent* Acquire(
+		const USceneComponent& TemplateRoot,
+		AActor& Owner,
+		USceneComponent& AttachParent,
+		FName SocketName = NAME_None);
+
+	/// Returns a subtree acquired from this pool to it.
+	void Release(USceneComponent& InstanceRoot);
+
+	/// Returns the number of released subtrees of TemplateRoot waiting to be reused.
+	int32 GetNumPooled(const USceneComponent& TemplateRoot) const;
+
+	/// Returns the number of subtrees acquired and not yet released, from all templates.
+	int32 GetNumAcquired() const
+	{
+		return AcquiredInstances.Num();
+	}
+
+	/// Destroys all pooled subtrees. Subtrees which are still acquired are left to their owners.
+	void Reset();
+
+private:
+	struct FInstance
+	{
+		TWeakObjectPtr<AActor> Owner;
+		/// Same order as the components of the template subtree
+		TArray<TWeakObjectPtr<USceneComponent>> Components;
+	};
+
+	struct FTemplateSubtree
+	{
+		/// Preorder, so parents come before their children
+		TArray<TWeakObjectPtr<const USceneComponent>> Components;
+		TArray<int32> ParentIndices;
+		TArray<TArray<FProperty*>> PropertiesToResetByComponent;
+
+		TArray<FInstance> FreeInstances;
+	};
+
+	struct FAcquiredInstance
+	{
+		TObjectKey<USceneComponent> TemplateRoot;
+		FInstance Instance;
+	};
+
+	TArray<FName> PropertiesToReset;
+	int32 MaxPooledPerTemplate;
+
+	TMap<TObjectKey<USceneComponent>, FTemplateSubtree> TemplateSubtrees;
+	TMap<TObjectKey<USceneComponent>, FAcquiredInstance> AcquiredInstances;
+
+	/// Returns null, and adds nothing, if the subtree of TemplateRoot can't be gathered
+	FTemplateSubtree* FindOrAddTemplateSubtree(const USceneComponent& TemplateRoot);
+
+	/// Destroys and removes free instances whose owner or any of whose components are gone
+	static void RemoveDeadInstances(FTemplateSubtree& TemplateSubtree);
+	/// Forgets acquired instances whose owner or root is gone, which will never be released
+	void RemoveDeadAcquiredInstances();
+	static int32 CountFreeInstances(const FTemplateSubtree& TemplateSubtree, const AActor& Owner);
+
+	static TOptional<FInstance> CloneSubtree(const FTemplateSubtree& TemplateSubtree, AActor& Owner);
+	static bool ResetInstance(const FTemplateSubtree& TemplateSubtree, const FInstance& Instance);
+	static void DisableInstance(const FInstance& Instance);
+	static void DestroyInstance(const FInstance& Instance);
+};
+
+}  // namespace Zkz
@@ -0,0 +1,76 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Containers/BitArray.h"
+#include "Engine/EngineTypes.h"
+#include "Zakazane/ComponentHierarchySnapshot.h"
+
+namespace Zkz
+{
+
+/// Transforms of the scene components in a subtree of an FComponentHierarchySnapshot, copied into contiguous arrays
+/// (one per transform part) in preorder, so they can be processed in bulk without touching the components.
+/// Entry N of each array belongs to the same component. Non-scene components are left out.
+/// @see GatherTransforms, ScatterTransforms
+struct ZAKAZANEUTILITIES_API FComponentTransforms
+{
+	/// Snapshot index of the component of each entry
+	TArray<int32> NodeIndices;
+
+	/// Entry of the parent of each entry, or INDEX_NONE if the parent isn't in the buffer. Parents precede their
+	/// children.
+	TArray<int32> ParentEntries;
+
+	TArray<FVector> RelativeLocations;
+	TArray<FQuat> RelativeRotations;
+	TArray<FVector> RelativeScales;
+
+	/// World transforms as of the last gather or scatter. Not updated when the relative transforms are modified.
+	TArray<FVector> WorldLocations;
+	TArray<FQuat> WorldRotations;
+	TArray<FVector> WorldScales;
+
+	/// Entries whose relative transforms ScatterTransforms writes back. Modifying the relative transform arrays
+	/// directly requires setting the corresponding bits.
+	TBitArray<> DirtyEntries;
+
+	int32 Num() const
+	{
+		return NodeIndices.Num();
+	}
+
+	FTransform GetRelativeTransform(const int32 EntryIdx) const
+	{
+		return FTransform{RelativeRotations[EntryIdx], RelativeLocations[EntryIdx], RelativeScales[EntryIdx]};
+	}
+
+	FTransform GetWorldTransform(const int32 EntryIdx) const
+	{
+		return FTransform{WorldRotations[EntryIdx], WorldLocations[EntryIdx], WorldScales[EntryIdx]};
+	}
+
+	/// Sets the relative transform of the entry and marks it dirty.
+	void SetRelativeTransform(int32 EntryIdx, const FTransform& Transform);
+
+	void Reset();
+};
+
+/// Copies the relative and world transforms of the scene components in the subtree of the node at RootIdx (including
+/// the root) into OutTransforms, which is reset first.
+ZAKAZANEUTILITIES_API void GatherTransforms(
+	const FComponentHierarchySnapshot& Snapshot, int32 RootIdx, FComponentTransforms& OutTransforms);
+
+/// Writes the relative transforms of the dirty entries back to their components, then updates the world transforms of
+/// the components with a single propagation pass from the topmost dirty entries, instead of one per modified component.
+/// World transforms of the updated entries are read back into Transforms and the dirty bits are cleared.
+/// Relative transforms are set directly, without a sweep, so overlaps aren't updated. Teleport is passed on to physics.
+/// Snapshot must be the one the transforms were gathered from, and must be mutable. Game thread only.
+ZAKAZANEUTILITIES_API void ScatterTransforms(
+	const FComponentHierarchySnapshot& Snapshot,
+	FComponentTransforms& Transforms,
+	ETeleportType Teleport = ETeleportType::None);
+
+}  // namespace Zkz
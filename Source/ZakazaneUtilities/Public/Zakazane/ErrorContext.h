@@ -0,0 +1,136 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Result.h"
+
+#include <type_traits>
+
+namespace Zkz
+{
+
+namespace ErrorContextPrivate
+{
+
+template <class T>
+constexpr bool IsCharPointer =
+	std::is_pointer_v<T>
+	&& (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, TCHAR>
+		|| std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, ANSICHAR>);
+
+/// Arguments are captured by value. Character pointers are captured as strings, so they don't dangle.
+template <class ArgType>
+using TCapturedArg = std::conditional_t<IsCharPointer<std::decay_t<ArgType>>, FString, std::decay_t<ArgType>>;
+
+class IFrameFormatter
+{
+public:
+	virtual ~IFrameFormatter() = default;
+
+	virtual FString Format() const = 0;
+};
+
+template <class... ArgTypes>
+class TFrameFormatter final : public IFrameFormatter
+{
+public:
+	template <class... InArgTypes>
+	explicit TFrameFormatter(const TCHAR* InFormatString, InArgTypes&&... InArgs)
+		: FormatString{InFormatString}, Args{Forward<InArgTypes>(InArgs)...}
+	{
+	}
+
+	virtual FString Format() const override
+	{
+		return Args.ApplyAfter(
+			[this](const ArgTypes&... Values)
+			{ return FString::Format(FormatString, FStringFormatOrderedArguments{FStringFormatArg(Values)...}); });
+	}
+
+private:
+	const TCHAR* FormatString;
+	TTuple<ArgTypes...> Args;
+};
+
+}  // namespace ErrorContextPrivate
+
+/// Error carrying where and why an operation failed, formatted only when rendered with ToString. Building one costs a
+/// single allocation holding the format arguments, so it is cheap enough for validation paths whose errors are mostly
+/// discarded. Errors passed up the call stack can be wrapped in further frames describing the outer operation.
+/// Use ZKZ_ERROR_CONTEXT to create one, e.g.:
+/// <pre>
+///		TResult<FConfig, FErrorContext> LoadConfig(const FString& Path)
+///		{
+///			ZKZ_RETURN_IF(!FPaths::FileExists(Path), Err(ZKZ_ERROR_CONTEXT("File {0} not found", Path)));
+///			...
+///		}
+///
+///		LoadConfig(Path).OrElse(ZKZ_ADD_ERROR_CONTEXT(FConfig, "Loading config of {0}", LevelName));
+/// </pre>
+class ZAKAZANEUTILITIES_API FErrorContext
+{
+public:
+	struct FFrame
+	{
+		const ANSICHAR* File = nullptr;
+		int32 Line = 0;
+		TSharedPtr<const ErrorContextPrivate::IFrameFormatter, ESPMode::ThreadSafe> Formatter;
+	};
+
+	FErrorContext() = default;
+
+	/// Format is a FString::Format format string with ordered arguments ({0}, {1}...) and must outlive the context,
+	/// which string literals do.
+	template <class... ArgTypes>
+	FErrorContext(const ANSICHAR* File, const int32 Line, const TCHAR* Format, ArgTypes&&... Args)
+	{
+		static_assert(
+			(std::is_constructible_v<FStringFormatArg, const ErrorContextPrivate::TCapturedArg<ArgTypes>&> && ...),
+			"Expected all arguments to be convertible to FStringFormatArg");
+
+		using FFormatter = ErrorContextPrivate::TFrameFormatter<ErrorContextPrivate::TCapturedArg<ArgTypes>...>;
+		Frames.Add({File, Line, MakeShared<FFormatter, ESPMode::ThreadSafe>(Format, Forward<ArgTypes>(Args)...)});
+	}
+
+	/// Adds the frames of Outer after the frames of this context, i.e. Outer describes the operation this error
+	/// happened in.
+	FErrorContext WithContext(FErrorContext&& Outer) &&;
+
+	/// Frames from the innermost (where the error originated) to the outermost
+	const TArray<FFrame, TInlineAllocator<2>>& GetFrames() const
+	{
+		return Frames;
+	}
+
+	/// Formats all frames, outermost first, e.g.
+	/// <pre>
+	///		Loading config of Level01 (Config.cpp:42)
+	///			caused by: File Level01.ini not found (Config.cpp:12)
+	/// </pre>
+	FString ToString() const;
+
+private:
+	TArray<FFrame, TInlineAllocator<2>> Frames;
+};
+
+/// Returns a function to be passed to TResult::OrElse, which wraps the error context in a frame created by MakeOuter.
+/// MakeOuter is only called if there is an error. See also ZKZ_ADD_ERROR_CONTEXT.
+template <class ValueType, class FunctionType>
+auto AddErrorContext(FunctionType&& MakeOuter)
+{
+	return [MakeOuter = Forward<FunctionType>(MakeOuter)](FErrorContext Error) mutable
+	{ return TResult<ValueType, FErrorContext>{Unexpect, MoveTemp(Error).WithContext(::Invoke(MakeOuter))}; };
+}
+
+}  // namespace Zkz
+
+/// Creates an FErrorContext with a single frame at the current source location. Format must be a string literal,
+/// the arguments are captured by value and formatted only if the context is rendered.
+#define ZKZ_ERROR_CONTEXT(Format, ...) (::Zkz::FErrorContext{__FILE__, __LINE__, TEXT(Format), ##__VA_ARGS__})
+
+/// Function for TResult<ValueType, FErrorContext>::OrElse adding a frame at the current source location to the error.
+/// The arguments are captured by reference and only copied if there is an error.
+#define ZKZ_ADD_ERROR_CONTEXT(ValueType, Format, ...) \
+	(::Zkz::AddErrorContext<ValueType>([&] { return ZKZ_ERROR_CONTEXT(Format, ##__VA_ARGS__); }))
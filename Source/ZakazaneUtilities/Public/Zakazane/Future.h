@@ -5,8 +5,14 @@
 #include "CoreMinimal.h"
 
 #include "Async/Future.h"
+#include "FutureRegistry.h"
 #include "Result.h"
 #include "ReturnIfMacros.h"
+#include "SmallObjectPool.h"
+#include "TimerWheel.h"
+#include "Trampoline.h"
+
+#include <atomic>
 
 namespace Zkz
 {
@@ -25,15 +31,173 @@ struct FPromiseCanceled
 
 constexpr FPromiseCanceled PromiseCanceled;
 
+/// Error meaning the future was not fulfilled in the time given to WithTimeout.
+struct FTimeout
+{
+};
+
 template <class T>
 using TCancelableFuture = TFutureResult<T, FPromiseCanceled>;
 
 template <class T>
 using TCancelableFutureResult = TResult<T, FPromiseCanceled>;
 
-// #TODO #Promise: Review usages of TPromise and potentially replace with TScopedPromise
-/// Wrapper for TPromise gracefully handling destruction prior to being fulfilled. The internal promise is
-/// TResultPromise<T, FPromiseCancelled> and if the promise gets destroyed, the set value is
+// FPromiseCanceled is empty, so it takes no space in the result
+static_assert(sizeof(TCancelableFutureResult<void>) == sizeof(bool));
+static_assert(sizeof(TCancelableFutureResult<UObject*>) == sizeof(UObject*));
+
+namespace FuturePrivate
+{
+
+/// Type stored in TFutureState for a TFuture<T>, mirrors the engine's TPromise
+template <class T>
+using TFutureStateValueType = std::conditional_t<
+	std::is_void_v<T>,
+	int,
+	std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T>*, T>>;
+
+/// Reference controller holding the future state inline, same as the engine's intrusive reference controller used by
+/// MakeShared, but allocated from the small object pool.
+template <class StateType>
+class TPooledFutureStateController final : public SharedPointerInternals::TReferenceControllerBase<ESPMode::ThreadSafe>
+{
+public:
+	template <class... ArgTypes>
+	explicit TPooledFutureStateController(ArgTypes&&... Args)
+	{
+		new (Storage.GetTypedPtr()) StateType(Forward<ArgTypes>(Args)...);
+	}
+
+	StateType* GetStatePtr()
+	{
+		return Storage.GetTypedPtr();
+	}
+
+	virtual void DestroyObject() override
+	{
+		DestructItem(Storage.GetTypedPtr());
+	}
+
+	static void* operator new(const SIZE_T Size)
+	{
+		return SmallObjectPool::Allocate(Size);
+	}
+
+	static void operator delete(void* const Ptr, const SIZE_T Size)
+	{
+		SmallObjectPool::Free(Ptr, Size);
+	}
+
+private:
+	TTypeCompatibleBytes<StateType> Storage;
+
+	static_assert(alignof(StateType) <= SmallObjectPool::BlockAlignment);
+};
+
+template <class StateType, class... ArgTypes>
+TSharedRef<StateType, ESPMode::ThreadSafe> MakePooledFutureState(ArgTypes&&... Args)
+{
+	auto* const Controller = new TPooledFutureStateController<StateType>(Forward<ArgTypes>(Args)...);
+	return UE::Core::Private::MakeSharedRef<StateType, ESPMode::ThreadSafe>(Controller->GetStatePtr(), Controller);
+}
+
+}  // namespace FuturePrivate
+
+/// Drop-in replacement for TPromise with the shared state allocated from SmallObjectPool instead of the general
+/// purpose allocator. Promises are created for every continuation in a chain, so recycling their memory avoids most
+/// allocator traffic in future-heavy code. Like TPromise, the promise must be fulfilled before being destroyed.
+template <class T>
+class TPooledPromise
+{
+public:
+	TPooledPromise() : State{FuturePrivate::MakePooledFutureState<FState>()}
+	{
+	}
+
+	explicit TPooledPromise(TUniqueFunction<void()>&& CompletionCallback)
+		: State{FuturePrivate::MakePooledFutureState<FState>(MoveTemp(CompletionCallback))}
+	{
+	}
+
+	TPooledPromise(TPooledPromise&& Other) = default;
+
+	TPooledPromise& operator=(TPooledPromise&& Other)
+	{
+		ZKZ_RETURN_IF(this == &Other, *this);
+
+		CheckFulfilledIfValid();
+		State = MoveTemp(Other.State);
+		bFutureRetrieved = Other.bFutureRetrieved;
+		return *this;
+	}
+
+	~TPooledPromise()
+	{
+		CheckFulfilledIfValid();
+	}
+
+	/// Returns false if the promise has been moved from
+	bool IsValid() const
+	{
+		return State.IsValid();
+	}
+
+	bool IsFulfilled() const
+	{
+		return State.IsValid() && State->IsComplete();
+	}
+
+	TFuture<T> GetFuture()
+	{
+		check(State.IsValid() && !bFutureRetrieved);
+		bFutureRetrieved = true;
+		return TFuture<T>(State);
+	}
+
+	template <class... ArgTypes>
+	void EmplaceValue(ArgTypes&&... Args)
+	{
+		check(State.IsValid());
+
+		if constexpr (std::is_void_v<T>)
+		{
+			static_assert(sizeof...(ArgTypes) == 0);
+			State->EmplaceResult(0);
+		}
+		else if constexpr (std::is_reference_v<T>)
+		{
+			static_assert(sizeof...(ArgTypes) == 1);
+			State->EmplaceResult(&Args...);
+		}
+		else
+		{
+			State->EmplaceResult(Forward<ArgTypes>(Args)...);
+		}
+	}
+
+	template <class... ArgTypes>
+	void SetValue(ArgTypes&&... Args)
+	{
+		EmplaceValue(Forward<ArgTypes>(Args)...);
+	}
+
+private:
+	using FState = TFutureState<FuturePrivate::TFutureStateValueType<T>>;
+
+	TSharedPtr<FState, ESPMode::ThreadSafe> State;
+
+	bool bFutureRetrieved = false;
+
+	void CheckFulfilledIfValid() const
+	{
+		// Same as TPromise, broken promises are considered programming errors. Use TScopedPromise if the promise may be
+		// destroyed without being fulfilled.
+		check(!State.IsValid() || State->IsComplete());
+	}
+};
+
+/// Wrapper for TPooledPromise gracefully handling destruction prior to being fulfilled. The internal promise is
+/// TPooledPromise<TResult<T, FPromiseCancelled>> and if the promise gets destroyed, the set value is
 /// an error result.
 template <class T>
 class TScopedPromise
@@ -45,49 +209,55 @@ public:
 	{
 	}
 
-	TScopedPromise(TScopedPromise&& Other) : Promise{MoveTemp(Other.Promise)}, bFulfilled{MoveTemp(Other.bFulfilled)}
+	/// Records the creation site in the future registry, pass ZKZ_PROMISE_SITE. Same as the default constructor if the
+	/// registry is disabled.
+	explicit TScopedPromise(const FutureRegistry::FCreationSite& Site)
+#if ZKZ_WITH_FUTURE_REGISTRY
+		: Registration{Site}
+#endif
 	{
-		Other.bFulfilled = true;
 	}
 
+	TScopedPromise(TScopedPromise&& Other) = default;
+
 	TScopedPromise& operator=(TScopedPromise&& Other)
 	{
 		ZKZ_RETURN_IF(this == &Other, *this);
 
+		Cancel();
 		Promise = MoveTemp(Other.Promise);
-		bFulfilled = Other.bFulfilled;
-
-		Other.bFulfilled = true;
+#if ZKZ_WITH_FUTURE_REGISTRY
+		Registration = MoveTemp(Other.Registration);
+#endif
 		return *this;
 	}
 
 	~TScopedPromise()
 	{
-		// #TODO #Promise: Should have IsFulfilled in TPromise (push request)
 		Cancel();
 	}
 
 	void Cancel()
 	{
-		if (!bFulfilled)
+		if (Promise.IsValid() && !Promise.IsFulfilled())
 		{
-			bFulfilled = true;
 			Promise.EmplaceValue(Unexpect, PromiseCanceled);
+			OnFulfilled();
 		}
 	}
 
 	template <class... ArgTypes>
 	void EmplaceValue(ArgTypes&&... Args)
 	{
-		bFulfilled = true;
 		Promise.EmplaceValue(InPlace, Forward<ArgTypes>(Args)...);
+		OnFulfilled();
 	}
 
 	template <class ValueType UE_REQUIRES(!std::is_void_v<T>)>
 	void SetValue(ValueType&& Value)
 	{
-		bFulfilled = true;
 		Promise.EmplaceValue(InPlace, Forward<ValueType>(Value));
+		OnFulfilled();
 	}
 
 	TCancelableFuture<T> GetFuture()
@@ -96,13 +266,22 @@ public:
 	}
 
 private:
-	TResultPromise<T, FPromiseCanceled> Promise;
+	TPooledPromise<TCancelableFutureResult<T>> Promise;
+
+#if ZKZ_WITH_FUTURE_REGISTRY
+	FutureRegistry::FRegistration Registration{FutureRegistry::FCreationSite{}};
+#endif
 
-	bool bFulfilled = false;
+	void OnFulfilled()
+	{
+#if ZKZ_WITH_FUTURE_REGISTRY
+		Registration.Complete();
+#endif
+	}
 };
 
 /// Helper function similar to Next, but only calls the continuation function if the future result does not hold a
-/// canceled promise error.
+/// canceled promise error. The continuation is run through the trampoline, see Trampoline::Run.
 template <class T, class FunctionType UE_REQUIRES(!std::is_void_v<T> && TIsInvocable<FunctionType, T>::Value)>
 void IfNotCanceled(TCancelableFuture<T> CancelableFuture, FunctionType F)
 {
@@ -110,7 +289,8 @@ void IfNotCanceled(TCancelableFuture<T> CancelableFuture, FunctionType F)
 		[F = MoveTemp(F)](TResult<T, FPromiseCanceled> Result) mutable
 		{
 			ZKZ_RETURN_IF(!Result.HasValue());
-			F(MoveTemp(Result).GetValue());
+			Trampoline::Run([F = MoveTemp(F), Value = MoveTemp(Result).GetValue()]() mutable
+							{ F(MoveTemp(Value)); });
 		});
 }
 
@@ -121,12 +301,13 @@ void IfNotCanceled(TCancelableFuture<void> CancelableFuture, FunctionType F)
 		[F = MoveTemp(F)](const TResult<void, FPromiseCanceled> Result) mutable
 		{
 			ZKZ_RETURN_IF(!Result.HasValue());
-			F();
+			Trampoline::Run(MoveTemp(F));
 		});
 }
 
 /// Like TFuture::Next, but returns another TFuture for chaining. The TFuture type depends on the value returned by the provided
-/// function. This has overhead, just use TFuture::Next if you don't need chaining.
+/// function. This has overhead, just use TFuture::Next if you don't need chaining. Continuations are run through the
+/// trampoline, so arbitrarily long chains of ready futures don't nest on the stack.
 /// Example:
 /// <pre>
 ///			TFuture<int> FutureInt = FunctionReturningFutureInt();
@@ -149,21 +330,28 @@ template <class T, class FunctionType UE_REQUIRES(TIsInvocable<FunctionType, T>:
 	-> TFuture<decltype(::Invoke(Continuation, DeclVal<T>()))>
 {
 	using FContinuationResult = decltype(::Invoke(Continuation, DeclVal<T>()));
-	TPromise<FContinuationResult> ChainPromise;
+	TPooledPromise<FContinuationResult> ChainPromise;
 	auto ChainFuture = ChainPromise.GetFuture();
 
 	Future.Next(
 		[ChainPromise = MoveTemp(ChainPromise), Continuation = MoveTemp(Continuation)](T Value) mutable
 		{
-			if constexpr (std::is_same_v<FContinuationResult, void>)
-			{
-				::Invoke(Continuation, Forward<T>(Value));
-				ChainPromise.EmplaceValue();
-			}
-			else
-			{
-				ChainPromise.EmplaceValue(::Invoke(Continuation, Forward<T>(Value)));
-			}
+			// The tuple keeps the value a reference if T is a reference type
+			Trampoline::Run(
+				[ChainPromise = MoveTemp(ChainPromise),
+				 Continuation = MoveTemp(Continuation),
+				 Value = TTuple<T>{Forward<T>(Value)}]() mutable
+				{
+					if constexpr (std::is_same_v<FContinuationResult, void>)
+					{
+						::Invoke(Continuation, Forward<T>(Value.template Get<0>()));
+						ChainPromise.EmplaceValue();
+					}
+					else
+					{
+						ChainPromise.EmplaceValue(::Invoke(Continuation, Forward<T>(Value.template Get<0>())));
+					}
+				});
 		});
 
 	return ChainFuture;
@@ -173,21 +361,25 @@ template <class FunctionType UE_REQUIRES(TIsInvocable<FunctionType>::Value)>
 [[nodiscard]] auto Next(TFuture<void> Future, FunctionType Continuation) -> TFuture<decltype(::Invoke(Continuation))>
 {
 	using FContinuationResult = decltype(::Invoke(Continuation));
-	TPromise<FContinuationResult> ChainPromise;
+	TPooledPromise<FContinuationResult> ChainPromise;
 	auto ChainFuture = ChainPromise.GetFuture();
 
 	Future.Next(
 		[ChainPromise = MoveTemp(ChainPromise), Continuation = MoveTemp(Continuation)]() mutable
 		{
-			if constexpr (std::is_same_v<FContinuationResult, void>)
-			{
-				::Invoke(Continuation);
-				ChainPromise.EmplaceValue();
-			}
-			else
-			{
-				ChainPromise.EmplaceValue(::Invoke(Continuation));
-			}
+			Trampoline::Run(
+				[ChainPromise = MoveTemp(ChainPromise), Continuation = MoveTemp(Continuation)]() mutable
+				{
+					if constexpr (std::is_same_v<FContinuationResult, void>)
+					{
+						::Invoke(Continuation);
+						ChainPromise.EmplaceValue();
+					}
+					else
+					{
+						ChainPromise.EmplaceValue(::Invoke(Continuation));
+					}
+				});
 		});
 
 	return ChainFuture;
@@ -203,6 +395,103 @@ TFuture<TResult<T, E>> CollapseFutureCanceledToError(TCancelableFuture<TResult<T
 		});
 }
 
+namespace FuturePrivate
+{
+
+template <class T>
+struct TTimeoutState
+{
+	std::atomic<bool> bResolved{false};
+	FTimerWheelHandle TimerHandle;
+	TPooledPromise<TResult<T, FTimeout>> Promise;
+
+	~TTimeoutState()
+	{
+		// Neither the producer nor the timer resolved the future, which happens if the timer wheel gets shut down
+		if (TryResolve())
+		{
+			Promise.EmplaceValue(Unexpect, FTimeout{});
+		}
+	}
+
+	/// Returns true for the first caller only, who is then responsible for fulfilling the promise
+	bool TryResolve()
+	{
+		return !bResolved.exchange(true, std::memory_order_acq_rel);
+	}
+
+	/// Removes the timer from the wheel, unless the wheel is gone
+	void CancelTimer(const TWeakPtr<FTimerWheel, ESPMode::ThreadSafe>& WeakTimerWheel) const
+	{
+		if (const TSharedPtr<FTimerWheel, ESPMode::ThreadSafe> TimerWheel = WeakTimerWheel.Pin())
+		{
+			TimerWheel->Cancel(TimerHandle);
+		}
+	}
+};
+
+}  // namespace FuturePrivate
+
+/// Returns a future holding the value of the given future if it is fulfilled within Timeout, or an FTimeout error
+/// otherwise. The given future is not affected by the timeout, its producer may still fulfil it later.
+/// Timeouts are tracked by a timer wheel (the shared one, ticked by its own thread, by default), so a pending timeout
+/// costs a single timer entry and is removed in O(1) when the future is fulfilled in time.
+/// The wheel is only referenced weakly, so it may be released (e.g. the shared one at shutdown) while timeouts are
+/// pending. Without a wheel (such as after FTimerWheel::ShutdownShared) the timeout never fires.
+/// For cancelable futures T is TCancelableFutureResult, use CollapseNestedResults if a flat result is preferred.
+template <class T>
+TFutureResult<T, FTimeout> WithTimeout(
+	TFuture<T> Future,
+	const FTimespan Timeout,
+	const TSharedPtr<FTimerWheel, ESPMode::ThreadSafe>& TimerWheel = FTimerWheel::GetShared())
+{
+	static_assert(!std::is_reference_v<T>, "References are not supported");
+
+	using FState = FuturePrivate::TTimeoutState<T>;
+
+	const TSharedRef<FState, ESPMode::ThreadSafe> State = MakeShared<FState, ESPMode::ThreadSafe>();
+	TFutureResult<T, FTimeout> TimeoutFuture = State->Promise.GetFuture();
+
+	// The timer handle is set before the continuation is registered, so the continuation can always cancel the timer
+	if (TimerWheel.IsValid())
+	{
+		State->TimerHandle = TimerWheel->Schedule(
+			Timeout,
+			[State]
+			{
+				if (State->TryResolve())
+				{
+					State->Promise.EmplaceValue(Unexpect, FTimeout{});
+				}
+			});
+	}
+
+	const TWeakPtr<FTimerWheel, ESPMode::ThreadSafe> WeakTimerWheel = TimerWheel;
+
+	if constexpr (std::is_void_v<T>)
+	{
+		Future.Next(
+			[State, WeakTimerWheel]
+			{
+				ZKZ_RETURN_IF(!State->TryResolve());
+				State->CancelTimer(WeakTimerWheel);
+				State->Promise.EmplaceValue();
+			});
+	}
+	else
+	{
+		Future.Next(
+			[State, WeakTimerWheel](T Value)
+			{
+				ZKZ_RETURN_IF(!State->TryResolve());
+				State->CancelTimer(WeakTimerWheel);
+				State->Promise.EmplaceValue(InPlace, MoveTemp(Value));
+			});
+	}
+
+	return TimeoutFuture;
+}
+
 namespace AggregateFuturesPrivate
 {
 
@@ -217,7 +506,7 @@ auto DoAggregateFutures(
 	// ** calls aggregate futures for (result from line above, {Fut1, Fut2}) recursively
 	// ** sets a Next handler for that call to fulfil the result promise
 
-	TPromise<ResultType> Promise;
+	TPooledPromise<ResultType> Promise;
 	auto AggregatedFuture = Promise.GetFuture();
 
 	if (Futures.IsEmpty())
@@ -228,18 +517,37 @@ auto DoAggregateFutures(
 
 	auto& Head = Futures[0];
 
+	// Both handlers run through the trampoline, otherwise ready futures would recurse once per element
 	Head.Next(
 		[Tail = Futures.RightChop(1),
 		 Promise = MoveTemp(Promise),
 		 Initial = Forward<ResultType>(Initial),
 		 AggregateFunc = MoveTemp(AggregateFunc)]<class FutureResultType>(FutureResultType&& FutureResult) mutable
 		{
-			DoAggregateFutures(
-				MoveTemp(Tail),
-				::Invoke(AggregateFunc, Forward<ResultType>(Initial), Forward<FutureResultType>(FutureResult)),
-				MoveTemp(AggregateFunc))
-				.Next([Promise = MoveTemp(Promise)]<class FinalResultType>(FinalResultType&& FinalResult) mutable
-					  { Promise.EmplaceValue(Forward<FinalResultType>(FinalResult)); });
+			Trampoline::Run(
+				[Tail,
+				 Promise = MoveTemp(Promise),
+				 Initial = Forward<ResultType>(Initial),
+				 AggregateFunc = MoveTemp(AggregateFunc),
+				 FutureResult = TTuple<FutureResultType>{Forward<FutureResultType>(FutureResult)}]() mutable
+				{
+					DoAggregateFutures(
+						MoveTemp(Tail),
+						::Invoke(
+							AggregateFunc,
+							Forward<ResultType>(Initial),
+							Forward<FutureResultType>(FutureResult.template Get<0>())),
+						MoveTemp(AggregateFunc))
+						.Next(
+							[Promise = MoveTemp(Promise)]<class FinalResultType>(FinalResultType&& FinalResult) mutable
+							{
+								Trampoline::Run(
+									[Promise = MoveTemp(Promise),
+									 FinalResult =
+										 TTuple<FinalResultType>{Forward<FinalResultType>(FinalResult)}]() mutable
+									{ Promise.EmplaceValue(Forward<FinalResultType>(FinalResult.template Get<0>())); });
+							});
+				});
 		});
 
 	return AggregatedFuture;
@@ -262,7 +570,7 @@ auto AggregateFutures(TArray<TFuture<FutureType>> Futures, ResultType&& Initial,
 	// here (need to be kept alive in the Next handler until the whole set is ready) but we can offset into it using
 	// array view. The initial Futures array is kept alive by that last Next handler
 
-	TPromise<ResultType> Promise;
+	TPooledPromise<ResultType> Promise;
 	auto AggregatedFuture = Promise.GetFuture();
 
 	DoAggregateFutures(MakeArrayView(Futures), Forward<ResultType>(Initial), Forward<AggregateFuncType>(AggregateFunc))
@@ -0,0 +1,89 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// Registry of pending TScopedPromise instances, useful for finding out what a stalled load is waiting on. Enable it by
+/// defining ZKZ_WITH_FUTURE_REGISTRY=1 (see ZakazaneUtilities.Build.cs). When disabled, nothing gets registered and
+/// TScopedPromise has no additional members.
+///
+/// Console commands (only when enabled):
+/// - Zkz.Futures.DumpPending [MaxEntries] - lists the oldest pending promises with their creation site and age
+/// - Zkz.Futures.DumpLifetimes - prints a histogram of the time it took to fulfil or cancel promises
+///
+/// A promise's future is pending exactly as long as the promise is, so registering promises also covers the
+/// TCancelableFuture instances created from them.
+#ifndef ZKZ_WITH_FUTURE_REGISTRY
+#define ZKZ_WITH_FUTURE_REGISTRY 0
+#endif
+
+/// Creation site of a promise, pass it to the TScopedPromise constructor. Promises created without it are listed as
+/// created at an unknown site.
+#if ZKZ_WITH_FUTURE_REGISTRY
+#define ZKZ_PROMISE_SITE (::Zkz::FutureRegistry::FCreationSite{__FILE__, __LINE__, __FUNCTION__})
+#else
+#define ZKZ_PROMISE_SITE (::Zkz::FutureRegistry::FCreationSite{})
+#endif
+
+namespace Zkz::FutureRegistry
+{
+
+struct FCreationSite
+{
+#if ZKZ_WITH_FUTURE_REGISTRY
+	const ANSICHAR* File = nullptr;
+	int32 Line = 0;
+	const ANSICHAR* Function = nullptr;
+#endif
+};
+
+#if ZKZ_WITH_FUTURE_REGISTRY
+
+struct FPendingEntry
+{
+	FCreationSite Site;
+	double AgeSeconds = 0.0;
+};
+
+/// Lifetime histogram bucket 0 counts lifetimes under 1 ms, bucket N counts lifetimes in [2^(N-1), 2^N) ms. The last
+/// bucket also counts everything longer.
+constexpr int32 NumLifetimeBuckets = 22;
+
+using FLifetimeHistogram = TStaticArray<int64, NumLifetimeBuckets>;
+
+/// Registration of a single promise, unregistered when completed or destroyed.
+class ZAKAZANEUTILITIES_API FRegistration
+{
+public:
+	explicit FRegistration(const FCreationSite& Site);
+
+	FRegistration(FRegistration&& Other);
+	FRegistration& operator=(FRegistration&& Other);
+
+	FRegistration(const FRegistration&) = delete;
+	FRegistration& operator=(const FRegistration&) = delete;
+
+	~FRegistration();
+
+	/// Unregisters and records the lifetime. Does nothing if already completed.
+	void Complete();
+
+private:
+	uint64 Id = 0;
+};
+
+ZAKAZANEUTILITIES_API int32 GetNumPending();
+
+/// Returns up to MaxEntries pending promises, oldest first
+ZAKAZANEUTILITIES_API TArray<FPendingEntry> GetOldestPending(int32 MaxEntries);
+
+ZAKAZANEUTILITIES_API FLifetimeHistogram GetLifetimeHistogram();
+
+ZAKAZANEUTILITIES_API void DumpPending(FOutputDevice& Output, int32 MaxEntries);
+
+ZAKAZANEUTILITIES_API void DumpLifetimes(FOutputDevice& Output);
+
+#endif
+
+}  // namespace Zkz::FutureRegistry
@@ -0,0 +1,204 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Async/ParallelFor.h"
+#include "Future.h"
+#include "Result.h"
+#include "ReturnIfMacros.h"
+#include "Tasks/Task.h"
+
+#include <atomic>
+#include <type_traits>
+
+namespace Zkz
+{
+
+/// What CollectResults does once an error is returned
+enum class ECollectResultsMode : uint8
+{
+	/// Stops all workers as soon as possible and returns the first error found
+	FirstError,
+	/// Keeps calling the function for all elements and returns all errors, in input order
+	AllErrors,
+};
+
+namespace ParallelPrivate
+{
+
+/// Returns the number of chunks a job over NumElements elements should be split into, based on the number of worker
+/// threads.
+ZAKAZANEUTILITIES_API int32 GetNumChunks(int32 NumElements);
+
+template <class InType, class OutType, class FunctionType>
+struct TParallelTransformJob
+{
+	TParallelTransformJob(const TArrayView<InType> InInput, FunctionType&& InFunc, const int32 NumChunks)
+		: Input{InInput}, Func{MoveTemp(InFunc)}, NumPendingChunks{NumChunks}
+	{
+		Output.SetNumUninitialized(Input.Num());
+	}
+
+	void RunChunk(const int32 Begin, const int32 End)
+	{
+		OutType* const OutputData = Output.GetData();
+		for (int32 Idx = Begin; Idx < End; ++Idx)
+		{
+			new (OutputData + Idx) OutType(::Invoke(Func, Input[Idx]));
+		}
+
+		if (NumPendingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			Promise.SetValue(MoveTemp(Output));
+		}
+	}
+
+	TArrayView<InType> Input;
+	FunctionType Func;
+	TArray<OutType> Output;
+	std::atomic<int32> NumPendingChunks;
+	TPooledPromise<TArray<OutType>> Promise;
+};
+
+template <class ErrorType>
+struct TCollectResultsChunk
+{
+	/// Values are constructed in place for a prefix of the chunk, up to the first error seen by any worker
+	int32 NumConstructed = 0;
+	TArray<ErrorType> Errors;
+};
+
+}  // namespace ParallelPrivate
+
+/// Calls Func for each element of Input on worker threads and returns a future holding the results, in input order.
+/// The input is split into contiguous chunks, one per worker thread, and each result is constructed in place in the
+/// output array, so there is a single future for the whole job regardless of the input size.
+/// Func is called concurrently from multiple threads and must be safe to do so. The data referenced by Input must stay
+/// alive until the returned future is ready.
+template <
+	class InType,
+	class FunctionType,
+	class OutType = std::decay_t<decltype(::Invoke(DeclVal<FunctionType&>(), DeclVal<InType&>()))>>
+TFuture<TArray<OutType>> ParallelTransformAsync(const TArrayView<InType> Input, FunctionType Func)
+{
+	using FJob = ParallelPrivate::TParallelTransformJob<InType, OutType, FunctionType>;
+
+	if (Input.IsEmpty())
+	{
+		TPooledPromise<TArray<OutType>> Promise;
+		TFuture<TArray<OutType>> Future = Promise.GetFuture();
+		Promise.SetValue(TArray<OutType>{});
+		return Future;
+	}
+
+	const int32 NumChunks = ParallelPrivate::GetNumChunks(Input.Num());
+	const TSharedRef<FJob, ESPMode::ThreadSafe> Job =
+		MakeShared<FJob, ESPMode::ThreadSafe>(Input, MoveTemp(Func), NumChunks);
+	TFuture<TArray<OutType>> Future = Job->Promise.GetFuture();
+
+	for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+	{
+		const int32 Begin = static_cast<int32>(static_cast<int64>(Input.Num()) * ChunkIdx / NumChunks);
+		const int32 End = static_cast<int32>(static_cast<int64>(Input.Num()) * (ChunkIdx + 1) / NumChunks);
+
+		UE::Tasks::Launch(TEXT("Zkz::ParallelTransformAsync"), [Job, Begin, End] { Job->RunChunk(Begin, End); });
+	}
+
+	return Future;
+}
+
+/// Calls Func, returning a TResult, for each element of Input in parallel chunks (see ParallelTransformAsync) and
+/// blocks until done. Returns all the values in input order if all calls succeeded, otherwise the error(s) according to
+/// Mode. The value array is allocated once up front and the values are moved directly into place.
+/// Func is called concurrently from multiple threads and must be safe to do so.
+template <
+	class InType,
+	class FunctionType,
+	class ResultType = std::decay_t<decltype(::Invoke(DeclVal<FunctionType&>(), DeclVal<InType&>()))>,
+	class ValueType = typename ResultType::ValueType,
+	class ErrorType = typename ResultType::ErrorType UE_REQUIRES(IsResult<ResultType> && !std::is_void_v<ValueType>)>
+TResult<TArray<ValueType>, TArray<ErrorType>> CollectResults(
+	const TArrayView<InType> Input, FunctionType Func, const ECollectResultsMode Mode = ECollectResultsMode::FirstError)
+{
+	using FChunk = ParallelPrivate::TCollectResultsChunk<ErrorType>;
+
+	const int32 NumChunks = ParallelPrivate::GetNumChunks(Input.Num());
+
+	TArray<ValueType> Values;
+	Values.Reserve(Input.Num());
+	ValueType* const ValuesData = Values.GetData();
+
+	TArray<FChunk> Chunks;
+	Chunks.SetNum(NumChunks);
+
+	std::atomic<bool> bFailed{false};
+
+	ParallelFor(
+		NumChunks,
+		[&](const int32 ChunkIdx)
+		{
+			FChunk& Chunk = Chunks[ChunkIdx];
+			const int32 Begin = static_cast<int32>(static_cast<int64>(Input.Num()) * ChunkIdx / NumChunks);
+			const int32 End = static_cast<int32>(static_cast<int64>(Input.Num()) * (ChunkIdx + 1) / NumChunks);
+
+			bool bStoreValues = true;
+			for (int32 Idx = Begin; Idx < End; ++Idx)
+			{
+				// Values are not needed anymore once anything failed
+				if (bFailed.load(std::memory_order_relaxed))
+				{
+					ZKZ_RETURN_IF(Mode == ECollectResultsMode::FirstError);
+					bStoreValues = false;
+				}
+
+				ResultType Result = ::Invoke(Func, Input[Idx]);
+
+				if (Result.HasError())
+				{
+					Chunk.Errors.Emplace(MoveTemp(Result).GetError());
+					bFailed.store(true, std::memory_order_relaxed);
+					bStoreValues = false;
+					ZKZ_RETURN_IF(Mode == ECollectResultsMode::FirstError);
+				}
+				else if (bStoreValues)
+				{
+					new (ValuesData + Idx) ValueType(MoveTemp(Result).GetValue());
+					++Chunk.NumConstructed;
+				}
+			}
+		});
+
+	if (!bFailed.load(std::memory_order_relaxed))
+	{
+		// All elements have been constructed, this only sets the number of elements
+		Values.SetNumUninitialized(Input.Num());
+		return Ok(MoveTemp(Values));
+	}
+
+	TArray<ErrorType> Errors;
+	for (int32 ChunkIdx = 0; ChunkIdx < NumChunks; ++ChunkIdx)
+	{
+		FChunk& Chunk = Chunks[ChunkIdx];
+		DestructItems(ValuesData + static_cast<int64>(Input.Num()) * ChunkIdx / NumChunks, Chunk.NumConstructed);
+
+		if (Mode == ECollectResultsMode::FirstError && !Errors.IsEmpty())
+		{
+			continue;
+		}
+
+		for (ErrorType& Error : Chunk.Errors)
+		{
+			Errors.Emplace(MoveTemp(Error));
+			if (Mode == ECollectResultsMode::FirstError)
+			{
+				break;
+			}
+		}
+	}
+
+	return TResult<TArray<ValueType>, TArray<ErrorType>>{Unexpect, MoveTemp(Errors)};
+}
+
+}  // namespace Zkz
@@ -24,6 +24,14 @@ struct FUnusedType
 	FUnusedType() = delete;
 };
 
+/// Reference to the error of a failed result being propagated to the caller, see ZKZ_TRY. The error is moved only once,
+/// directly into the returned result.
+template <class ErrorType>
+struct TErrorPropagation
+{
+	ErrorType&& Error;
+};
+
 }  // namespace ResultPrivate
 
 /// Type tag used to construct error TResults in-place
@@ -94,6 +102,275 @@ private:
 template <class ErrorType>
 TUnexpected(ErrorType) -> TUnexpected<ErrorType>;
 
+namespace ResultPrivate
+{
+
+/// How a TResult is laid out in memory. Results with empty error types don't need to store the error, so they can do
+/// with a flag instead of a variant discriminator, or with no flag at all if the value type has a spare bit pattern
+/// (a niche) to mark the error.
+enum class EResultLayout : uint8
+{
+	/// std::variant of the value and the error
+	Variant,
+	/// std::optional of the value, empty meaning error
+	OptionalValue,
+	/// The object pointer value itself, a reserved address meaning error
+	PointerNiche,
+	/// std::optional of the error, used by void results
+	OptionalError,
+	/// A single flag, used by void results with empty error types
+	ErrorFlag,
+};
+
+/// Empty error types are not stored, the instance is kept in an empty base instead.
+template <class ErrorType>
+constexpr bool IsCollapsibleError = std::is_empty_v<ErrorType> && std::is_trivially_copyable_v<ErrorType>
+									&& std::is_default_constructible_v<ErrorType> && !std::is_final_v<ErrorType>;
+
+template <class ValueType, class ErrorType>
+constexpr EResultLayout GetResultLayout()
+{
+	if constexpr (std::is_void_v<ValueType>)
+	{
+		return IsCollapsibleError<ErrorType> ? EResultLayout::ErrorFlag : EResultLayout::OptionalError;
+	}
+	else if constexpr (!IsCollapsibleError<ErrorType>)
+	{
+		return EResultLayout::Variant;
+	}
+	else if constexpr (std::is_pointer_v<ValueType> && std::is_object_v<std::remove_pointer_t<ValueType>>)
+	{
+		// Only object pointers, void and function pointers may legitimately hold any address, e.g. handles such as
+		// INVALID_HANDLE_VALUE
+		return EResultLayout::PointerNiche;
+	}
+	else
+	{
+		return EResultLayout::OptionalValue;
+	}
+}
+
+template <class ValueType, class ErrorType, EResultLayout Layout = GetResultLayout<ValueType, ErrorType>()>
+class TResultStorage;
+
+template <class ValueType, class ErrorType>
+class TResultStorage<ValueType, ErrorType, EResultLayout::Variant>
+{
+public:
+	constexpr TResultStorage() = default;
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FInPlace, ArgTypes&&... Args)
+		: Storage{std::in_place_index<0>, Forward<ArgTypes>(Args)...}
+	{
+	}
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FUnexpect, ArgTypes&&... Args)
+		: Storage{std::in_place_index<1>, InPlace, Forward<ArgTypes>(Args)...}
+	{
+	}
+
+	constexpr bool HasValue() const
+	{
+		return Storage.index() == 0;
+	}
+
+	constexpr ValueType& GetValue()
+	{
+		return std::get<0>(Storage);
+	}
+
+	constexpr const ValueType& GetValue() const
+	{
+		return std::get<0>(Storage);
+	}
+
+	constexpr ErrorType& GetError()
+	{
+		return std::get<1>(Storage).GetError();
+	}
+
+	constexpr const ErrorType& GetError() const
+	{
+		return std::get<1>(Storage).GetError();
+	}
+
+private:
+	// using std::variant because it's constexpr, unlike TVariant, hopefully all platforms implement this. If not,
+	// can switch to TVariant and strip constexpr from TResult ops.
+	std::variant<ValueType, TUnexpected<ErrorType>> Storage;
+};
+
+template <class ValueType, class ErrorType>
+class TResultStorage<ValueType, ErrorType, EResultLayout::OptionalValue> : private ErrorType
+{
+public:
+	constexpr TResultStorage()
+		requires std::is_default_constructible_v<ValueType>
+		: Value{std::in_place}
+	{
+	}
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FInPlace, ArgTypes&&... Args) : Value{std::in_place, Forward<ArgTypes>(Args)...}
+	{
+	}
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FUnexpect, ArgTypes&&... Args) : ErrorType(Forward<ArgTypes>(Args)...)
+	{
+	}
+
+	constexpr bool HasValue() const
+	{
+		return Value.has_value();
+	}
+
+	constexpr ValueType& GetValue()
+	{
+		return *Value;
+	}
+
+	constexpr const ValueType& GetValue() const
+	{
+		return *Value;
+	}
+
+	constexpr ErrorType& GetError()
+	{
+		return *this;
+	}
+
+	constexpr const ErrorType& GetError() const
+	{
+		return *this;
+	}
+
+private:
+	std::optional<ValueType> Value;
+};
+
+template <class ValueType, class ErrorType>
+class TResultStorage<ValueType, ErrorType, EResultLayout::PointerNiche> : private ErrorType
+{
+public:
+	constexpr TResultStorage() = default;
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FInPlace, ArgTypes&&... Args) : Value(Forward<ArgTypes>(Args)...)
+	{
+		check(Value != GetNiche());
+	}
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FUnexpect, ArgTypes&&... Args)
+		: ErrorType(Forward<ArgTypes>(Args)...), Value{GetNiche()}
+	{
+	}
+
+	constexpr bool HasValue() const
+	{
+		return Value != GetNiche();
+	}
+
+	constexpr ValueType& GetValue()
+	{
+		return Value;
+	}
+
+	constexpr const ValueType& GetValue() const
+	{
+		return Value;
+	}
+
+	constexpr ErrorType& GetError()
+	{
+		return *this;
+	}
+
+	constexpr const ErrorType& GetError() const
+	{
+		return *this;
+	}
+
+private:
+	ValueType Value = nullptr;
+
+	/// An object takes at least one byte and the address past it must be representable, so the last address is never
+	/// the address of an object and can't be a legitimate value. Forming it takes a reinterpret_cast, so unlike the other
+	/// layouts, pointer results can't be created or queried in constant expressions.
+	static ValueType GetNiche()
+	{
+		return reinterpret_cast<ValueType>(~UPTRINT{0});
+	}
+};
+
+template <class ErrorType>
+class TResultStorage<void, ErrorType, EResultLayout::OptionalError>
+{
+public:
+	constexpr TResultStorage() = default;
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FUnexpect, ArgTypes&&... Args) : Error{std::in_place, Forward<ArgTypes>(Args)...}
+	{
+	}
+
+	constexpr bool HasValue() const
+	{
+		return !Error.has_value();
+	}
+
+	constexpr ErrorType& GetError()
+	{
+		return *Error;
+	}
+
+	constexpr const ErrorType& GetError() const
+	{
+		return *Error;
+	}
+
+private:
+	// using std::optional because it's constexpr, unlike TOptional, hopefully all platforms implement this. If not,
+	// can switch to TOptional and strip constexpr from TResult ops.
+	std::optional<ErrorType> Error;
+};
+
+template <class ErrorType>
+class TResultStorage<void, ErrorType, EResultLayout::ErrorFlag> : private ErrorType
+{
+public:
+	constexpr TResultStorage() = default;
+
+	template <class... ArgTypes>
+	constexpr explicit TResultStorage(FUnexpect, ArgTypes&&... Args)
+		: ErrorType(Forward<ArgTypes>(Args)...), bHasError{true}
+	{
+	}
+
+	constexpr bool HasValue() const
+	{
+		return !bHasError;
+	}
+
+	constexpr ErrorType& GetError()
+	{
+		return *this;
+	}
+
+	constexpr const ErrorType& GetError() const
+	{
+		return *this;
+	}
+
+private:
+	bool bHasError = false;
+};
+
+}  // namespace ResultPrivate
+
 // #TODO #Result: GetValueOr etc
 
 /// Unreal-style port of std::expected (with small differences).
@@ -120,8 +397,7 @@ public:
 	/// Will construct the result with the value constructed in-place by calling the constructor with arguments
 	/// Arg1, Arg2.
 	template <class... ArgTypes>
-	constexpr explicit TResult(FInPlace, ArgTypes&&... Args)
-		: Value{std::in_place_type<ValueType>, Forward<ArgTypes>(Args)...}
+	constexpr explicit TResult(FInPlace, ArgTypes&&... Args) : Storage{InPlace, Forward<ArgTypes>(Args)...}
 	{
 	}
 
@@ -148,8 +424,7 @@ public:
 	/// Will construct the error with the error value constructed in-place by calling the constructor with arguments
 	/// Arg1, Arg2.
 	template <class... ArgTypes>
-	constexpr explicit TResult(FUnexpect, ArgTypes&&... Args)
-		: Value{std::in_place_type<TUnexpected<ErrorType>>, InPlace, Forward<ArgTypes>(Args)...}
+	constexpr explicit TResult(FUnexpect, ArgTypes&&... Args) : Storage{Unexpect, Forward<ArgTypes>(Args)...}
 	{
 	}
 
@@ -189,9 +464,17 @@ public:
 	{
 	}
 
+	/// Used by ZKZ_TRY and ZKZ_TRY_ASSIGN, not to be used in other cases.
+	template <class OtherErrorType UE_REQUIRES(std::is_constructible_v<ErrorType, OtherErrorType&&>)>
+	// ReSharper disable once CppNonExplicitConvertingConstructor
+	constexpr TResult(ResultPrivate::TErrorPropagation<OtherErrorType>&& Propagation)
+		: TResult{Unexpect, Forward<OtherErrorType>(Propagation.Error)}
+	{
+	}
+
 	constexpr bool HasValue() const
 	{
-		return std::holds_alternative<ValueType>(Value);
+		return Storage.HasValue();
 	}
 
 	constexpr bool HasError() const
@@ -202,7 +485,7 @@ public:
 	constexpr ValueType& GetValue() &
 	{
 		check(HasValue());
-		return std::get<ValueType>(Value);
+		return Storage.GetValue();
 	}
 
 	constexpr const ValueType& GetValue() const&
@@ -214,19 +497,19 @@ public:
 	constexpr ValueType&& GetValue() &&
 	{
 		check(HasValue());
-		return MoveTemp(std::get<ValueType>(Value));
+		return MoveTemp(Storage.GetValue());
 	}
 
 	constexpr const ValueType&& GetValue() const&&
 	{
 		check(HasValue());
-		return std::move(std::get<ValueType>(Value));
+		return std::move(Storage.GetValue());
 	}
 
 	constexpr ErrorType& GetError() &
 	{
 		check(HasError());
-		return std::get<TUnexpected<ErrorType>>(Value).GetError();
+		return Storage.GetError();
 	}
 
 	constexpr const ErrorType& GetError() const&
@@ -237,13 +520,13 @@ public:
 	constexpr ErrorType&& GetError() &&
 	{
 		check(HasError());
-		return std::move(std::get<TUnexpected<ErrorType>>(Value).GetError());
+		return std::move(Storage.GetError());
 	}
 
 	constexpr const ErrorType&& GetError() const&&
 	{
 		check(HasError());
-		return std::move(std::get<TUnexpected<ErrorType>>(Value).GetError());
+		return std::move(Storage.GetError());
 	}
 
 	template <class OtherValueType UE_REQUIRES(
@@ -348,9 +631,7 @@ public:
 	}
 
 private:
-	// using std::variant because it's constexpr, unlike TVariant, hopefully all platforms implement this. If not,
-	// can switch to TVariant and strip constexpr from TResult ops.
-	std::variant<ValueType, TUnexpected<ErrorType>> Value;
+	ResultPrivate::TResultStorage<ValueType, ErrorType> Storage;
 };
 
 template <class InErrorType>
@@ -379,7 +660,7 @@ public:
 	/// Will construct the error with the error value constructed in-place by calling the constructor with arguments
 	/// Arg1, Arg2.
 	template <class... ArgTypes>
-	constexpr explicit TResult(FUnexpect, ArgTypes&&... Args) : Error{std::in_place, Forward<ArgTypes>(Args)...}
+	constexpr explicit TResult(FUnexpect, ArgTypes&&... Args) : Storage{Unexpect, Forward<ArgTypes>(Args)...}
 	{
 	}
 
@@ -419,9 +700,17 @@ public:
 	{
 	}
 
+	/// Used by ZKZ_TRY and ZKZ_TRY_ASSIGN, not to be used in other cases.
+	template <class OtherErrorType UE_REQUIRES(std::is_constructible_v<ErrorType, OtherErrorType&&>)>
+	// ReSharper disable once CppNonExplicitConvertingConstructor
+	constexpr TResult(ResultPrivate::TErrorPropagation<OtherErrorType>&& Propagation)
+		: TResult{Unexpect, Forward<OtherErrorType>(Propagation.Error)}
+	{
+	}
+
 	constexpr bool HasValue() const
 	{
-		return !Error.has_value();
+		return Storage.HasValue();
 	}
 
 	constexpr bool HasError() const
@@ -432,7 +721,7 @@ public:
 	constexpr ErrorType& GetError() &
 	{
 		check(HasError());
-		return Error.value();
+		return Storage.GetError();
 	}
 
 	constexpr const ErrorType& GetError() const&
@@ -443,13 +732,13 @@ public:
 	constexpr ErrorType&& GetError() &&
 	{
 		check(HasError());
-		return MoveTemp(Error.value());
+		return MoveTemp(Storage.GetError());
 	}
 
 	constexpr const ErrorType&& GetError() const&&
 	{
 		check(HasError());
-		return std::move(Error.value());
+		return std::move(Storage.GetError());
 	}
 
 	/// If the result contains a:
@@ -502,9 +791,7 @@ public:
 	}
 
 private:
-	// using std::optional because it's constexpr, unlike TOptional, hopefully all platforms implement this. If not,
-	// can switch to TOptional and strip constexpr from TResult ops.
-	std::optional<ErrorType> Error;
+	ResultPrivate::TResultStorage<void, ErrorType> Storage;
 };
 
 template <class T>
@@ -513,6 +800,32 @@ constexpr bool IsResult = false;
 template <class ValueType, class ErrorType>
 constexpr bool IsResult<TResult<ValueType, ErrorType>> = true;
 
+namespace ResultPrivate
+{
+
+template <class ValueType, class ErrorType>
+constexpr TErrorPropagation<ErrorType> PropagateError(TResult<ValueType, ErrorType>&& Result)
+{
+	return {MoveTemp(Result).GetError()};
+}
+
+}  // namespace ResultPrivate
+
+namespace ResultPrivate
+{
+
+struct FEmptyErrorForLayoutChecks
+{
+};
+
+static_assert(sizeof(TResult<int32*, FEmptyErrorForLayoutChecks>) == sizeof(int32*));
+static_assert(sizeof(TResult<void*, FEmptyErrorForLayoutChecks>) == sizeof(std::optional<void*>));
+static_assert(sizeof(TResult<int32, FEmptyErrorForLayoutChecks>) == sizeof(std::optional<int32>));
+static_assert(sizeof(TResult<void, FEmptyErrorForLayoutChecks>) == sizeof(bool));
+static_assert(sizeof(TResult<void, int32>) == sizeof(std::optional<int32>));
+
+}  // namespace ResultPrivate
+
 /// Shorthand for instantiating a TResult with a value. Returned result has error type FUnusedType which is a special
 /// type that automatically converts to any other error type. This means you can for example
 /// <pre>
@@ -826,3 +1139,46 @@ constexpr auto TResult<void, InErrorType>::OrElse(FunctionType&& Function) const
 }
 
 }  // namespace Zkz
+
+/**
+ * Returns the error from the enclosing function if the result Expression holds an error. The error is
+ * moved (never copied) into the returned result and converted if the function's error type is constructible from it.
+ * Expression must be an rvalue, as the error is moved out of it. Named results have to be passed with MoveTemp, so
+ * moving from them is explicit. E.g.:
+ *
+ * TResult<void, FString> LoadAll()
+ * {
+ *     ZKZ_TRY(LoadConfig());
+ *     ZKZ_TRY(LoadLevel());
+ *     return Ok();
+ * }
+ */
+#define ZKZ_TRY(Expression)                                                                                 \
+	if (auto&& ZkzTryResult = (Expression); ZkzTryResult.HasError())                                        \
+	{                                                                                                       \
+		static_assert(!std::is_lvalue_reference_v<decltype(ZkzTryResult)>, ZKZ_TRY_PRIVATE_RVALUE_MESSAGE); \
+		return ::Zkz::ResultPrivate::PropagateError(MoveTemp(ZkzTryResult));                                \
+	}
+
+#define ZKZ_TRY_PRIVATE_RESULT PREPROCESSOR_JOIN(ZkzTryResult, __LINE__)
+#define ZKZ_TRY_PRIVATE_RVALUE_MESSAGE "The result is moved from, pass named results with MoveTemp"
+
+/**
+ * Same as ZKZ_TRY, but moves the value of a successful result into the given declaration. Expression must be an
+ * rvalue too.
+ * E.g.:
+ *
+ * TResult<int32, FString> GetMaxHealth()
+ * {
+ *     ZKZ_TRY_ASSIGN(const FConfig Config, LoadConfig());
+ *     return Config.MaxHealth;
+ * }
+ */
+#define ZKZ_TRY_ASSIGN(Declaration, Expression)                                                                   \
+	auto&& ZKZ_TRY_PRIVATE_RESULT = (Expression);                                                                 \
+	static_assert(!std::is_lvalue_reference_v<decltype(ZKZ_TRY_PRIVATE_RESULT)>, ZKZ_TRY_PRIVATE_RVALUE_MESSAGE); \
+	if (ZKZ_TRY_PRIVATE_RESULT.HasError())                                                                        \
+	{                                                                                                             \
+		return ::Zkz::ResultPrivate::PropagateError(MoveTemp(ZKZ_TRY_PRIVATE_RESULT));                            \
+	}                                                                                                             \
+	Declaration = MoveTemp(ZKZ_TRY_PRIVATE_RESULT).GetValue();
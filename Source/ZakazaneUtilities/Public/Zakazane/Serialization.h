@@ -21,8 +21,31 @@ enum class EImportResult
 	Success,
 };
 
-/// Exports objects of a given type to CSV. Current implementation only handles FText properties in a special
-/// manner (extracting the underlying string) and exports other types using the generic ExportText_Direct function.
+/// How ImportFromCSV imports rows
+enum class ECSVImportMode : uint8
+{
+	/// Rows are imported on the calling thread, one at a time
+	Serial,
+	/// Rows are imported on worker threads, in batches. LineCallback is called on the calling thread, in file order.
+	Parallel,
+	/// Same as Parallel, but LineCallback is called on the worker threads as soon as a row is imported, in any order.
+	/// LineCallback must be thread safe.
+	ParallelUnordered,
+};
+
+/// How ExportToCSV writes rows to archives
+enum class ECSVExportMode : uint8
+{
+	/// Rows are written on the calling thread
+	Serial,
+	/// Rows are encoded on worker threads, in chunks, and written to the archive in order by the calling thread
+	Parallel,
+};
+
+/// Exports objects of a given type to CSV. Numeric, bool, name, enum, string and text (exported as its underlying
+/// string) properties are converted directly, other types use the generic ExportText_Direct function. Floating point
+/// numbers are exported with as many digits as needed to import them exactly. Conversions are prepared once per struct
+/// and cached (for native structs), @see ImportFromCSV.
 /// Doesn't support containers at the moment. Add handling other property types (and/or containers) as necessary.
 ZAKAZANEUTILITIES_API FString ExportToCSV(const UStruct& Struct, TArrayView<const void*> Objects);
 
@@ -48,40 +71,226 @@ FString ExportToCSV(const TArrayView<const T> Objects)
 	return ExportToCSV(*T::StaticStruct(), Pointers);
 }
 
-/// Imports data of a given type from CSV. Current implementation only handles FText properties in a special
-/// manner (replacing the underlying string) and imports other types using the generic ImportText_Direct function.
+/// Streaming version of ExportToCSV(const UStruct& Struct, TArrayView<const void*> Objects). Rows are encoded as UTF-8
+/// (without a byte order mark) and written to the archive in chunks, so the whole CSV is never held in memory.
+/// Output is the same as the UTF-8 encoding of the string version and can be read back with the streaming
+/// ImportFromCSV.
+/// @param Mode - whether rows are encoded in parallel. In parallel mode, properties are exported on worker threads.
+/// @returns false if the archive reported an error
+ZAKAZANEUTILITIES_API bool ExportToCSV(
+	const UStruct& Struct,
+	TArrayView<const void*> Objects,
+	FArchive& Archive,
+	ECSVExportMode Mode = ECSVExportMode::Serial);
+
+/// @see ExportToCSV(const UStruct& Struct, TArrayView<const void*> Objects, FArchive& Archive, ECSVExportMode Mode)
+///
+/// Templated version for objects of known type.
+template <class T UE_REQUIRES(TIsUHTUStruct_v<T>)>
+bool ExportToCSV(
+	const TArrayView<const T> Objects, FArchive& Archive, const ECSVExportMode Mode = ECSVExportMode::Serial)
+{
+	TArray<const void*> Pointers;
+	Pointers.Reserve(Objects.Num());
+	Algo::Transform(Objects, Pointers, [](const T& Ref) { return &Ref; });
+
+	return ExportToCSV(*T::StaticStruct(), Pointers, Archive, Mode);
+}
+
+/// Streams the objects to the given file through ExportToCSV(const UStruct& Struct, TArrayView<const void*> Objects,
+/// FArchive& Archive, ECSVExportMode Mode). Returns false if the file couldn't be written.
+ZAKAZANEUTILITIES_API bool ExportToCSVFile(
+	const UStruct& Struct,
+	TArrayView<const void*> Objects,
+	const TCHAR* FileName,
+	ECSVExportMode Mode = ECSVExportMode::Serial);
+
+/// Imports data of a given type from CSV. Numeric, bool, name, enum, string and text (replacing the underlying string)
+/// properties are converted directly, other types and values the direct conversion doesn't recognize (e.g. out of
+/// range numbers) use the generic ImportText_Direct function, so the results are the same as with ImportText_Direct.
+/// Conversions are prepared once per struct and, for native structs, cached for the lifetime of the struct.
 /// Add handling other property types as necessary.
 ///
 /// @param LineCallback - callback function called for each imported object
 /// @param Output - optional output device for gathering error messages
 /// @param SlowTask - optional slow task to be ticked as task progresses. All import work sums up to 1.0f.
+/// @param Mode - whether rows are imported in parallel. In parallel modes, properties are imported on worker threads,
+/// so they mustn't need to find or load objects. Messages are logged to Output in file order regardless of the mode,
+/// but in batches, so not necessarily interleaved with LineCallback calls as in Serial mode.
 ZAKAZANEUTILITIES_API EImportResult ImportFromCSV(
 	const UStruct& Struct,
 	const FString& CSV,
 	const TFunction<void(const void*)>& LineCallback,
 	FOutputDevice* Output = nullptr,
-	FSlowTask* SlowTask = nullptr);
+	FSlowTask* SlowTask = nullptr,
+	ECSVImportMode Mode = ECSVImportMode::Serial);
 
 /// @see ImportFromCSV(
 /// 	const UStruct& Struct,
 /// 	const FString& CSV,
 /// 	const TFunction<void(const void*)>& LineCallback,
 /// 	FOutputDevice* Output = nullptr,
-/// 	FSlowTask* SlowTask = nullptr)
+/// 	FSlowTask* SlowTask = nullptr,
+/// 	ECSVImportMode Mode = ECSVImportMode::Serial)
 ///
 /// Templated version for objects of known type.
 template <
 	class T,
 	class LineCallbackType UE_REQUIRES(TIsUHTUStruct_v<T>&& TIsInvocable<LineCallbackType, const T&>::Value)>
 EImportResult ImportFromCSV(
-	const FString& CSV, LineCallbackType&& LineCallback, FOutputDevice* Output = nullptr, FSlowTask* SlowTask = nullptr)
+	const FString& CSV,
+	LineCallbackType&& LineCallback,
+	FOutputDevice* Output = nullptr,
+	FSlowTask* SlowTask = nullptr,
+	ECSVImportMode Mode = ECSVImportMode::Serial)
 {
 	return ImportFromCSV(
 		*T::StaticStruct(),
 		CSV,
 		[&LineCallback](const void* const Data) { LineCallback(*static_cast<const T*>(Data)); },
 		Output,
-		SlowTask);
+		SlowTask,
+		Mode);
 }
 
+/// Streaming version of ImportFromCSV(const UStruct& Struct, const FString& CSV, ...). The archive is read and
+/// tokenized in chunks and LineCallback is called as soon as each row is complete, so memory use doesn't depend on the
+/// size of the data. Quoted cells may contain commas, line breaks and escaped ("") quotes.
+/// The archive must be loading and know its size (as file and memory readers do). Data is read from the current
+/// position and may be UTF-8 or, if it starts with a byte order mark, UTF-16LE.
+/// Line numbers in messages count rows, not line breaks inside quoted cells.
+ZAKAZANEUTILITIES_API EImportResult ImportFromCSV(
+	const UStruct& Struct,
+	FArchive& Archive,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* Output = nullptr,
+	FSlowTask* SlowTask = nullptr,
+	ECSVImportMode Mode = ECSVImportMode::Serial);
+
+/// @see ImportFromCSV(const UStruct& Struct, FArchive& Archive, ...)
+///
+/// Templated version for objects of known type.
+template <
+	class T,
+	class LineCallbackType UE_REQUIRES(TIsUHTUStruct_v<T>&& TIsInvocable<LineCallbackType, const T&>::Value)>
+EImportResult ImportFromCSV(
+	FArchive& Archive,
+	LineCallbackType&& LineCallback,
+	FOutputDevice* Output = nullptr,
+	FSlowTask* SlowTask = nullptr,
+	ECSVImportMode Mode = ECSVImportMode::Serial)
+{
+	return ImportFromCSV(
+		*T::StaticStruct(),
+		Archive,
+		[&LineCallback](const void* const Data) { LineCallback(*static_cast<const T*>(Data)); },
+		Output,
+		SlowTask,
+		Mode);
+}
+
+/// Streams the given file through ImportFromCSV(const UStruct& Struct, FArchive& Archive, ...).
+ZAKAZANEUTILITIES_API EImportResult ImportFromCSVFile(
+	const UStruct& Struct,
+	const TCHAR* FileName,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* Output = nullptr,
+	FSlowTask* SlowTask = nullptr,
+	ECSVImportMode Mode = ECSVImportMode::Serial);
+
+/// @see ImportFromCSVFile(const UStruct& Struct, const TCHAR* FileName, ...)
+///
+/// Templated version for objects of known type.
+template <
+	class T,
+	class LineCallbackType UE_REQUIRES(TIsUHTUStruct_v<T>&& TIsInvocable<LineCallbackType, const T&>::Value)>
+EImportResult ImportFromCSVFile(
+	const TCHAR* FileName,
+	LineCallbackType&& LineCallback,
+	FOutputDevice* Output = nullptr,
+	FSlowTask* SlowTask = nullptr,
+	ECSVImportMode Mode = ECSVImportMode::Serial)
+{
+	return ImportFromCSVFile(
+		*T::StaticStruct(),
+		FileName,
+		[&LineCallback](const void* const Data) { LineCallback(*static_cast<const T*>(Data)); },
+		Output,
+		SlowTask,
+		Mode);
+}
+
+/// Writes objects of a given type as a binary columnar table, which is much faster to import than CSV.
+/// The table starts with a schema header with the path of the struct, the number of rows, and the name, C++ type and
+/// storage of each property. The values of each property follow as a contiguous column, aligned to 16 bytes, so the
+/// table can be imported directly from a memory mapped file. Properties whose memory is the same in any process
+/// (numbers, enums and structs made of them) are stored as they are in memory, with zeroed padding. Bools are stored
+/// as a byte per row and everything else as the UTF-8 text ExportToCSV would write. Offsets are relative to the start
+/// of the table.
+/// Columns are built in memory before they're written. Tables are only readable on platforms of the same byte order.
+/// @returns false if the archive reported an error
+ZAKAZANEUTILITIES_API bool ExportToColumnarTable(
+	const UStruct& Struct, TArrayView<const void*> Objects, FArchive& Archive);
+
+/// @see ExportToColumnarTable(const UStruct& Struct, TArrayView<const void*> Objects, FArchive& Archive)
+///
+/// Templated version for objects of known type.
+template <class T UE_REQUIRES(TIsUHTUStruct_v<T>)>
+bool ExportToColumnarTable(const TArrayView<const T> Objects, FArchive& Archive)
+{
+	TArray<const void*> Pointers;
+	Pointers.Reserve(Objects.Num());
+	Algo::Transform(Objects, Pointers, [](const T& Ref) { return &Ref; });
+
+	return ExportToColumnarTable(*T::StaticStruct(), Pointers, Archive);
+}
+
+/// Writes the objects to the given file through ExportToColumnarTable. Returns false if the file couldn't be written.
+ZAKAZANEUTILITIES_API bool ExportToColumnarTableFile(
+	const UStruct& Struct, TArrayView<const void*> Objects, const TCHAR* FileName);
+
+/// Imports data of a given type from a table written by ExportToColumnarTable. Columns are matched to properties by
+/// name: columns without a property are skipped with a warning and properties without a column keep their default
+/// values. Columns stored as they are in memory are copied into objects and must have the same type and size as their
+/// property. Text columns are imported like CSV cells, so they may be read into properties of any type.
+/// Rows are imported in batches, column by column, so warnings aren't necessarily in row order.
+///
+/// @param Data - the table, which must stay valid during the import
+/// @param LineCallback - callback function called for each imported object, in table order
+/// @param Output - optional output device for gathering error messages
+ZAKAZANEUTILITIES_API EImportResult ImportFromColumnarTable(
+	const UStruct& Struct,
+	TArrayView64<const uint8> Data,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* Output = nullptr);
+
+/// @see ImportFromColumnarTable(const UStruct& Struct, TArrayView64<const uint8> Data, ...)
+///
+/// Templated version for objects of known type.
+template <
+	class T,
+	class LineCallbackType UE_REQUIRES(TIsUHTUStruct_v<T>&& TIsInvocable<LineCallbackType, const T&>::Value)>
+EImportResult ImportFromColumnarTable(
+	const TArrayView64<const uint8> Data, LineCallbackType&& LineCallback, FOutputDevice* Output = nullptr)
+{
+	return ImportFromColumnarTable(
+		*T::StaticStruct(),
+		Data,
+		[&LineCallback](const void* const Object) { LineCallback(*static_cast<const T*>(Object)); },
+		Output);
+}
+
+/// Imports the given file through ImportFromColumnarTable. The file is memory mapped where the platform supports it,
+/// otherwise it's read into memory.
+ZAKAZANEUTILITIES_API EImportResult ImportFromColumnarTableFile(
+	const UStruct& Struct,
+	const TCHAR* FileName,
+	const TFunction<void(const void*)>& LineCallback,
+	FOutputDevice* Output = nullptr);
+
+/// Converts a table written by ExportToColumnarTable to CSV, for diffs and review. The CSV is the same as ExportToCSV
+/// would write for the imported objects and is streamed to CSVArchive as UTF-8.
+ZAKAZANEUTILITIES_API EImportResult ConvertColumnarTableToCSV(
+	const UStruct& Struct, TArrayView64<const uint8> Data, FArchive& CSVArchive, FOutputDevice* Output = nullptr);
+
 }  // namespace Zkz::Serialization
@@ -0,0 +1,53 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// Size-classed pool for small, short-lived, frequently allocated objects (e.g. future shared states). Freed blocks are
+/// kept in a per-thread free list, so allocation and deallocation on the same thread never take a lock. When a thread
+/// cache grows too large, a batch of blocks is moved to a global overflow list which other threads refill from.
+/// Memory is never returned to the system.
+namespace Zkz::SmallObjectPool
+{
+
+/// Alignment of every block returned by Allocate.
+constexpr SIZE_T BlockAlignment = 16;
+
+/// Blocks are rounded up to a multiple of this size.
+constexpr SIZE_T SizeClassGranularity = 32;
+
+constexpr int32 NumSizeClasses = 16;
+
+/// Allocations larger than this are forwarded to FMemory.
+constexpr SIZE_T MaxPooledSize = SizeClassGranularity * NumSizeClasses;
+
+struct FStats
+{
+	/// Number of allocations served from a free list
+	uint64 NumHits = 0;
+
+	/// Number of allocations which needed a new block (or were too large to pool)
+	uint64 NumMisses = 0;
+
+	/// Number of blocks currently in use
+	int64 NumLive = 0;
+
+	/// Highest NumLive observed since startup
+	int64 PeakLive = 0;
+
+	double GetHitRate() const
+	{
+		const uint64 NumAllocations = NumHits + NumMisses;
+		return NumAllocations == 0 ? 0.0 : static_cast<double>(NumHits) / static_cast<double>(NumAllocations);
+	}
+};
+
+ZAKAZANEUTILITIES_API void* Allocate(SIZE_T Size);
+
+/// Size must be the same as the one passed to Allocate.
+ZAKAZANEUTILITIES_API void Free(void* Ptr, SIZE_T Size);
+
+ZAKAZANEUTILITIES_API FStats GetStats();
+
+}  // namespace Zkz::SmallObjectPool
@@ -29,8 +29,7 @@ TScheduler<InIdType>::FAddStageResult TScheduler<InIdType>::AddStage(
 
 	if constexpr (GPerformInspections)
 	{
-		FAddStageResult InspectionResult = TInspectionData<IdType>::DebugAddStage(StageId, Prerequisites);
-		ZKZ_RETURN_IF(InspectionResult.HasError(), InspectionResult);
+		ZKZ_TRY(TInspectionData<IdType>::DebugAddStage(StageId, Prerequisites));
 	}
 
 	return StageState::AddStage(FindOrAddStage(StageId), *this, MoveTemp(FuturePrerequisiteCompletions), OutputDevice);
@@ -57,8 +56,7 @@ TScheduler<InIdType>::FAddTaskResult TScheduler<InIdType>::AddTask(
 {
 	FScopeLock ScopeLock{&Mutex};
 
-	FAddStageResult AddStageResult = AddStage(TaskId, Prerequisites, OutputDevice);
-	ZKZ_RETURN_IF(AddStageResult.HasError(), Err(MoveTemp(AddStageResult).GetError()));
+	ZKZ_TRY(AddStage(TaskId, Prerequisites, OutputDevice));
 
 	auto AddTaskToStageResult = AddTaskToStage(TaskId, TaskId, OutputDevice);
 	check(AddTaskToStageResult.HasValue());
@@ -59,12 +59,12 @@ auto TStageState_Executing<InIdType>::ExecuteAllTasks(
 				PendingTask.Id, InspectionData::EChangeState::Execution, InspectionData::EChangeType::Started);
 		}
 
-		FTaskCompletionPromise TaskCompletionPromise;
+		FTaskCompletionPromise TaskCompletionPromise{ZKZ_PROMISE_SITE};
 		FFutureTaskCompletion FutureTaskCompletion;
 
 		if (DebugScheduler != nullptr)
 		{
-			FTaskCompletionPromise PostNotifyCompletionPromise;
+			FTaskCompletionPromise PostNotifyCompletionPromise{ZKZ_PROMISE_SITE};
 			FutureTaskCompletion = PostNotifyCompletionPromise.GetFuture();
 
 			IfNotCanceled(
@@ -300,7 +300,8 @@ FFutureStageCompletion AddFollowUp(
 	FOutputDevice* const OutputDevice,
 	FStringView DependentStageName)
 {
-	FStageCompletionPromise& StageCompletionPromise = StageState_Pending.StageCompletionPromises.Emplace_GetRef();
+	FStageCompletionPromise& StageCompletionPromise =
+		StageState_Pending.StageCompletionPromises.Emplace_GetRef(ZKZ_PROMISE_SITE);
 
 	if (OutputDevice != nullptr)
 	{
@@ -320,7 +321,8 @@ FFutureStageCompletion AddFollowUp(
 	FOutputDevice* const OutputDevice,
 	FStringView DependentStageName)
 {
-	FStageCompletionPromise& StageCompletionPromise = StageState_Executing.StageCompletionPromises.Emplace_GetRef();
+	FStageCompletionPromise& StageCompletionPromise =
+		StageState_Executing.StageCompletionPromises.Emplace_GetRef(ZKZ_PROMISE_SITE);
 
 	if (OutputDevice != nullptr)
 	{
@@ -371,8 +373,8 @@ TResult<FFutureTaskExecution, TAllTasksCollectedError<InIdType>> AddTaskToStage(
 		StageState_Pending.bAllTasksCollected,
 		Err(TAllTasksCollectedError<InIdType>{StageState_Pending.StageId, MoveTemp(TaskId)}));
 
-	typename TStageState_Pending<InIdType>::FTaskEntry& Task = StageState_Pending.Tasks.Emplace_GetRef();
-	Task.Id = MoveTemp(TaskId);
+	typename TStageState_Pending<InIdType>::FTaskEntry& Task =
+		StageState_Pending.Tasks.Add_GetRef({MoveTemp(TaskId), FTaskExecutionPromise{ZKZ_PROMISE_SITE}});
 
 	if (OutputDevice != nullptr)
 	{
@@ -395,8 +397,8 @@ TResult<FFutureTaskExecution, TAllTasksCollectedError<InIdType>> AddTaskToStage(
 		StageState_Executing.bAllTasksCollected,
 		Err(TAllTasksCollectedError<InIdType>{StageState_Executing.StageId, MoveTemp(TaskId)}));
 
-	FTaskExecutionPromise TaskExecutionPromise;
-	FTaskCompletionPromise TaskCompletionPromise;
+	FTaskExecutionPromise TaskExecutionPromise{ZKZ_PROMISE_SITE};
+	FTaskCompletionPromise TaskCompletionPromise{ZKZ_PROMISE_SITE};
 	typename TStageState_Executing<InIdType>::FTaskEntry& Task = StageState_Executing.Tasks.Emplace_GetRef();
 	Task.Id = MoveTemp(TaskId);
 	Task.FutureCompletion = TaskCompletionPromise.GetFuture();
@@ -0,0 +1,99 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace Zkz
+{
+
+struct FTimerWheelHandle
+{
+	int32 Index = INDEX_NONE;
+	uint32 Generation = 0;
+
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+};
+
+/// Hierarchical timer wheel. Timers are kept in NumLevels levels of NumSlots slots each, level N having a resolution of
+/// NumSlots^N ticks. Timers are moved to lower levels as the wheel turns, so scheduling and canceling a timer are O(1)
+/// and a tick only touches the timers that are due (plus an occasional cascade of a higher level slot).
+/// All functions are thread safe. Callbacks are called by the thread calling Tick, outside the internal lock.
+class ZAKAZANEUTILITIES_API FTimerWheel
+{
+public:
+	static constexpr int32 SlotBits = 6;
+	static constexpr int32 NumSlots = 1 << SlotBits;
+	static constexpr int32 NumLevels = 4;
+
+	explicit FTimerWheel(FTimespan InTickInterval = FTimespan::FromMilliseconds(10));
+
+	FTimerWheel(const FTimerWheel&) = delete;
+	FTimerWheel& operator=(const FTimerWheel&) = delete;
+
+	~FTimerWheel();
+
+	/// Schedules Callback to be called once Delay has passed, rounded up to whole ticks (at least one tick).
+	FTimerWheelHandle Schedule(FTimespan Delay, TUniqueFunction<void()> Callback);
+
+	/// Removes a pending timer. Returns false if the timer has already fired or been canceled.
+	bool Cancel(FTimerWheelHandle Handle);
+
+	/// Advances the wheel by NumTicks ticks, calling the callbacks of timers which expire.
+	void Tick(int64 NumTicks = 1);
+
+	int32 GetNumPending() const;
+
+	FTimespan GetTickInterval() const
+	{
+		return TickInterval;
+	}
+
+	/// Returns the process-wide timer wheel, ticked in real time by a dedicated thread started on first use.
+	/// Returns null once ShutdownShared has been called, the wheel is never created again.
+	static TSharedPtr<FTimerWheel, ESPMode::ThreadSafe> GetShared();
+
+	/// Stops the thread ticking the shared wheel and releases it. Pending timers never fire. Users still holding the
+	/// wheel keep it alive, but it isn't ticked anymore.
+	static void ShutdownShared();
+
+private:
+	struct FTimer
+	{
+		TUniqueFunction<void()> Callback;
+		uint64 ExpiryTick = 0;
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+		int32 SlotIdx = INDEX_NONE;
+		uint32 Generation = 0;
+	};
+
+	const FTimespan TickInterval;
+
+	mutable FCriticalSection Mutex;
+
+	TArray<FTimer> Timers;
+	int32 FirstFreeTimer = INDEX_NONE;
+	int32 NumPending = 0;
+
+	int32 SlotHeads[NumLevels * NumSlots];
+
+	uint64 CurrentTick = 0;
+
+	int32 AllocateTimer();
+	void FreeTimer(int32 TimerIdx);
+
+	void Link(int32 TimerIdx);
+	void Unlink(int32 TimerIdx);
+
+	/// Moves all timers from the given slot to the levels below
+	void Cascade(int32 Level);
+
+	/// Advances by a single tick, moving the callbacks of expired timers to OutCallbacks
+	void AdvanceTick(TArray<TUniqueFunction<void()>>& OutCallbacks);
+};
+
+}  // namespace Zkz
@@ -0,0 +1,52 @@
+// Copyright ZAKAZANE Studio. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/// Trampoline bounding the stack depth of nested continuations. Future continuations run inline when a promise is
+/// fulfilled, so fulfilling a promise from within a continuation nests one more continuation on the stack. Chains of
+/// already fulfilled futures can easily nest thousands of frames deep this way. Functions passed to Trampoline::Run
+/// are called inline as long as fewer than MaxInlineDepth Run calls are nested on the calling thread, so ordering and
+/// blocking waits within continuations behave as without the trampoline in the common case. Past that depth they are
+/// queued instead and executed iteratively once the outermost Run call is about to return, so the stack never grows
+/// by more than MaxInlineDepth levels.
+namespace Zkz::Trampoline
+{
+
+/// Number of nested Run calls on a single thread before further functions are deferred
+inline constexpr int32 MaxInlineDepth = 64;
+
+namespace Private
+{
+
+/// Returns true if the calling thread is nested deep enough for Run to defer the function
+ZAKAZANEUTILITIES_API bool ShouldDefer();
+
+ZAKAZANEUTILITIES_API void Enqueue(TUniqueFunction<void()>&& Function);
+
+ZAKAZANEUTILITIES_API void BeginRun();
+
+/// Ends the run, executing all queued functions, including the ones they enqueue, if it is the outermost one
+ZAKAZANEUTILITIES_API void EndRun();
+
+}  // namespace Private
+
+/// Calls Function immediately, unless the calling thread is already within MaxInlineDepth nested Run calls, in which
+/// case Function is called after all previously queued functions, before the outermost Run call returns. Deferred
+/// functions must not block waiting for work that depends on them.
+template <class FunctionType>
+void Run(FunctionType&& Function)
+{
+	if (Private::ShouldDefer())
+	{
+		Private::Enqueue(TUniqueFunction<void()>{Forward<FunctionType>(Function)});
+		return;
+	}
+
+	Private::BeginRun();
+	::Invoke(Function);
+	Private::EndRun();
+}
+
+}  // namespace Zkz::Trampoline
@@ -53,5 +53,8 @@ public class ZakazaneUtilities : ModuleRules
 		// Uncomment this (e.g. conditionally for shipping builds) to skip optional sanity checks for
 		// ordered execution.
 		//PublicDefinitions.Add("NO_STAGED_EXECUTION_INSPECTION");
+
+		// Uncomment this to track pending promises and their lifetimes, see Zakazane/FutureRegistry.h.
+		//PublicDefinitions.Add("ZKZ_WITH_FUTURE_REGISTRY=1");
 	}
 }
\ No newline at end of file
@@ -1,6 +1,22 @@
 #include "ComponentTest.h"
 
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Blueprint.h"
+#include "Engine/BlueprintGeneratedClass.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/ScopeExit.h"
 #include "Zakazane/Component.h"
+#include "Zakazane/ComponentEvents.h"
+#include "Zakazane/ComponentHierarchySnapshot.h"
+#include "Zakazane/ComponentIndexSubsystem.h"
+#include "Zakazane/ComponentQueryIndex.h"
+#include "Zakazane/ComponentSubtreePool.h"
+#include "Zakazane/ComponentTransforms.h"
+#include "Zakazane/Test/Benchmark.h"
 #include "Zakazane/Test/Test.h"
 
 AComponentTestActorSuperclass::AComponentTestActorSuperclass()
@@ -35,6 +51,177 @@ AComponentTestActor::AComponentTestActor()
 
 namespace Zkz::Component::Test
 {
+
+using Zkz::Test::MeasureAverageSeconds;
+using Zkz::Test::ReportBenchmark;
+
+namespace ComponentTestPrivate
+{
+
+void AttachChildComponents(
+	AActor& Actor, USceneComponent& Parent, const int32 Depth, const int32 NumChildrenPerComponent)
+{
+	ZKZ_RETURN_IF(Depth <= 0);
+
+	for (int32 ChildIdx = 0; ChildIdx < NumChildrenPerComponent; ++ChildIdx)
+	{
+		USceneComponent* const Child = NewObject<USceneComponent>(&Actor);
+		Child->AttachToComponent(&Parent, FAttachmentTransformRules::KeepRelativeTransform);
+		AttachChildComponents(Actor, *Child, Depth - 1, NumChildrenPerComponent);
+	}
+}
+
+/// Creates an actor outside of any world, with a full tree of scene components of the given depth
+AActor& MakeTransientActorWithComponentTree(const int32 Depth, const int32 NumChildrenPerComponent)
+{
+	AActor* const Actor = NewObject<AActor>(GetTransientPackage());
+	USceneComponent* const Root = NewObject<USceneComponent>(Actor);
+	Actor->SetRootComponent(Root);
+	AttachChildComponents(*Actor, *Root, Depth - 1, NumChildrenPerComponent);
+	return *Actor;
+}
+
+/// Tags every third component with "Third" and every fifth with "Fifth". Returns the tags to query.
+TArray<FName> TagComponents(AActor& Actor)
+{
+	int32 ComponentIdx = 0;
+	Actor.ForEachComponent(
+		false,
+		[&ComponentIdx](UActorComponent* const Component)
+		{
+			if (ComponentIdx % 3 == 0)
+			{
+				Component->ComponentTags.Emplace("Third");
+			}
+			if (ComponentIdx % 5 == 0)
+			{
+				Component->ComponentTags.Emplace("Fifth");
+			}
+			++ComponentIdx;
+		});
+
+	return {"Third", "Fifth"};
+}
+
+/// Stand-in for a read-only validation of a component
+uint32 SlowComponentCheck(const UActorComponent& Component)
+{
+	uint32 Hash = GetTypeHash(Component.GetFName());
+	for (int32 Iteration = 0; Iteration < 256; ++Iteration)
+	{
+		Hash = HashCombineFast(Hash, Iteration);
+	}
+	return Hash;
+}
+
+/// Recursive prefix or suffix traversal, as FComponentHierarchy::ForEachComponentInSubtree used to do it. Reference for
+/// the iterative traversal.
+template <EForEachComponentRecursionType RecursionType, class FuncType>
+void RecursiveForEachComponentInSubtree(
+	const FComponentHierarchy& ComponentHierarchy, const UActorComponent& Component, FuncType& Func)
+{
+	static_assert(
+		RecursionType == EForEachComponentRecursionType::Prefix
+		|| RecursionType == EForEachComponentRecursionType::Suffix);
+
+	if constexpr (RecursionType == EForEachComponentRecursionType::Prefix)
+	{
+		Func(Component);
+	}
+
+	ComponentHierarchy.ForEachChildComponent(
+		Component,
+		[&](const UActorComponent& ChildComponent)
+		{ RecursiveForEachComponentInSubtree<RecursionType>(ComponentHierarchy, ChildComponent, Func); });
+
+	if constexpr (RecursionType == EForEachComponentRecursionType::Suffix)
+	{
+		Func(Component);
+	}
+}
+
+template <EForEachComponentRecursionType RecursionType>
+bool IterativeTraversalMatchesRecursive(
+	const FComponentHierarchy& ComponentHierarchy, const UActorComponent& RootComponent)
+{
+	TArray<const UActorComponent*> IterativeComponents;
+	ComponentHierarchy.ForEachComponentInSubtree<RecursionType>(
+		RootComponent, [&](const UActorComponent& Component) { IterativeComponents.Emplace(&Component); });
+
+	TArray<const UActorComponent*> RecursiveComponents;
+	auto CollectRecursive = [&](const UActorComponent& Component) { RecursiveComponents.Emplace(&Component); };
+	RecursiveForEachComponentInSubtree<RecursionType>(ComponentHierarchy, RootComponent, CollectRecursive);
+
+	return IterativeComponents == RecursiveComponents;
+}
+
+/// Game world which lives for the duration of the scope, for tests which need to spawn actors
+class FScopedTestWorld
+{
+public:
+	FScopedTestWorld() : World{UWorld::CreateWorld(EWorldType::Game, false)}
+	{
+		GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(World);
+	}
+
+	~FScopedTestWorld()
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	FScopedTestWorld(const FScopedTestWorld&) = delete;
+	FScopedTestWorld& operator=(const FScopedTestWorld&) = delete;
+
+	UWorld& Get() const
+	{
+		return *World;
+	}
+
+private:
+	UWorld* World;
+};
+
+/// Scene component added to a default object outside of its constructor, as the editor would add one
+USceneComponent& MakeArchetypeComponent(AActor& DefaultActor, USceneComponent& Parent)
+{
+	USceneComponent* const Component =
+		NewObject<USceneComponent>(&DefaultActor, NAME_None, RF_ArchetypeObject | RF_Public | RF_Transactional);
+	Component->SetupAttachment(&Parent);
+	return *Component;
+}
+
+/// Blueprint actor class with a default scene root only, whose components can be edited without touching any asset
+UBlueprint& MakeTransientActorBlueprint()
+{
+	UPackage* const Package = GetTransientPackage();
+	return *FKismetEditorUtilities::CreateBlueprint(
+		AActor::StaticClass(),
+		Package,
+		MakeUniqueObjectName(Package, UBlueprint::StaticClass(), TEXT("BP_ZkzComponentTestTransientActor")),
+		BPTYPE_Normal,
+		UBlueprint::StaticClass(),
+		UBlueprintGeneratedClass::StaticClass());
+}
+
+TSet<FString> GetComponentNames(const FComponentHierarchy& ComponentHierarchy)
+{
+	TSet<FString> ComponentNames;
+	ComponentHierarchy.ForEachComponent([&ComponentNames](const UActorComponent& Component)
+										{ ComponentNames.Emplace(GetComponentNameNoSuffix(Component)); });
+	return ComponentNames;
+}
+
+int32 CountComponentsOfTestActors(UZkzComponentIndexSubsystem& ComponentIndex)
+{
+	int32 NumComponents = 0;
+	ComponentIndex.ForEachComponentOfClass<USceneComponent>(
+		[&NumComponents](const USceneComponent& Component)
+		{ NumComponents += Component.GetOwner()->IsA<AComponentTestActor>() ? 1 : 0; });
+	return NumComponents;
+}
+
+}  // namespace ComponentTestPrivate
 ZKZ_BEGIN_AUTOMATION_TEST(
 	FComponentTest,
 	"Zakazane.ZakazaneUtilities.Component",
@@ -181,10 +368,1157 @@ ZKZ_ADD_TEST(ForEachComponentInHierarchyOverPureBluprintHierarchy)
 	// #TODO #Components: Add test for inherited blueprint hierarchies
 }
 
+ZKZ_ADD_TEST(SubobjectEditBatchAppliesAddsAndRemovesTogether)
+{
+	UBlueprint& Blueprint = ComponentTestPrivate::MakeTransientActorBlueprint();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Blueprint.GeneratedClass);
+	AActor* const DefaultActor = Blueprint.GeneratedClass->GetDefaultObject<AActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	int32 NumChanges = 0;
+	Blueprint.OnChanged().AddLambda([&NumChanges](UBlueprint*) { ++NumChanges; });
+
+	// The subobject subsystem may report changes of its own, so only the difference made by the batch is compared
+	FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(&Blueprint);
+	const int32 NumChangesPerModification = NumChanges;
+
+	FComponentHierarchy ComponentHierarchy{*DefaultActor};
+	ZKZ_RETURN_IF(!TestTrue("Mutable", ComponentHierarchy.ComponentsMutable()));
+	const TSet<FString> InitialComponentNames = ComponentTestPrivate::GetComponentNames(ComponentHierarchy);
+
+	const auto AddAndRemove = [&](const FString& Prefix, const Editor::EMarkBlueprintAsStructurallyModified Mark)
+	{
+		UActorComponent* const ToRemove = ComponentHierarchy.AddNewSubobject(
+			*USceneComponent::StaticClass(),
+			nullptr,
+			FName{Prefix + TEXT("Removed")},
+			Editor::EMarkBlueprintAsStructurallyModified::Disabled);
+		ZKZ_RETURN_IF(!TestNotNull("ToRemoveAdded", ToRemove), INDEX_NONE);
+
+		NumChanges = 0;
+
+		Editor::FSubobjectEditBatch Batch{ComponentHierarchy, Mark};
+		const Editor::FSubobjectEditBatch::FAddId ParentId =
+			Batch.AddNewSubobject(*USceneComponent::StaticClass(), nullptr, FName{Prefix + TEXT("Parent")});
+		const Editor::FSubobjectEditBatch::FAddId ChildId =
+			Batch.AddNewSubobject(*USceneComponent::StaticClass(), ParentId, FName{Prefix + TEXT("Child")});
+		Batch.RemoveSubobject(*ToRemove);
+
+		TestNull("NotAddedBeforeCommit", Batch.GetAddedComponent(ParentId));
+		Batch.Commit();
+
+		UActorComponent* const Parent = Batch.GetAddedComponent(ParentId);
+		UActorComponent* const Child = Batch.GetAddedComponent(ChildId);
+		TestNotNull("ParentAdded", Parent);
+		TestTrue("ChildAddedUnderParent", Child != nullptr && ComponentHierarchy.FindParent(*Child) == Parent);
+		TestEqual("OneRemoved", Batch.GetNumRemoved(), 1);
+
+		return NumChanges;
+	};
+
+	const int32 NumChangesUnmarked =
+		AddAndRemove(TEXT("Unmarked"), Editor::EMarkBlueprintAsStructurallyModified::Disabled);
+	const int32 NumChangesMarked = AddAndRemove(TEXT("Marked"), Editor::EMarkBlueprintAsStructurallyModified::Enabled);
+	TestEqual("SingleStructuralModification", NumChangesMarked - NumChangesUnmarked, NumChangesPerModification);
+
+	TSet<FString> ExpectedComponentNames = InitialComponentNames;
+	ExpectedComponentNames.Append(
+		{TEXT("UnmarkedParent"), TEXT("UnmarkedChild"), TEXT("MarkedParent"), TEXT("MarkedChild")});
+
+	const TSet<FString> ComponentNames = ComponentTestPrivate::GetComponentNames(ComponentHierarchy);
+	TestTrue(
+		"ExpectedComponents",
+		ComponentNames.Num() == ExpectedComponentNames.Num() && ComponentNames.Includes(ExpectedComponentNames));
+
+	const TSet<FString> RegatheredComponentNames =
+		ComponentTestPrivate::GetComponentNames(FComponentHierarchy{*DefaultActor});
+	TestTrue(
+		"RegatheredComponentsMatch",
+		RegatheredComponentNames.Num() == ExpectedComponentNames.Num()
+			&& RegatheredComponentNames.Includes(ExpectedComponentNames));
+}
+
+ZKZ_ADD_TEST(SnapshotMatchesHierarchy)
+{
+	const auto ComponentVisitor =
+		[](const UActorComponent& Component, TArray<const UActorComponent*>& VisitedComponents)
+	{ VisitedComponents.Emplace(&Component); };
+
+	const AComponentTestActorSubclass* const DefaultActor = GetDefault<AComponentTestActorSubclass>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const FComponentHierarchy ComponentHierarchy{*DefaultActor};
+	const FComponentHierarchySnapshot Snapshot{ComponentHierarchy};
+
+	TArray<const UActorComponent*> HierarchyComponents;
+	ComponentHierarchy.ForEachComponent(ComponentVisitor, HierarchyComponents);
+	ZKZ_RETURN_IF(!TestEqual("SameNumberOfComponents", Snapshot.Num(), HierarchyComponents.Num()));
+
+	for (const UActorComponent* const Component : HierarchyComponents)
+	{
+		const int32 NodeIdx = Snapshot.FindIndex(*Component);
+		ZKZ_RETURN_IF(!TestTrue("ComponentInSnapshot", NodeIdx != INDEX_NONE));
+
+		const int32 ParentIdx = Snapshot.GetParentIndex(NodeIdx);
+		const UActorComponent* const SnapshotParent =
+			ParentIdx == INDEX_NONE ? nullptr : &Snapshot.GetComponent(ParentIdx);
+		TestTrue("SameParent", SnapshotParent == ComponentHierarchy.FindParent(*Component));
+	}
+
+	const int32 RootIdx = Snapshot.FindIndex(*DefaultActor->DefaultRootComponent);
+	const int32 ChildIdx = Snapshot.FindIndex(*DefaultActor->DefaultChildComponent);
+	const int32 SubclassIdx = Snapshot.FindIndex(*DefaultActor->DefaultSubclassComponent);
+	const int32 SubclassChildIdx = Snapshot.FindIndex(*DefaultActor->DefaultSubclassChildComponent);
+
+	TestTrue("RootIsAncestorOfAll", Snapshot.IsDescendant(RootIdx, ChildIdx));
+	TestTrue("RootIsAncestorOfGrandchild", Snapshot.IsDescendant(RootIdx, SubclassChildIdx));
+	TestTrue("SubclassIsAncestorOfItsChild", Snapshot.IsDescendant(SubclassIdx, SubclassChildIdx));
+	TestFalse("SiblingIsNotAncestor", Snapshot.IsDescendant(ChildIdx, SubclassChildIdx));
+	TestFalse("ChildIsNotAncestorOfParent", Snapshot.IsDescendant(SubclassChildIdx, SubclassIdx));
+	TestFalse("NodeIsNotItsOwnDescendant", Snapshot.IsDescendant(RootIdx, RootIdx));
+	TestTrue(
+		"ComponentOverload",
+		Snapshot.IsDescendant(*DefaultActor->DefaultRootComponent, *DefaultActor->DefaultSubclassChildComponent));
+
+	TestEqual("FirstChildFollowsParent", Snapshot.GetFirstChildIndex(SubclassIdx), SubclassChildIdx);
+	TestEqual("LeafHasNoChildren", Snapshot.GetFirstChildIndex(SubclassChildIdx), INDEX_NONE);
+	TestTrue(
+		"ChildrenOfRootAreSiblings",
+		Snapshot.GetNextSiblingIndex(ChildIdx) == SubclassIdx
+			|| Snapshot.GetNextSiblingIndex(SubclassIdx) == ChildIdx);
+
+	{
+		TArray<const UActorComponent*> VisitedComponents;
+		Snapshot.ForEachComponentInSubtree<EForEachComponentRecursionType::Suffix>(
+			SubclassIdx, ComponentVisitor, VisitedComponents);
+		TestEqual(
+			"SuffixVisitsChildrenFirst",
+			VisitedComponents,
+			{DefaultActor->DefaultSubclassChildComponent.Get(), DefaultActor->DefaultSubclassComponent.Get()});
+	}
+
+	{
+		const auto CondVisitor =
+			[DefaultActor](const UActorComponent& Component, TArray<const UActorComponent*>& VisitedComponents)
+		{
+			VisitedComponents.Emplace(&Component);
+			return &Component != DefaultActor->DefaultSubclassComponent;
+		};
+
+		TArray<const UActorComponent*> VisitedComponents;
+		Snapshot.ForEachComponentInSubtree<EForEachComponentRecursionType::PrefixCond>(
+			RootIdx, CondVisitor, VisitedComponents);
+		TestEqual("PrefixCondSkipsSubtree", VisitedComponents.Num(), 3);
+		TestFalse(
+			"PrefixCondSkipsChild", VisitedComponents.Contains(DefaultActor->DefaultSubclassChildComponent.Get()));
+	}
+}
+
+ZKZ_ADD_TEST(CachedArchetypeHierarchyMatchesGathered)
+{
+	const AComponentTestActorSubclass* const DefaultActor = GetDefault<AComponentTestActorSubclass>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	FComponentHierarchy::InvalidateArchetypeCache();
+	const FComponentHierarchy GatheredHierarchy{*DefaultActor};
+	const FComponentHierarchy CachedHierarchy{*DefaultActor};
+
+	TArray<const UActorComponent*> GatheredComponents;
+	GatheredHierarchy.ForEachComponent(
+		[&GatheredComponents](const UActorComponent& Component) { GatheredComponents.Emplace(&Component); });
+
+	TArray<const UActorComponent*> CachedComponents;
+	CachedHierarchy.ForEachComponent(
+		[&CachedComponents](const UActorComponent& Component) { CachedComponents.Emplace(&Component); });
+
+	TestEqual("SameComponents", CachedComponents, GatheredComponents);
+
+	for (const UActorComponent* const Component : GatheredComponents)
+	{
+		TestTrue("SameParent", CachedHierarchy.FindParent(*Component) == GatheredHierarchy.FindParent(*Component));
+	}
+
+	TestTrue(
+		"FindComponentByName",
+		CachedHierarchy.FindComponentByName("DefaultSubclassChildComponent")
+			== DefaultActor->DefaultSubclassChildComponent);
+	TestFalse("NotMutable", CachedHierarchy.ComponentsMutable());
+}
+
+ZKZ_ADD_TEST(ParallelForEachComponentVisitsEachComponentOnce)
+{
+	const AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(6, 4);
+	const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{Actor}};
+
+	const TArray<int32> ChunkBounds = Snapshot.MakeParallelChunkBounds(0, Snapshot.Num());
+	ZKZ_RETURN_IF(!TestTrue("AtLeastOneChunk", ChunkBounds.Num() >= 2));
+	TestEqual("ChunksStartAtBegin", ChunkBounds[0], 0);
+	TestEqual("ChunksEndAtEnd", ChunkBounds.Last(), Snapshot.Num());
+	for (int32 BoundIdx = 1; BoundIdx < ChunkBounds.Num(); ++BoundIdx)
+	{
+		TestTrue("ChunksNotEmpty", ChunkBounds[BoundIdx - 1] < ChunkBounds[BoundIdx]);
+	}
+
+	TArray<TArray<const UActorComponent*>> Contexts;
+	Snapshot.ParallelForEachComponent(
+		Contexts,
+		[](const UActorComponent& Component, TArray<const UActorComponent*>& VisitedComponents)
+		{ VisitedComponents.Emplace(&Component); });
+
+	TSet<const UActorComponent*> VisitedComponents;
+	int32 NumVisits = 0;
+	for (const TArray<const UActorComponent*>& Context : Contexts)
+	{
+		VisitedComponents.Append(Context);
+		NumVisits += Context.Num();
+	}
+
+	TestEqual("EachComponentVisitedOnce", NumVisits, Snapshot.Num());
+	TestEqual("AllComponentsVisited", VisitedComponents.Num(), Snapshot.Num());
+
+	const int32 SubtreeRootIdx = Snapshot.GetFirstChildIndex(0);
+	TArray<int32> SubtreeContexts;
+	Snapshot.ParallelForEachComponentInSubtree(
+		SubtreeRootIdx, SubtreeContexts, [](const UActorComponent&, int32& NumVisited) { ++NumVisited; });
+	int32 NumSubtreeVisits = 0;
+	for (const int32 NumVisited : SubtreeContexts)
+	{
+		NumSubtreeVisits += NumVisited;
+	}
+	TestEqual("SubtreeVisitedOnce", NumSubtreeVisits, Snapshot.GetSubtreeEnd(SubtreeRootIdx) - SubtreeRootIdx);
+}
+
+ZKZ_ADD_TEST(SnapshotFindsComponentsByName)
+{
+	{
+		const AComponentTestActorSubclass* const DefaultActor = GetDefault<AComponentTestActorSubclass>();
+		ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+		const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{*DefaultActor}};
+		const int32 SubclassIdx = Snapshot.FindIndex(*DefaultActor->DefaultSubclassComponent);
+		const int32 SubclassChildIdx = Snapshot.FindIndex(*DefaultActor->DefaultSubclassChildComponent);
+
+		TestEqual("ArchetypeFoundByName", Snapshot.FindIndexByName("DefaultSubclassChildComponent"), SubclassChildIdx);
+		TestEqual(
+			"ArchetypeFoundInSubtree",
+			Snapshot.FindIndexInSubtreeByName(SubclassIdx, "DefaultSubclassChildComponent"),
+			SubclassChildIdx);
+		TestEqual(
+			"ArchetypeRootFoundInOwnSubtree",
+			Snapshot.FindIndexInSubtreeByName(SubclassIdx, "DefaultSubclassComponent"),
+			SubclassIdx);
+		TestEqual(
+			"ArchetypeNotFoundOutsideSubtree",
+			Snapshot.FindIndexInSubtreeByName(SubclassIdx, "DefaultChildComponent"),
+			INDEX_NONE);
+		TestEqual("UnknownNameNotFound", Snapshot.FindIndexByName("NoSuchComponent"), INDEX_NONE);
+	}
+
+	{
+		const AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(3, 2);
+		const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{Actor}};
+
+		const int32 FirstChildIdx = Snapshot.GetFirstChildIndex(0);
+		const int32 SecondChildIdx = Snapshot.GetNextSiblingIndex(FirstChildIdx);
+		const int32 GrandchildIdx = Snapshot.GetFirstChildIndex(SecondChildIdx);
+		const FName GrandchildName = Snapshot.GetComponent(GrandchildIdx).GetFName();
+
+		TestEqual("InstanceFoundByName", Snapshot.FindIndexByName(GrandchildName), GrandchildIdx);
+		TestEqual(
+			"InstanceFoundInSubtree", Snapshot.FindIndexInSubtreeByName(SecondChildIdx, GrandchildName), GrandchildIdx);
+		TestEqual(
+			"InstanceNotFoundInSiblingSubtree",
+			Snapshot.FindIndexInSubtreeByName(FirstChildIdx, GrandchildName),
+			INDEX_NONE);
+	}
+}
+
+ZKZ_ADD_TEST(QueryIndexMatchesPerComponentChecks)
+{
+	AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(4, 3);
+	const TArray<FName> Tags = ComponentTestPrivate::TagComponents(Actor);
+	Actor.GetRootComponent()->ComponentTags.Emplace("Root");
+
+	const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{Actor}};
+	const FComponentQueryIndex QueryIndex{Snapshot};
+
+	for (int32 RootIdx = 0; RootIdx < Snapshot.Num(); ++RootIdx)
+	{
+		TArray<const UActorComponent*> ExpectedComponents;
+		Snapshot.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+			RootIdx,
+			[&](const UActorComponent& Component)
+			{
+				if (ComponentHasAnyTag(Component, Tags))
+				{
+					ExpectedComponents.Emplace(&Component);
+				}
+			});
+
+		TArray<const UActorComponent*> FoundComponents;
+		QueryIndex.ForEachWithAnyTagInSubtree(
+			RootIdx, Tags, [&](const UActorComponent& Component) { FoundComponents.Emplace(&Component); });
+
+		ZKZ_RETURN_IF(!TestEqual("SameTaggedComponents", FoundComponents, ExpectedComponents));
+		ZKZ_RETURN_IF(!TestEqual(
+			"HasAnyTag",
+			QueryIndex.HasAnyTag(RootIdx, Tags),
+			ComponentHasAnyTag(Snapshot.GetComponent(RootIdx), Tags)));
+	}
+
+	int32 NumSceneComponents = 0;
+	QueryIndex.ForEachOfClassInSubtree<USceneComponent>(0, [&](const USceneComponent&) { ++NumSceneComponents; });
+	TestEqual("AllAreSceneComponents", NumSceneComponents, Snapshot.Num());
+
+	int32 NumPrimitiveComponents = 0;
+	QueryIndex.ForEachOfClassInSubtree<UPrimitiveComponent>(
+		0, [&](const UPrimitiveComponent&) { ++NumPrimitiveComponents; });
+	TestEqual("NoPrimitiveComponents", NumPrimitiveComponents, 0);
+
+	const TArray<FName> RootTag{"Root"};
+	TBitArray<> Mask = QueryIndex.MakeTagMask(RootTag);
+	Mask.CombineWithBitwiseAND(
+		QueryIndex.MakeClassMask(*USceneComponent::StaticClass()), EBitwiseOperatorFlags::MinSize);
+	TestEqual("CombinedMask", Mask.CountSetBits(), 1);
+	TestEqual("UnknownTag", QueryIndex.MakeTagMask(TArray<FName>{"Unknown"}).CountSetBits(), 0);
+}
+
+ZKZ_ADD_TEST(IterativeTraversalMatchesRecursive)
+{
+	const AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(4, 3);
+	const UActorComponent& RootComponent = *Actor.GetRootComponent();
+	const FComponentHierarchy ComponentHierarchy{Actor};
+
+	TestTrue(
+		"SamePrefixOrder",
+		ComponentTestPrivate::IterativeTraversalMatchesRecursive<EForEachComponentRecursionType::Prefix>(
+			ComponentHierarchy, RootComponent));
+	TestTrue(
+		"SameSuffixOrder",
+		ComponentTestPrivate::IterativeTraversalMatchesRecursive<EForEachComponentRecursionType::Suffix>(
+			ComponentHierarchy, RootComponent));
+
+	constexpr int32 NumToVisit = 10;
+
+	int32 NumVisited = 0;
+	const auto StopAfterNumToVisit = [&NumVisited](const UActorComponent&)
+	{ return ++NumVisited == NumToVisit ? EComponentVisitResult::Stop : EComponentVisitResult::Continue; };
+
+	TestFalse(
+		"PrefixStopped",
+		ComponentHierarchy.VisitComponentsInSubtree<EForEachComponentRecursionType::Prefix>(
+			RootComponent, StopAfterNumToVisit));
+	TestEqual("PrefixVisitedUntilStopped", NumVisited, NumToVisit);
+
+	NumVisited = 0;
+	TestFalse(
+		"SuffixStopped",
+		ComponentHierarchy.VisitComponentsInSubtree<EForEachComponentRecursionType::Suffix>(
+			RootComponent, StopAfterNumToVisit));
+	TestEqual("SuffixVisitedUntilStopped", NumVisited, NumToVisit);
+
+	TArray<const UActorComponent*> PrefixComponents;
+	ComponentHierarchy.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+		RootComponent, [&](const UActorComponent& Component) { PrefixComponents.Emplace(&Component); });
+
+	const UActorComponent* const Target = PrefixComponents[PrefixComponents.Num() / 2];
+	int32 NumChecked = 0;
+	TestEqual(
+		"FindsComponent",
+		FindComponentInSubtree(
+			RootComponent,
+			[Target, &NumChecked](const UActorComponent& Component)
+			{
+				++NumChecked;
+				return &Component == Target;
+			}),
+		Target);
+	TestEqual("FindStopsAtFirstMatch", NumChecked, PrefixComponents.Num() / 2 + 1);
+	TestEqual(
+		"FindReturnsFirstMatchInPrefixOrder",
+		FindComponentInSubtree(RootComponent, [](const UActorComponent&) { return true; }),
+		&RootComponent);
+}
+
+ZKZ_ADD_TEST(ComponentIndexSubsystemTracksActors)
+{
+	constexpr int32 NumActors = 4;
+
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	UZkzComponentIndexSubsystem* const ComponentIndex = TestWorld.Get().GetSubsystem<UZkzComponentIndexSubsystem>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ComponentIndex);
+
+	TArray<AComponentTestActor*> Actors;
+	for (int32 ActorIdx = 0; ActorIdx < NumActors; ++ActorIdx)
+	{
+		Actors.Emplace(TestWorld.Get().SpawnActor<AComponentTestActor>());
+	}
+
+	TestEqual(
+		"SpawnedActorsIndexed", ComponentTestPrivate::CountComponentsOfTestActors(*ComponentIndex), 3 * NumActors);
+
+	Actors[0]->DefaultChildComponent->ComponentTags.Emplace("Indexed");
+	ComponentIndex->InvalidateActor(*Actors[0]);
+
+	TArray<const UActorComponent*> TaggedComponents;
+	ComponentIndex->ForEachComponentWithAnyTag(
+		TArray<FName>{"Indexed"},
+		[&TaggedComponents](const UActorComponent& Component) { TaggedComponents.Emplace(&Component); });
+	TestEqual("TagReindexed", TaggedComponents, {Actors[0]->DefaultChildComponent.Get()});
+
+	Actors[1]->GetRootComponent()->AttachToComponent(
+		Actors[0]->DefaultGrandchildComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	ComponentIndex->InvalidateActor(*Actors[1]);
+
+	TestEqual(
+		"AttachParentAcrossActors",
+		ComponentIndex->FindAttachParent(*Actors[1]->DefaultComponent),
+		static_cast<UActorComponent*>(Actors[0]->DefaultGrandchildComponent.Get()));
+
+	TSet<const UActorComponent*> Descendants;
+	ComponentIndex->ForEachAttachedDescendant(
+		*Actors[0]->DefaultComponent,
+		[&Descendants](const UActorComponent& Component) { Descendants.Emplace(&Component); });
+	TestEqual("DescendantsAcrossActors", Descendants.Num(), 5);
+	TestTrue("DescendantInOtherActor", Descendants.Contains(Actors[1]->DefaultGrandchildComponent.Get()));
+
+	Actors[2]->Destroy();
+	TestEqual(
+		"DestroyedActorRemoved",
+		ComponentTestPrivate::CountComponentsOfTestActors(*ComponentIndex),
+		3 * (NumActors - 1));
+}
+
+ZKZ_ADD_TEST(LiveHierarchyPatchesOnComponentEvents)
+{
+	AComponentTestActor* const DefaultActor = GetMutableDefault<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const FLiveComponentHierarchy LiveHierarchy{*DefaultActor};
+
+	USceneComponent& NewComponent =
+		ComponentTestPrivate::MakeArchetypeComponent(*DefaultActor, *DefaultActor->DefaultChildComponent);
+	ON_SCOPE_EXIT
+	{
+		NewComponent.MarkAsGarbage();
+		FComponentHierarchy::InvalidateArchetypeCache();
+	};
+
+	ComponentEvents::OnComponentAdded().Broadcast(NewComponent);
+	TestTrue(
+		"AddedComponentIsChild",
+		LiveHierarchy.FindParent(NewComponent) == DefaultActor->DefaultChildComponent.Get());
+	TestTrue(
+		"AddedComponentFoundByName",
+		LiveHierarchy.FindComponentByName(NewComponent.GetFName()) == &NewComponent);
+
+	NewComponent.SetupAttachment(DefaultActor->DefaultGrandchildComponent);
+	ComponentEvents::BroadcastAttachmentChanged(NewComponent);
+	TestTrue(
+		"ReattachedComponentHasNewParent",
+		LiveHierarchy.FindParent(NewComponent) == DefaultActor->DefaultGrandchildComponent.Get());
+
+	int32 NumChildrenOfGrandchild = 0;
+	LiveHierarchy.ForEachChildComponent(
+		*DefaultActor->DefaultGrandchildComponent, [&](const UActorComponent&) { ++NumChildrenOfGrandchild; });
+	TestEqual("ReattachedComponentIsOnlyChild", NumChildrenOfGrandchild, 1);
+
+	ComponentEvents::OnComponentRemoved().Broadcast(NewComponent);
+	TestTrue("RemovedComponentHasNoParent", LiveHierarchy.FindParent(NewComponent) == nullptr);
+	TestTrue(
+		"RemovedComponentNotFoundByName", LiveHierarchy.FindComponentByName(NewComponent.GetFName()) == nullptr);
+
+	int32 NumComponents = 0;
+	LiveHierarchy.ForEachComponent([&](const UActorComponent&) { ++NumComponents; });
+	TestEqual("OriginalComponentsRemain", NumComponents, 3);
+}
+
+ZKZ_ADD_TEST(ComponentIndexSubsystemFollowsComponentEvents)
+{
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	UZkzComponentIndexSubsystem* const ComponentIndex = TestWorld.Get().GetSubsystem<UZkzComponentIndexSubsystem>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ComponentIndex);
+
+	AComponentTestActor* const Actor = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Actor);
+	TestEqual("SpawnedActorIndexed", ComponentTestPrivate::CountComponentsOfTestActors(*ComponentIndex), 3);
+
+	USceneComponent* const NewComponent = NewObject<USceneComponent>(Actor);
+	NewComponent->SetupAttachment(Actor->DefaultChildComponent);
+	NewComponent->RegisterComponent();
+	TestEqual("RegisteredComponentIndexed", ComponentTestPrivate::CountComponentsOfTestActors(*ComponentIndex), 4);
+	TestTrue(
+		"RegisteredComponentAttached",
+		ComponentIndex->FindAttachParent(*NewComponent) == Actor->DefaultChildComponent.Get());
+
+	NewComponent->AttachToComponent(
+		Actor->DefaultGrandchildComponent, FAttachmentTransformRules::KeepRelativeTransform);
+	ComponentEvents::BroadcastAttachmentChanged(*NewComponent);
+	TestTrue(
+		"ReattachedComponentReindexed",
+		ComponentIndex->FindAttachParent(*NewComponent) == Actor->DefaultGrandchildComponent.Get());
+
+	NewComponent->DestroyComponent();
+	TestEqual("DestroyedComponentRemoved", ComponentTestPrivate::CountComponentsOfTestActors(*ComponentIndex), 3);
+}
+
+ZKZ_ADD_TEST(SubtreePoolReusesReleasedSubtrees)
+{
+	const AComponentTestActor* const DefaultActor = GetDefault<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	AComponentTestActor* const Owner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	AComponentTestActor* const OtherOwner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Owner);
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(OtherOwner);
+
+	FComponentSubtreePool Pool{{GET_MEMBER_NAME_CHECKED(UActorComponent, ComponentTags)}};
+	const USceneComponent& TemplateRoot = *DefaultActor->DefaultComponent;
+
+	USceneComponent* const InstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultGrandchildComponent);
+	ZKZ_RETURN_IF(!TestNotNull("Acquired", InstanceRoot));
+
+	TArray<USceneComponent*> InstanceDescendants;
+	InstanceRoot->GetChildrenComponents(true, InstanceDescendants);
+	TestEqual("WholeSubtreeCloned", InstanceDescendants.Num(), 2);
+	TestTrue("OwnedByOwner", InstanceRoot->GetOwner() == Owner);
+	TestTrue("Attached", InstanceRoot->GetAttachParent() == Owner->DefaultGrandchildComponent.Get());
+	TestTrue("Registered", InstanceRoot->IsRegistered());
+
+	InstanceRoot->SetRelativeLocation(FVector{100.0, 0.0, 0.0});
+	InstanceRoot->ComponentTags.Emplace("Modified");
+
+	Pool.Release(*InstanceRoot);
+	TestEqual("Pooled", Pool.GetNumPooled(TemplateRoot), 1);
+	TestTrue("Detached", InstanceRoot->GetAttachParent() == nullptr);
+	TestFalse("Hidden", InstanceRoot->IsVisible());
+	TestTrue("StillRegistered", InstanceRoot->IsRegistered());
+
+	USceneComponent* const OtherInstanceRoot =
+		Pool.Acquire(TemplateRoot, *OtherOwner, *OtherOwner->DefaultGrandchildComponent);
+	TestTrue("NotReusedByOtherOwner", OtherInstanceRoot != InstanceRoot);
+	TestEqual("StillPooled", Pool.GetNumPooled(TemplateRoot), 1);
+
+	USceneComponent* const ReusedInstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+	TestTrue("Reused", ReusedInstanceRoot == InstanceRoot);
+	TestEqual("NoLongerPooled", Pool.GetNumPooled(TemplateRoot), 0);
+	TestTrue("Reattached", InstanceRoot->GetAttachParent() == Owner->DefaultComponent.Get());
+	TestTrue("TransformReset", InstanceRoot->GetRelativeTransform().Equals(TemplateRoot.GetRelativeTransform()));
+	TestTrue("PropertyReset", InstanceRoot->ComponentTags.IsEmpty());
+	TestTrue("Visible", InstanceRoot->IsVisible());
+}
+
+ZKZ_ADD_TEST(SubtreePoolCapsPerOwnerAndDropsDeadOwners)
+{
+	const AComponentTestActor* const DefaultActor = GetDefault<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	AComponentTestActor* const Owner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	AComponentTestActor* const OtherOwner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Owner);
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(OtherOwner);
+
+	FComponentSubtreePool Pool{{}, 1};
+	const USceneComponent& TemplateRoot = *DefaultActor->DefaultComponent;
+
+	USceneComponent* const FirstInstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+	USceneComponent* const SecondInstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+	USceneComponent* const OtherInstanceRoot =
+		Pool.Acquire(TemplateRoot, *OtherOwner, *OtherOwner->DefaultComponent);
+	ZKZ_RETURN_IF(!TestNotNull("FirstAcquired", FirstInstanceRoot));
+	ZKZ_RETURN_IF(!TestNotNull("SecondAcquired", SecondInstanceRoot));
+	ZKZ_RETURN_IF(!TestNotNull("OtherAcquired", OtherInstanceRoot));
+
+	Pool.Release(*OtherInstanceRoot);
+	Pool.Release(*FirstInstanceRoot);
+	TestEqual("OtherOwnersInstanceDoesNotCountTowardsCap", Pool.GetNumPooled(TemplateRoot), 2);
+
+	Pool.Release(*SecondInstanceRoot);
+	TestEqual("ReleasedAboveCapDestroyed", Pool.GetNumPooled(TemplateRoot), 2);
+	TestFalse("DestroyedAboveCap", IsValid(SecondInstanceRoot));
+
+	OtherOwner->Destroy();
+
+	USceneComponent* const ReusedInstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+	TestTrue("Reused", ReusedInstanceRoot == FirstInstanceRoot);
+	TestEqual("DeadOwnersInstanceDropped", Pool.GetNumPooled(TemplateRoot), 0);
+}
+
+ZKZ_ADD_TEST(SubtreePoolClonesAttachedInstancedTemplates)
+{
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	AComponentTestActor* const Owner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	const AComponentTestActor* const TemplateActor = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Owner);
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(TemplateActor);
+
+	// Instanced, attached to a parent and with an attached child
+	FComponentSubtreePool Pool{{}, 0};
+	const USceneComponent& TemplateRoot = *TemplateActor->DefaultChildComponent;
+	const TArray<TObjectPtr<USceneComponent>> TemplateChildren = TemplateRoot.GetAttachChildren();
+	const FTransform TemplateChildTransform = TemplateActor->DefaultGrandchildComponent->GetComponentTransform();
+
+	USceneComponent* const InstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+	ZKZ_RETURN_IF(!TestNotNull("Acquired", InstanceRoot));
+
+	TestTrue("TemplateChildrenUnchanged", TemplateRoot.GetAttachChildren() == TemplateChildren);
+	TestTrue("TemplateParentUnchanged", TemplateRoot.GetAttachParent() == TemplateActor->DefaultComponent.Get());
+
+	const TArray<TObjectPtr<USceneComponent>>& InstanceChildren = InstanceRoot->GetAttachChildren();
+	ZKZ_RETURN_IF(!TestEqual("OnlyClonedChildren", InstanceChildren.Num(), 1));
+	TestTrue("ChildCloned", InstanceChildren[0] != TemplateActor->DefaultGrandchildComponent);
+	TestTrue("ChildOwnedByOwner", InstanceChildren[0]->GetOwner() == Owner);
+
+	InstanceRoot->SetRelativeLocation(FVector{100.0, 0.0, 0.0});
+	TestTrue(
+		"TemplateChildNotMoved",
+		TemplateActor->DefaultGrandchildComponent->GetComponentTransform().Equals(TemplateChildTransform));
+
+	// Above the cap, so the instance is destroyed
+	Pool.Release(*InstanceRoot);
+	TestFalse("Destroyed", IsValid(InstanceRoot));
+	TestTrue("TemplateChildrenKept", TemplateRoot.GetAttachChildren() == TemplateChildren);
+	TestTrue(
+		"TemplateChildStillAttached",
+		TemplateActor->DefaultGrandchildComponent->GetAttachParent() == TemplateActor->DefaultChildComponent.Get());
+}
+
+ZKZ_ADD_TEST(SubtreePoolForgetsAcquiredInstancesOfDeadOwners)
+{
+	const AComponentTestActor* const DefaultActor = GetDefault<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	AComponentTestActor* const Owner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	AComponentTestActor* const OtherOwner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Owner);
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(OtherOwner);
+
+	FComponentSubtreePool Pool;
+	const USceneComponent& TemplateRoot = *DefaultActor->DefaultComponent;
+
+	USceneComponent* const InstanceRoot = Pool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+	const USceneComponent* const OtherInstanceRoot =
+		Pool.Acquire(TemplateRoot, *OtherOwner, *OtherOwner->DefaultComponent);
+	ZKZ_RETURN_IF(!TestNotNull("Acquired", InstanceRoot));
+	ZKZ_RETURN_IF(!TestNotNull("OtherAcquired", OtherInstanceRoot));
+	TestEqual("BothAcquired", Pool.GetNumAcquired(), 2);
+
+	OtherOwner->Destroy();
+
+	Pool.Release(*InstanceRoot);
+	TestEqual("DeadOwnersInstanceForgotten", Pool.GetNumAcquired(), 0);
+	TestEqual("LiveInstancePooled", Pool.GetNumPooled(TemplateRoot), 1);
+}
+
+ZKZ_ADD_TEST(ScatteredTransformsPropagateToSubtree)
+{
+	// 13 components
+	AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(3, 3);
+	USceneComponent* const RootComponent = Actor.GetRootComponent();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(RootComponent);
+
+	const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{Actor}};
+	const int32 RootIdx = Snapshot.FindIndex(*RootComponent);
+
+	FComponentTransforms Transforms;
+	GatherTransforms(Snapshot, RootIdx, Transforms);
+	ZKZ_RETURN_IF(!TestEqual("AllComponentsGathered", Transforms.Num(), 13));
+	TestEqual("RootHasNoParentEntry", Transforms.ParentEntries[0], INDEX_NONE);
+	TestEqual("FirstChildParentedToRoot", Transforms.ParentEntries[1], 0);
+
+	Transforms.SetRelativeTransform(0, FTransform{FRotator{0.0, 90.0, 0.0}, FVector{100.0, 0.0, 0.0}});
+	Transforms.SetRelativeTransform(2, FTransform{FVector{0.0, 10.0, 0.0}});
+	Transforms.SetRelativeTransform(Transforms.Num() - 1, FTransform{FVector{0.0, 0.0, 1.0}});
+	ScatterTransforms(Snapshot, Transforms);
+
+	TestFalse("DirtyBitsCleared", Transforms.DirtyEntries.Contains(true));
+
+	TArray<FTransform> ExpectedWorldTransforms;
+	for (int32 EntryIdx = 0; EntryIdx < Transforms.Num(); ++EntryIdx)
+	{
+		const int32 ParentEntryIdx = Transforms.ParentEntries[EntryIdx];
+		ExpectedWorldTransforms.Emplace(
+			ParentEntryIdx == INDEX_NONE
+				? Transforms.GetRelativeTransform(EntryIdx)
+				: Transforms.GetRelativeTransform(EntryIdx) * ExpectedWorldTransforms[ParentEntryIdx]);
+
+		const USceneComponent& SceneComp =
+			*CastChecked<USceneComponent>(&Snapshot.GetComponent(Transforms.NodeIndices[EntryIdx]));
+		const FTransform& ExpectedWorldTransform = ExpectedWorldTransforms[EntryIdx];
+		TestTrue(
+			"RelativeTransformWritten",
+			SceneComp.GetRelativeTransform().Equals(Transforms.GetRelativeTransform(EntryIdx)));
+		TestTrue("WorldTransformPropagated", SceneComp.GetComponentTransform().Equals(ExpectedWorldTransform));
+		TestTrue("WorldTransformReadBack", Transforms.GetWorldTransform(EntryIdx).Equals(ExpectedWorldTransform));
+	}
+}
+
 // #TODO #Components: Add test for mixed cpp / blueprint hierarchy
-// #TODO #Components: Add test for add / remove subobject
 // #TODO #Components: Add tests for hierarchy traversal
 
 ZKZ_END_AUTOMATION_TEST(FComponentTest);
 
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FComponentBenchmark,
+	"Zakazane.ZakazaneUtilities.Benchmark.Component",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+ZKZ_ADD_TEST(SnapshotVsHierarchyTraversal)
+{
+	constexpr int32 NumIterations = 1000;
+
+	// 364 components, roughly the size of our large blueprint actors
+	const AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(6, 3);
+	USceneComponent* const RootComponent = Actor.GetRootComponent();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(RootComponent);
+
+	const FComponentHierarchy ComponentHierarchy{Actor};
+	const FComponentHierarchySnapshot Snapshot{ComponentHierarchy};
+
+	int32 NumVisited = 0;
+	const auto CountVisited = [&NumVisited](const UActorComponent&) { ++NumVisited; };
+
+	const double HierarchySeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			ComponentHierarchy.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+				static_cast<const UActorComponent&>(*RootComponent), CountVisited);
+		});
+
+	const double SnapshotSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&] { Snapshot.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(0, CountVisited); });
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("Snapshot prefix traversal (%d components)"), Snapshot.Num()),
+		HierarchySeconds,
+		SnapshotSeconds);
+	TestEqual("AllComponentsVisited", NumVisited, 2 * NumIterations * Snapshot.Num());
+
+	// Descendant checks of every component against the root, walking up the parents as the hierarchy offers no better
+	int32 NumDescendants = 0;
+
+	const double FindParentSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			Snapshot.ForEachComponent(
+				[&](const UActorComponent& Component)
+				{
+					for (const UActorComponent* Parent = ComponentHierarchy.FindParent(Component); Parent != nullptr;
+						 Parent = ComponentHierarchy.FindParent(*Parent))
+					{
+						if (Parent == RootComponent)
+						{
+							++NumDescendants;
+							break;
+						}
+					}
+				});
+		});
+
+	const double IsDescendantSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			for (int32 NodeIdx = 0; NodeIdx < Snapshot.Num(); ++NodeIdx)
+			{
+				NumDescendants += Snapshot.IsDescendant(0, NodeIdx) ? 1 : 0;
+			}
+		});
+
+	ReportBenchmark(*this, TEXT("Snapshot IsDescendant"), FindParentSeconds, IsDescendantSeconds);
+	TestEqual("AllDescendantsFound", NumDescendants, 2 * NumIterations * (Snapshot.Num() - 1));
+}
+
+ZKZ_ADD_TEST(CachedVsGatheredArchetypeHierarchy)
+{
+	constexpr int32 NumIterations = 1000;
+
+	const AComponentTestActorSubclass* const DefaultActor = GetDefault<AComponentTestActorSubclass>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const double GatheredSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[DefaultActor]
+		{
+			FComponentHierarchy::InvalidateArchetypeCache();
+			[[maybe_unused]] const FComponentHierarchy ComponentHierarchy{*DefaultActor};
+		});
+
+	const double CachedSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[DefaultActor] { [[maybe_unused]] const FComponentHierarchy ComponentHierarchy{*DefaultActor}; });
+
+	ReportBenchmark(*this, TEXT("Cached archetype hierarchy construction"), GatheredSeconds, CachedSeconds);
+}
+
+ZKZ_ADD_TEST(ParallelForEachComponentVsSerial)
+{
+	constexpr int32 NumIterations = 10;
+
+	// 21845 components
+	const AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(8, 4);
+	const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{Actor}};
+
+	const double SerialSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&Snapshot]
+		{
+			[[maybe_unused]] uint32 Hash = 0;
+			Snapshot.ForEachComponent(
+				[&Hash](const UActorComponent& Component)
+				{ Hash ^= ComponentTestPrivate::SlowComponentCheck(Component); });
+		});
+
+	const double ParallelSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&Snapshot]
+		{
+			TArray<uint32> Hashes;
+			Snapshot.ParallelForEachComponent(
+				Hashes,
+				[](const UActorComponent& Component, uint32& Hash)
+				{ Hash ^= ComponentTestPrivate::SlowComponentCheck(Component); });
+		});
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("ParallelForEachComponent (%d components)"), Snapshot.Num()),
+		SerialSeconds,
+		ParallelSeconds);
+}
+
+ZKZ_ADD_TEST(SnapshotVsWalkNameLookup)
+{
+	constexpr int32 NumIterations = 10;
+
+	const AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(6, 3);
+	USceneComponent* const RootComponent = Actor.GetRootComponent();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(RootComponent);
+
+	const FComponentHierarchySnapshot Snapshot{FComponentHierarchy{Actor}};
+
+	TArray<FName> Names;
+	Snapshot.ForEachComponent([&Names](const UActorComponent& Component) { Names.Emplace(Component.GetFName()); });
+
+	int32 NumFound = 0;
+
+	const double WalkSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			for (const FName Name : Names)
+			{
+				NumFound += FindComponentInSubtreeByName(*RootComponent, Name) != nullptr ? 1 : 0;
+			}
+		});
+
+	const double SnapshotSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			for (const FName Name : Names)
+			{
+				NumFound += Snapshot.FindIndexInSubtreeByName(0, Name) != INDEX_NONE ? 1 : 0;
+			}
+		});
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("Subtree name lookup (%d components)"), Snapshot.Num()),
+		WalkSeconds,
+		SnapshotSeconds);
+	TestEqual("AllNamesFound", NumFound, 2 * NumIterations * Names.Num());
+}
+
+ZKZ_ADD_TEST(QueryIndexVsTraversal)
+{
+	constexpr int32 NumIterations = 100;
+
+	AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(6, 3);
+	const TArray<FName> Tags = ComponentTestPrivate::TagComponents(Actor);
+
+	const FComponentHierarchy ComponentHierarchy{Actor};
+	const FComponentHierarchySnapshot Snapshot{ComponentHierarchy};
+	const FComponentQueryIndex QueryIndex{Snapshot};
+	USceneComponent* const RootComponent = Actor.GetRootComponent();
+
+	int32 NumFoundByTraversal = 0;
+	int32 NumFoundByQueryIndex = 0;
+
+	const double TraversalSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			ComponentHierarchy.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+				static_cast<const UActorComponent&>(*RootComponent),
+				[&](const UActorComponent& Component)
+				{
+					if (ComponentHasAnyTag(Component, Tags))
+					{
+						++NumFoundByTraversal;
+					}
+				});
+		});
+
+	const double QueryIndexSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{ QueryIndex.ForEachWithAnyTagInSubtree(0, Tags, [&](const UActorComponent&) { ++NumFoundByQueryIndex; }); });
+
+	ReportBenchmark(
+		*this, FString::Printf(TEXT("Tag query (%d components)"), Snapshot.Num()), TraversalSeconds, QueryIndexSeconds);
+	TestEqual("SameNumberFound", NumFoundByQueryIndex, NumFoundByTraversal);
+}
+
+ZKZ_ADD_TEST(IterativeVsRecursiveTraversal)
+{
+	constexpr int32 NumIterations = 100;
+
+	struct FShape
+	{
+		const TCHAR* Name;
+		int32 Depth;
+		int32 NumChildrenPerComponent;
+	};
+
+	// A long attachment chain, a flat list of children and something in between
+	const FShape Shapes[] = {{TEXT("Deep"), 1000, 1}, {TEXT("Wide"), 2, 2000}, {TEXT("Bushy"), 6, 4}};
+	for (const FShape& Shape : Shapes)
+	{
+		const AActor& Actor =
+			ComponentTestPrivate::MakeTransientActorWithComponentTree(Shape.Depth, Shape.NumChildrenPerComponent);
+		const UActorComponent& RootComponent = *Actor.GetRootComponent();
+		const FComponentHierarchy ComponentHierarchy{Actor};
+
+		int32 NumVisited = 0;
+		auto CountVisited = [&NumVisited](const UActorComponent&) { ++NumVisited; };
+
+		const double RecursiveSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&]
+			{
+				ComponentTestPrivate::RecursiveForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+					ComponentHierarchy, RootComponent, CountVisited);
+			});
+
+		const double IterativeSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&]
+			{
+				ComponentHierarchy.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+					RootComponent, CountVisited);
+			});
+
+		ReportBenchmark(
+			*this,
+			FString::Printf(TEXT("%s prefix traversal (%d components)"), Shape.Name, NumVisited / (2 * NumIterations)),
+			RecursiveSeconds,
+			IterativeSeconds);
+
+		// The last component in prefix order, so both searches visit the whole subtree
+		const UActorComponent* LastComponent = nullptr;
+		ComponentHierarchy.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+			RootComponent, [&LastComponent](const UActorComponent& Component) { LastComponent = &Component; });
+
+		const auto IsLastComponent = [LastComponent](const UActorComponent& Component)
+		{ return &Component == LastComponent; };
+		const TFunction<bool(const UActorComponent&)> TypeErasedIsLastComponent = IsLastComponent;
+
+		int32 NumFound = 0;
+
+		const double TypeErasedSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&] { NumFound += FindComponentInSubtree(RootComponent, TypeErasedIsLastComponent) != nullptr ? 1 : 0; });
+
+		const double TemplatedSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&] { NumFound += FindComponentInSubtree(RootComponent, IsLastComponent) != nullptr ? 1 : 0; });
+
+		ReportBenchmark(
+			*this,
+			FString::Printf(TEXT("%s find, templated predicate"), Shape.Name),
+			TypeErasedSeconds,
+			TemplatedSeconds);
+		TestEqual("AllFound", NumFound, 2 * NumIterations);
+	}
+}
+
+ZKZ_ADD_TEST(LiveHierarchyPatchVsRebuild)
+{
+	constexpr int32 NumIterations = 1000;
+
+	AComponentTestActorSubclass* const DefaultActor = GetMutableDefault<AComponentTestActorSubclass>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(DefaultActor);
+
+	const FLiveComponentHierarchy LiveHierarchy{*DefaultActor};
+
+	USceneComponent& NewComponent =
+		ComponentTestPrivate::MakeArchetypeComponent(*DefaultActor, *DefaultActor->DefaultSubclassChildComponent);
+	ON_SCOPE_EXIT
+	{
+		NewComponent.MarkAsGarbage();
+		FComponentHierarchy::InvalidateArchetypeCache();
+	};
+
+	const double RebuildSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[DefaultActor]
+		{
+			FComponentHierarchy::InvalidateArchetypeCache();
+			[[maybe_unused]] const FComponentHierarchy ComponentHierarchy{*DefaultActor};
+		});
+
+	const double PatchSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&NewComponent]
+		{
+			ComponentEvents::OnComponentAdded().Broadcast(NewComponent);
+			ComponentEvents::OnComponentRemoved().Broadcast(NewComponent);
+		});
+
+	ReportBenchmark(*this, TEXT("Live hierarchy add and remove patch"), RebuildSeconds, PatchSeconds);
+}
+
+ZKZ_ADD_TEST(PooledVsClonedSubtreeSpawn)
+{
+	constexpr int32 NumIterations = 1000;
+
+	// 13 components
+	const AActor& TemplateActor = ComponentTestPrivate::MakeTransientActorWithComponentTree(3, 3);
+	const USceneComponent& TemplateRoot = *TemplateActor.GetRootComponent();
+
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	AComponentTestActor* const Owner = TestWorld.Get().SpawnActor<AComponentTestActor>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(Owner);
+
+	// A pool which doesn't keep anything clones and destroys the subtree each time
+	FComponentSubtreePool CloningPool{{}, 0};
+	FComponentSubtreePool Pool;
+
+	const auto SpawnAndDespawn = [&](FComponentSubtreePool& InPool)
+	{
+		USceneComponent* const InstanceRoot = InPool.Acquire(TemplateRoot, *Owner, *Owner->DefaultComponent);
+		ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(InstanceRoot);
+		InPool.Release(*InstanceRoot);
+	};
+
+	const double CloneSeconds = MeasureAverageSeconds(NumIterations, [&] { SpawnAndDespawn(CloningPool); });
+	const double PoolSeconds = MeasureAverageSeconds(NumIterations, [&] { SpawnAndDespawn(Pool); });
+
+	ReportBenchmark(*this, TEXT("Pooled subtree spawn (13 components)"), CloneSeconds, PoolSeconds);
+	TestEqual("OneSubtreePooled", Pool.GetNumPooled(TemplateRoot), 1);
+}
+
+ZKZ_ADD_TEST(ComponentIndexSubsystemVsPerActorHierarchies)
+{
+	constexpr int32 NumIterations = 10;
+	constexpr int32 NumActors = 10000;
+
+	const ComponentTestPrivate::FScopedTestWorld TestWorld;
+	UZkzComponentIndexSubsystem* const ComponentIndex = TestWorld.Get().GetSubsystem<UZkzComponentIndexSubsystem>();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(ComponentIndex);
+
+	const TArray<FName> Tags{"Indexed"};
+	for (int32 ActorIdx = 0; ActorIdx < NumActors; ++ActorIdx)
+	{
+		AComponentTestActor* const Actor = TestWorld.Get().SpawnActor<AComponentTestActor>();
+		if (ActorIdx % 5 == 0)
+		{
+			Actor->DefaultChildComponent->ComponentTags.Append(Tags);
+		}
+	}
+
+	// Builds the index outside of the measurement, as it's only built once per world
+	ComponentIndex->GetNumComponents();
+
+	int32 NumFoundByHierarchies = 0;
+	int32 NumFoundByIndex = 0;
+
+	const double HierarchiesSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			for (TActorIterator<AActor> It{&TestWorld.Get()}; It; ++It)
+			{
+				const FComponentHierarchy ComponentHierarchy{static_cast<const AActor&>(**It)};
+				ComponentHierarchy.ForEachComponent(
+					[&](const UActorComponent& Component)
+					{
+						if (ComponentHasAnyTag(Component, Tags))
+						{
+							++NumFoundByHierarchies;
+						}
+					});
+			}
+		});
+
+	const double IndexSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&] { ComponentIndex->ForEachComponentWithAnyTag(Tags, [&](const UActorComponent&) { ++NumFoundByIndex; }); });
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("World tag query (%d components)"), ComponentIndex->GetNumComponents()),
+		HierarchiesSeconds,
+		IndexSeconds);
+	TestEqual("SameNumberFound", NumFoundByIndex, NumFoundByHierarchies);
+}
+
+ZKZ_ADD_TEST(ScatterTransformsVsPerComponentSet)
+{
+	constexpr int32 NumIterations = 100;
+
+	// 364 components, roughly the size of our large blueprint actors
+	AActor& Actor = ComponentTestPrivate::MakeTransientActorWithComponentTree(6, 3);
+	USceneComponent* const RootComponent = Actor.GetRootComponent();
+	ZKZ_RETURN_IF_INVALID_ENSUREALWAYS(RootComponent);
+
+	const FComponentHierarchy ComponentHierarchy{Actor};
+	const FComponentHierarchySnapshot Snapshot{ComponentHierarchy};
+	const int32 RootIdx = Snapshot.FindIndex(*RootComponent);
+
+	double Offset = 0.0;
+
+	const double PerComponentSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			Offset += 1.0;
+			ComponentHierarchy.ForEachComponentInSubtree<EForEachComponentRecursionType::Prefix>(
+				*RootComponent,
+				[Offset](UActorComponent& Component)
+				{ CastChecked<USceneComponent>(&Component)->SetRelativeLocation(FVector{Offset, 0.0, 0.0}); });
+		});
+
+	FComponentTransforms Transforms;
+	const double ScatterSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&]
+		{
+			Offset += 1.0;
+			GatherTransforms(Snapshot, RootIdx, Transforms);
+			for (int32 EntryIdx = 0; EntryIdx < Transforms.Num(); ++EntryIdx)
+			{
+				Transforms.RelativeLocations[EntryIdx] = FVector{Offset, 0.0, 0.0};
+			}
+			Transforms.DirtyEntries.SetRange(0, Transforms.Num(), true);
+			ScatterTransforms(Snapshot, Transforms);
+		});
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("Gather and scatter transforms (%d components)"), Transforms.Num()),
+		PerComponentSeconds,
+		ScatterSeconds);
+}
+
+ZKZ_END_AUTOMATION_TEST(FComponentBenchmark);
+
 }  // namespace Zkz::Component::Test
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "Zakazane/ErrorContext.h"
+#include "Zakazane/Test/Test.h"
+
+namespace Zkz::Test
+{
+
+namespace ErrorContextTestPrivate
+{
+
+struct FCountingArg
+{
+	int32* NumCopies = nullptr;
+
+	FCountingArg(int32& InNumCopies) : NumCopies{&InNumCopies}
+	{
+	}
+
+	FCountingArg(const FCountingArg& Other) : NumCopies{Other.NumCopies}
+	{
+		++*NumCopies;
+	}
+
+	operator int32() const
+	{
+		return 7;
+	}
+};
+
+TResult<int32, FErrorContext> ParseCount(const FString& Text)
+{
+	int32 Count = 0;
+	ZKZ_RETURN_IF(!LexTryParseString(Count, *Text), Err(ZKZ_ERROR_CONTEXT("\"{0}\" is not a number", Text)));
+	return Count;
+}
+
+}  // namespace ErrorContextTestPrivate
+
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FErrorContextTest,
+	"Zakazane.ZakazaneUtilities.ErrorContext",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+ZKZ_ADD_TEST(FormatsSingleFrame)
+{
+	const FErrorContext Context = ZKZ_ERROR_CONTEXT("Value {0} out of range [{1}, {2}]", 12, 0, 10);
+
+	TestEqual("Single frame", Context.GetFrames().Num(), 1);
+	TestTrue("Formatted message", Context.ToString().StartsWith(TEXT("Value 12 out of range [0, 10] (")));
+	TestTrue("Source location", Context.ToString().Contains(TEXT("ErrorContextTest.cpp:")));
+}
+
+ZKZ_ADD_TEST(CapturesArgumentsByValue)
+{
+	FErrorContext Context;
+
+	{
+		FString Name = TEXT("Original");
+		const TCHAR* NamePtr = *Name;
+		Context = ZKZ_ERROR_CONTEXT("{0} / {1}", Name, NamePtr);
+		Name = TEXT("Changed");
+	}
+
+	TestTrue("Arguments captured on construction", Context.ToString().StartsWith(TEXT("Original / Original")));
+}
+
+ZKZ_ADD_TEST(AddsContextOnlyOnError)
+{
+	int32 NumCopies = 0;
+	const ErrorContextTestPrivate::FCountingArg CountingArg{NumCopies};
+
+	const TResult<int32, FErrorContext> Parsed = ErrorContextTestPrivate::ParseCount(TEXT("12"))
+		.OrElse(ZKZ_ADD_ERROR_CONTEXT(int32, "Parsing count {0}", CountingArg));
+
+	TestEqual("Value passed through", Parsed.GetValueOr(0), 12);
+	TestEqual("Arguments not captured for values", NumCopies, 0);
+
+	const TResult<int32, FErrorContext> Failed = ErrorContextTestPrivate::ParseCount(TEXT("twelve"))
+		.AndThen([](const int32 Count) -> TResult<int32, FErrorContext> { return Count * 2; })
+		.OrElse(ZKZ_ADD_ERROR_CONTEXT(int32, "Parsing count {0}", CountingArg));
+
+	ZKZ_RETURN_IF(!TestTrue("Error passed through", Failed.HasError()));
+	TestEqual("Arguments captured for errors", NumCopies, 1);
+	TestEqual("Frame added", Failed.GetError().GetFrames().Num(), 2);
+
+	const FString Text = Failed.GetError().ToString();
+	TestTrue("Outermost frame first", Text.StartsWith(TEXT("Parsing count 7 (")));
+	TestTrue("Inner frame after outer", Text.Contains(TEXT("caused by: \"twelve\" is not a number (")));
+}
+
+ZKZ_END_AUTOMATION_TEST(FErrorContextTest);
+
+}  // namespace Zkz::Test
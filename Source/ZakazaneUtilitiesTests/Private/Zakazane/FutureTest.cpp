@@ -108,6 +108,45 @@ ZKZ_ADD_TEST(ScopedPromiseSetsOnDeleteIfNotExecutedOrMovedFrom)
 	}
 }
 
+ZKZ_ADD_TEST(PooledPromiseRecyclesSharedState)
+{
+	// Warm up the pool so that the following allocations are served from this thread's free list
+	{
+		TPooledPromise<int> P;
+		P.SetValue(0);
+	}
+
+	const SmallObjectPool::FStats StatsBefore = SmallObjectPool::GetStats();
+
+	for (int Idx = 0; Idx < 100; ++Idx)
+	{
+		TPooledPromise<int> P;
+		const TFuture<int> F = P.GetFuture();
+		P.SetValue(Idx);
+		TestEqual("ValuePresentInFuture", F.Get(), Idx);
+	}
+
+	const SmallObjectPool::FStats StatsAfter = SmallObjectPool::GetStats();
+
+	TestTrue("SharedStatesServedFromPool", StatsAfter.NumHits >= StatsBefore.NumHits + 100);
+	TestTrue("PeakLiveTracked", StatsAfter.PeakLive >= 1);
+
+	{
+		TPooledPromise<void> P;
+		const TFuture<void> F = P.GetFuture();
+		P.SetValue();
+		TestTrue("VoidFutureReady", F.IsReady());
+	}
+
+	{
+		int Value = 3;
+		TPooledPromise<int&> P;
+		const TFuture<int&> F = P.GetFuture();
+		P.SetValue(Value);
+		TestEqual("ReferenceFutureHoldsReference", &F.Get(), &Value);
+	}
+}
+
 ZKZ_ADD_TEST(AggregateFuturesAccumulatesResults)
 {
 	TArray<TPromise<int>> Promises;
@@ -255,6 +294,248 @@ ZKZ_ADD_TEST(CollapseFutureCanceledToError)
 	TestEqual("ErrorHasCollapsedValue", FutureResult.Get().GetError(), 3);
 }
 
+ZKZ_ADD_TEST(WithTimeoutResolvesWithValueOrTimeout)
+{
+	const TSharedRef<FTimerWheel, ESPMode::ThreadSafe> Wheel =
+		MakeShared<FTimerWheel, ESPMode::ThreadSafe>(FTimespan::FromMilliseconds(1));
+
+	{
+		TPromise<int> Promise;
+		const TFutureResult<int, FTimeout> Future =
+			WithTimeout(Promise.GetFuture(), FTimespan::FromMilliseconds(10), Wheel);
+
+		Wheel->Tick(5);
+		Promise.SetValue(3);
+
+		ZKZ_RETURN_IF(!TestTrue("FulfilledInTimeIsReady", Future.IsReady()));
+		TestEqual("FulfilledInTimeHasValue", Future.Get().GetValueOr(-1), 3);
+		TestEqual("TimerCanceledWhenFulfilled", Wheel->GetNumPending(), 0);
+	}
+
+	{
+		TPromise<void> Promise;
+		const TFutureResult<void, FTimeout> Future =
+			WithTimeout(Promise.GetFuture(), FTimespan::FromMilliseconds(10), Wheel);
+
+		Wheel->Tick(9);
+		TestFalse("NotReadyBeforeTimeout", Future.IsReady());
+
+		Wheel->Tick();
+		ZKZ_RETURN_IF(!TestTrue("ReadyAfterTimeout", Future.IsReady()));
+		TestTrue("TimedOut", Future.Get().HasError());
+
+		// Late fulfilment is ignored
+		Promise.SetValue();
+		TestTrue("StillTimedOut", Future.Get().HasError());
+	}
+
+	{
+		TScopedPromise<FString> Promise;
+		const TFutureResult<TCancelableFutureResult<FString>, FTimeout> Future =
+			WithTimeout(Promise.GetFuture(), FTimespan::FromSeconds(5));
+		Promise.SetValue(TEXT("Value"));
+
+		ZKZ_RETURN_IF(!TestTrue("SharedWheelFulfilledInTime", Future.WaitFor(FTimespan::FromSeconds(1))));
+		ZKZ_RETURN_IF(!TestTrue("SharedWheelNotTimedOut", Future.Get().HasValue()));
+		TestEqual("SharedWheelHasValue", Future.Get().GetValue().GetValueOr(FString{}), TEXT("Value"));
+	}
+
+	{
+		TPromise<int> Promise;
+		const TFutureResult<int, FTimeout> Future = WithTimeout(Promise.GetFuture(), FTimespan::FromMilliseconds(20));
+
+		TestTrue("SharedWheelTimesOut", Future.WaitFor(FTimespan::FromSeconds(5)) && Future.Get().HasError());
+		Promise.SetValue(0);
+	}
+
+	{
+		TSharedPtr<FTimerWheel, ESPMode::ThreadSafe> ReleasedWheel =
+			MakeShared<FTimerWheel, ESPMode::ThreadSafe>(FTimespan::FromMilliseconds(1));
+
+		TPromise<int> Promise;
+		const TFutureResult<int, FTimeout> Future =
+			WithTimeout(Promise.GetFuture(), FTimespan::FromMilliseconds(10), ReleasedWheel);
+
+		// Fulfilling after the wheel is gone must not touch it
+		ReleasedWheel.Reset();
+		Promise.SetValue(4);
+
+		ZKZ_RETURN_IF(!TestTrue("ReleasedWheelIsReady", Future.IsReady()));
+		TestEqual("ReleasedWheelHasValue", Future.Get().GetValueOr(-1), 4);
+	}
+
+	{
+		TPromise<int> Promise;
+		const TFutureResult<int, FTimeout> Future =
+			WithTimeout(Promise.GetFuture(), FTimespan::FromMilliseconds(1), nullptr);
+
+		TestFalse("WithoutWheelNeverTimesOut", Future.WaitFor(FTimespan::FromMilliseconds(20)));
+
+		Promise.SetValue(5);
+		ZKZ_RETURN_IF(!TestTrue("WithoutWheelIsReady", Future.IsReady()));
+		TestEqual("WithoutWheelHasValue", Future.Get().GetValueOr(-1), 5);
+	}
+}
+
+ZKZ_ADD_TEST(LongReadyChainsDoNotNestOnStack)
+{
+	constexpr int32 ChainLength = 100000;
+
+	{
+		TPromise<int32> RootPromise;
+		TFuture<int32> Future = RootPromise.GetFuture();
+
+		for (int32 Idx = 0; Idx < ChainLength; ++Idx)
+		{
+			Future = Next(MoveTemp(Future), [](const int32 Value) { return Value + 1; });
+		}
+
+		// Fulfilling the root runs the whole chain, which would overflow the stack if continuations were nested
+		RootPromise.SetValue(0);
+
+		ZKZ_RETURN_IF(!TestTrue("NextChainCompleted", Future.IsReady()));
+		TestEqual("NextChainResult", Future.Get(), ChainLength);
+	}
+
+	{
+		TArray<TFuture<int32>> Futures;
+		Futures.Reserve(ChainLength);
+		for (int32 Idx = 0; Idx < ChainLength; ++Idx)
+		{
+			Futures.Emplace(MakeFulfilledPromise<int32>(1).GetFuture());
+		}
+
+		const TFuture<int32> AggregatedFuture =
+			AggregateFutures(MoveTemp(Futures), 0, [](const int32 Sum, const int32 Value) { return Sum + Value; });
+
+		ZKZ_RETURN_IF(!TestTrue("AggregateCompleted", AggregatedFuture.IsReady()));
+		TestEqual("AggregateResult", AggregatedFuture.Get(), ChainLength);
+	}
+
+	{
+		TArray<TScopedPromise<void>> Promises;
+		Promises.SetNum(ChainLength);
+
+		int32 NumCalled = 0;
+		for (int32 Idx = 0; Idx < ChainLength - 1; ++Idx)
+		{
+			IfNotCanceled(
+				Promises[Idx].GetFuture(),
+				[&Promises, &NumCalled, Idx]
+				{
+					++NumCalled;
+					Promises[Idx + 1].EmplaceValue();
+				});
+		}
+
+		Promises[0].EmplaceValue();
+		TestEqual("IfNotCanceledChainCompleted", NumCalled, ChainLength - 1);
+	}
+
+	{
+		bool bInnerCalled = false;
+		bool bInnerCalledBeforeOuterReturned = false;
+
+		Trampoline::Run(
+			[&]
+			{
+				Trampoline::Run([&bInnerCalled] { bInnerCalled = true; });
+				bInnerCalledBeforeOuterReturned = bInnerCalled;
+			});
+
+		TestTrue("NestedRunCalled", bInnerCalled);
+		TestTrue("ShallowNestedRunInlined", bInnerCalledBeforeOuterReturned);
+	}
+
+	{
+		int32 MaxDepth = 0;
+		int32 Nesting = 0;
+		int32 MaxNesting = 0;
+
+		TFunction<void(int32)> Recurse = [&](const int32 Depth)
+		{
+			MaxDepth = FMath::Max(MaxDepth, Depth);
+			MaxNesting = FMath::Max(MaxNesting, ++Nesting);
+
+			if (Depth < Trampoline::MaxInlineDepth * 2)
+			{
+				Trampoline::Run([&Recurse, Depth] { Recurse(Depth + 1); });
+			}
+
+			--Nesting;
+		};
+		Trampoline::Run([&Recurse] { Recurse(1); });
+
+		TestEqual("DeepNestedRunCalled", MaxDepth, Trampoline::MaxInlineDepth * 2);
+		TestTrue("DeepNestedRunDeferred", MaxNesting <= Trampoline::MaxInlineDepth);
+	}
+}
+
+ZKZ_ADD_TEST(ContinuationCanWaitOnNestedFuture)
+{
+	TPromise<int32> Promise;
+
+	const TFuture<int32> Future = Next(
+		Promise.GetFuture(),
+		[](const int32 Value)
+		{
+			TPromise<int32> InnerPromise;
+			const TFuture<int32> InnerFuture = Next(InnerPromise.GetFuture(), [](const int32 V) { return V + 1; });
+			InnerPromise.SetValue(Value);
+
+			// Would never complete if the inner continuation were queued behind this one
+			return InnerFuture.WaitFor(FTimespan::FromSeconds(1)) ? InnerFuture.Get() : -1;
+		});
+
+	Promise.SetValue(1);
+
+	ZKZ_RETURN_IF(!TestTrue("Completed", Future.IsReady()));
+	TestEqual("NestedResult", Future.Get(), 2);
+}
+
+#if ZKZ_WITH_FUTURE_REGISTRY
+ZKZ_ADD_TEST(FutureRegistryTracksPendingPromises)
+{
+	const auto GetNumCompleted = []
+	{
+		int64 NumCompleted = 0;
+		for (const int64 BucketCount : FutureRegistry::GetLifetimeHistogram())
+		{
+			NumCompleted += BucketCount;
+		}
+		return NumCompleted;
+	};
+
+	const int32 InitialNumPending = FutureRegistry::GetNumPending();
+	const int64 InitialNumCompleted = GetNumCompleted();
+
+	{
+		TScopedPromise<int32> Fulfilled{ZKZ_PROMISE_SITE};
+		TScopedPromise<int32> Canceled{ZKZ_PROMISE_SITE};
+		TestEqual("BothPending", FutureRegistry::GetNumPending(), InitialNumPending + 2);
+
+		const TArray<FutureRegistry::FPendingEntry> Pending = FutureRegistry::GetOldestPending(MAX_int32);
+		TestTrue(
+			"SiteRecorded",
+			Pending.ContainsByPredicate(
+				[](const FutureRegistry::FPendingEntry& Entry)
+				{
+					return Entry.Site.File != nullptr
+						&& FCStringAnsi::Strstr(Entry.Site.File, "FutureTest") != nullptr;
+				}));
+
+		Fulfilled.SetValue(42);
+		TestEqual("FulfilledUnregistered", FutureRegistry::GetNumPending(), InitialNumPending + 1);
+
+		TScopedPromise<int32> MovedTo = MoveTemp(Canceled);
+		TestEqual("MoveKeepsRegistration", FutureRegistry::GetNumPending(), InitialNumPending + 1);
+	}
+
+	TestEqual("CanceledUnregistered", FutureRegistry::GetNumPending(), InitialNumPending);
+	TestEqual("LifetimesRecorded", GetNumCompleted(), InitialNumCompleted + 2);
+}
+#endif
+
 ZKZ_END_AUTOMATION_TEST(FFutureTest);
 
 }  // namespace Zkz::Test
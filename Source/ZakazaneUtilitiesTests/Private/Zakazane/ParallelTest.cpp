@@ -0,0 +1,226 @@
+#include "Async/Async.h"
+#include "Zakazane/Parallel.h"
+#include "Zakazane/Test/Benchmark.h"
+#include "Zakazane/Test/Test.h"
+
+namespace Zkz::Test
+{
+
+namespace ParallelTestPrivate
+{
+
+double SlowSqrt(const int32 Value)
+{
+	double Result = Value;
+	for (int32 Iteration = 0; Iteration < 64; ++Iteration)
+	{
+		Result = FMath::Sqrt(Result * Result + Value);
+	}
+	return Result;
+}
+
+TArray<int32> MakeInput(const int32 Num)
+{
+	TArray<int32> Input;
+	Input.Reserve(Num);
+	for (int32 Idx = 0; Idx < Num; ++Idx)
+	{
+		Input.Emplace(Idx);
+	}
+	return Input;
+}
+
+/// Fails for negative values
+TResult<double, int32> ValidatedSlowSqrt(const int32 Value)
+{
+	ZKZ_RETURN_IF(Value < 0, Err(Value));
+	return SlowSqrt(Value);
+}
+
+}  // namespace ParallelTestPrivate
+
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FParallelTest,
+	"Zakazane.ZakazaneUtilities.Parallel",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+ZKZ_ADD_TEST(ParallelTransformAsyncPreservesOrder)
+{
+	const TArray<int32> Input = ParallelTestPrivate::MakeInput(10000);
+
+	const TFuture<TArray<FString>> Future =
+		ParallelTransformAsync(MakeArrayView(Input), [](const int32 Value) { return LexToString(Value * 2); });
+
+	const TArray<FString>& Output = Future.Get();
+	ZKZ_RETURN_IF(!TestEqual("OutputHasInputSize", Output.Num(), Input.Num()));
+
+	for (int32 Idx = 0; Idx < Input.Num(); ++Idx)
+	{
+		ZKZ_RETURN_IF(!TestEqual("OutputInInputOrder", Output[Idx], LexToString(Idx * 2)));
+	}
+}
+
+ZKZ_ADD_TEST(ParallelTransformAsyncHandlesSmallInputs)
+{
+	{
+		const TArray<int32> Input;
+		const TFuture<TArray<int32>> Future =
+			ParallelTransformAsync(MakeArrayView(Input), [](const int32 Value) { return Value; });
+		TestTrue("EmptyInputReady", Future.IsReady());
+		TestTrue("EmptyInputGivesEmptyOutput", Future.Get().IsEmpty());
+	}
+
+	{
+		const TArray<int32> Input{7};
+		const TFuture<TArray<int32>> Future =
+			ParallelTransformAsync(MakeArrayView(Input), [](const int32 Value) { return Value + 1; });
+		TestEqual("SingleElementTransformed", Future.Get(), TArray<int32>{8});
+	}
+}
+
+ZKZ_ADD_TEST(CollectResultsReturnsValuesInOrder)
+{
+	const TArray<int32> Input = ParallelTestPrivate::MakeInput(10000);
+
+	const TResult<TArray<FString>, TArray<FString>> Result = CollectResults(
+		MakeArrayView(Input), [](const int32 Value) -> TResult<FString, FString> { return LexToString(Value * 2); });
+
+	ZKZ_RETURN_IF(!TestTrue("NoErrors", Result.HasValue()));
+	ZKZ_RETURN_IF(!TestEqual("OutputHasInputSize", Result->Num(), Input.Num()));
+
+	for (int32 Idx = 0; Idx < Input.Num(); ++Idx)
+	{
+		ZKZ_RETURN_IF(!TestEqual("OutputInInputOrder", (*Result)[Idx], LexToString(Idx * 2)));
+	}
+}
+
+ZKZ_ADD_TEST(CollectResultsReturnsErrors)
+{
+	TArray<int32> Input = ParallelTestPrivate::MakeInput(10000);
+	Input[5000] = -1;
+	Input[7000] = -2;
+	Input[9999] = -3;
+
+	const auto Validate = [](const int32 Value) -> TResult<FString, int32>
+	{
+		ZKZ_RETURN_IF(Value < 0, Err(Value));
+		return LexToString(Value);
+	};
+
+	{
+		const TResult<TArray<FString>, TArray<int32>> Result =
+			CollectResults(MakeArrayView(Input), Validate, ECollectResultsMode::AllErrors);
+
+		ZKZ_RETURN_IF(!TestTrue("AllErrors - HasError", Result.HasError()));
+		TestEqual("AllErrors - all errors in input order", Result.GetError(), TArray<int32>{-1, -2, -3});
+	}
+
+	{
+		const TResult<TArray<FString>, TArray<int32>> Result =
+			CollectResults(MakeArrayView(Input), Validate, ECollectResultsMode::FirstError);
+
+		ZKZ_RETURN_IF(!TestTrue("FirstError - HasError", Result.HasError()));
+		ZKZ_RETURN_IF(!TestEqual("FirstError - single error", Result.GetError().Num(), 1));
+		TestTrue("FirstError - one of the errors", Result.GetError()[0] < 0);
+	}
+
+	{
+		const TArray<int32> Empty;
+		const TResult<TArray<FString>, TArray<int32>> Result = CollectResults(MakeArrayView(Empty), Validate);
+		TestTrue("EmptyInputGivesEmptyOutput", Result.HasValue() && Result->IsEmpty());
+	}
+}
+
+ZKZ_END_AUTOMATION_TEST(FParallelTest);
+
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FParallelBenchmark,
+	"Zakazane.ZakazaneUtilities.Benchmark.Parallel",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+ZKZ_ADD_TEST(ParallelTransformAsyncVsAggregateFutures)
+{
+	constexpr int32 NumIterations = 10;
+
+	for (const int32 NumElements : {100, 10000})
+	{
+		const TArray<int32> Input = ParallelTestPrivate::MakeInput(NumElements);
+
+		const double AggregateSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&Input]
+			{
+				TArray<TFuture<double>> Futures;
+				Futures.Reserve(Input.Num());
+				for (const int32 Value : Input)
+				{
+					Futures.Emplace(
+						Async(EAsyncExecution::TaskGraph, [Value] { return ParallelTestPrivate::SlowSqrt(Value); }));
+				}
+
+				TArray<double> InitialResult;
+				InitialResult.Reserve(Input.Num());
+				AggregateFutures(
+					MoveTemp(Futures),
+					MoveTemp(InitialResult),
+					[](TArray<double>&& Results, const double Result) -> TArray<double>
+					{
+						Results.Emplace(Result);
+						return MoveTemp(Results);
+					})
+					.Wait();
+			});
+
+		const double ParallelSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&Input] { ParallelTransformAsync(MakeArrayView(Input), &ParallelTestPrivate::SlowSqrt).Wait(); });
+
+		ReportBenchmark(
+			*this,
+			FString::Printf(TEXT("ParallelTransformAsync (%d elements)"), NumElements),
+			AggregateSeconds,
+			ParallelSeconds);
+	}
+}
+
+ZKZ_ADD_TEST(CollectResultsVsSerialLoop)
+{
+	constexpr int32 NumIterations = 10;
+
+	for (const int32 NumElements : {100, 10000, 1000000})
+	{
+		const TArray<int32> Input = ParallelTestPrivate::MakeInput(NumElements);
+
+		const double SerialSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&Input]
+			{
+				TArray<double> Values;
+				Values.Reserve(Input.Num());
+				for (const int32 Value : Input)
+				{
+					TResult<double, int32> Result = ParallelTestPrivate::ValidatedSlowSqrt(Value);
+					if (Result.HasError())
+					{
+						break;
+					}
+					Values.Emplace(*Result);
+				}
+			});
+
+		const double ParallelSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&Input]
+			{
+				[[maybe_unused]] const TResult<TArray<double>, TArray<int32>> Result =
+					CollectResults(MakeArrayView(Input), &ParallelTestPrivate::ValidatedSlowSqrt);
+			});
+
+		ReportBenchmark(
+			*this, FString::Printf(TEXT("CollectResults (%d elements)"), NumElements), SerialSeconds, ParallelSeconds);
+	}
+}
+
+ZKZ_END_AUTOMATION_TEST(FParallelBenchmark);
+
+}  // namespace Zkz::Test
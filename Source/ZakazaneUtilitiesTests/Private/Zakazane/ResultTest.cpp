@@ -1,11 +1,37 @@
 #include "Zakazane/Monostate.h"
 #include "Zakazane/Result.h"
+#include "Zakazane/ReturnIfMacros.h"
+#include "Zakazane/Test/Benchmark.h"
 #include "Zakazane/Test/ConstructionReportingType.h"
 #include "Zakazane/Test/Test.h"
 
 namespace Zkz::Test
 {
 
+namespace ResultTestPrivate
+{
+
+/// Runs a short AndThen / OrElse chain for each pointer, every third chain starting with an error
+template <class ErrorType>
+int64 RunAndThenOrElseChains(const TArray<int32*>& Pointers)
+{
+	using FResult = TResult<int32*, ErrorType>;
+
+	int64 Sum = 0;
+	for (int32 Idx = 0; Idx < Pointers.Num(); ++Idx)
+	{
+		FResult Result = Idx % 3 == 0 ? FResult{Unexpect} : FResult{Pointers[Idx]};
+		Result = MoveTemp(Result)
+					 .AndThen([](int32* const Ptr) { return Ptr != nullptr ? FResult{Ptr} : FResult{Unexpect}; })
+					 .OrElse([&Pointers](const ErrorType&) { return FResult{Pointers[0]}; })
+					 .AndThen([](int32* const Ptr) { return FResult{Ptr}; });
+		Sum += *Result.GetValue();
+	}
+	return Sum;
+}
+
+}  // namespace ResultTestPrivate
+
 ZKZ_BEGIN_AUTOMATION_TEST(
 	FResultTest,
 	"Zakazane.ZakazaneUtilities.Result",
@@ -790,6 +816,171 @@ ZKZ_ADD_TEST(CollapseNestedResults)
 	TestTrue("Compile-time tests", true);
 }
 
+ZKZ_ADD_TEST(CompactLayouts)
+{
+	{
+		int32 Value = 3;
+
+		const TResult<int32*, FMonostate> NullValue{nullptr};
+		TestTrue("Null pointer is a value", NullValue.HasValue());
+		TestNull("Null pointer value", NullValue.GetValue());
+
+		const TResult<int32*, FMonostate> PointerValue{&Value};
+		TestEqual("Pointer value", PointerValue.GetValue(), &Value);
+
+		TResult<int32*, FMonostate> Error{Unexpect};
+		TestTrue("Niche error - HasError", Error.HasError());
+
+		Error = PointerValue;
+		TestEqual("Niche error assigned value", Error.GetValue(), &Value);
+	}
+
+	{
+		// Handle-like values such as INVALID_HANDLE_VALUE use the last address
+		void* const InvalidHandle = reinterpret_cast<void*>(~UPTRINT{0});
+
+		const TResult<void*, FMonostate> HandleValue{InvalidHandle};
+		TestTrue("Last address is a void pointer value", HandleValue.HasValue());
+		TestEqual("Last address void pointer value", HandleValue.GetValue(), InvalidHandle);
+	}
+
+	{
+		constexpr TResult<int, FMonostate> Value{3};
+		static_assert(Value.HasValue());
+		static_assert(Value.GetValue() == 3);
+
+		constexpr TResult<int, FMonostate> Error{Unexpect};
+		static_assert(Error.HasError());
+	}
+
+	{
+		constexpr TResult<void, FMonostate> Value;
+		static_assert(Value.HasValue());
+
+		constexpr TResult<void, FMonostate> Error{Unexpect};
+		static_assert(Error.HasError());
+	}
+}
+
+ZKZ_ADD_TEST(TryPropagatesErrorWithoutCopies)
+{
+	{
+		FConstructionReport SourceConstructionReport, TargetConstructionReport;
+		TResult<int, FConstructionReportingType> Source{Unexpect, SourceConstructionReport, TargetConstructionReport};
+		{
+			const TResult<void, FConstructionReportingType> Propagated =
+				[&Source]() -> TResult<void, FConstructionReportingType>
+			{
+				ZKZ_TRY(MoveTemp(Source));
+				return Ok();
+			}();
+
+			ZKZ_RETURN_IF(!TestTrue("ZKZ_TRY returns error", Propagated.HasError()));
+			Source.GetError().TestMovedFrom(*this, Propagated.GetError(), TEXT("ZKZ_TRY: "));
+		}
+		TargetConstructionReport.TestMoveConstructed(*this, TEXT("ZKZ_TRY: "));
+	}
+
+	{
+		FConstructionReport SourceConstructionReport, TargetConstructionReport;
+		TResult<int, FConstructionReportingType> Source{Unexpect, SourceConstructionReport, TargetConstructionReport};
+		{
+			bool bAssigned = false;
+			const TResult<FString, FConstructionReportingType> Propagated =
+				[&Source, &bAssigned]() -> TResult<FString, FConstructionReportingType>
+			{
+				ZKZ_TRY_ASSIGN(const int Value, MoveTemp(Source));
+				bAssigned = true;
+				return LexToString(Value);
+			}();
+
+			TestFalse("ZKZ_TRY_ASSIGN does not continue on error", bAssigned);
+			ZKZ_RETURN_IF(!TestTrue("ZKZ_TRY_ASSIGN returns error", Propagated.HasError()));
+			Source.GetError().TestMovedFrom(*this, Propagated.GetError(), TEXT("ZKZ_TRY_ASSIGN: "));
+		}
+		TargetConstructionReport.TestMoveConstructed(*this, TEXT("ZKZ_TRY_ASSIGN: "));
+	}
+
+	{
+		struct FWrappedError
+		{
+			FConstructionReportingType Inner;
+
+			explicit FWrappedError(FConstructionReportingType&& InInner) : Inner{MoveTemp(InInner)}
+			{
+			}
+		};
+
+		FConstructionReport SourceConstructionReport, TargetConstructionReport;
+		TResult<int, FConstructionReportingType> Source{Unexpect, SourceConstructionReport, TargetConstructionReport};
+		{
+			const TResult<int, FWrappedError> Propagated = [&Source]() -> TResult<int, FWrappedError>
+			{
+				ZKZ_TRY(MoveTemp(Source));
+				return 0;
+			}();
+
+			ZKZ_RETURN_IF(!TestTrue("ZKZ_TRY returns converted error", Propagated.HasError()));
+			Source.GetError().TestMovedFrom(*this, Propagated.GetError().Inner, TEXT("ZKZ_TRY converting: "));
+		}
+		TargetConstructionReport.TestMoveConstructed(*this, TEXT("ZKZ_TRY converting: "));
+	}
+
+	{
+		FConstructionReport SourceConstructionReport, TargetConstructionReport;
+		TResult<FConstructionReportingType, int> Source{InPlace, SourceConstructionReport, TargetConstructionReport};
+		{
+			const TResult<bool, int> Continued = [this, &Source]() -> TResult<bool, int>
+			{
+				ZKZ_TRY_ASSIGN(const FConstructionReportingType Value, MoveTemp(Source));
+				Source->TestMovedFrom(*this, Value, TEXT("ZKZ_TRY_ASSIGN value: "));
+				return true;
+			}();
+
+			TestTrue("ZKZ_TRY_ASSIGN continues on value", Continued.HasValue());
+		}
+		TargetConstructionReport.TestMoveConstructed(*this, TEXT("ZKZ_TRY_ASSIGN value: "));
+	}
+}
+
 ZKZ_END_AUTOMATION_TEST(FResultTest);
 
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FResultBenchmark,
+	"Zakazane.ZakazaneUtilities.Benchmark.Result",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+ZKZ_ADD_TEST(AndThenOrElseChains)
+{
+	constexpr int32 NumIterations = 100;
+	constexpr int32 NumChains = 100000;
+
+	TArray<int32> Values;
+	TArray<int32*> Pointers;
+	Values.SetNumZeroed(NumChains);
+	Pointers.Reserve(NumChains);
+	for (int32 Idx = 0; Idx < NumChains; ++Idx)
+	{
+		Values[Idx] = Idx;
+		Pointers.Emplace(&Values[Idx]);
+	}
+
+	int64 VariantSum = 0;
+	const double VariantSeconds = MeasureAverageSeconds(
+		NumIterations, [&] { VariantSum += ResultTestPrivate::RunAndThenOrElseChains<int32>(Pointers); });
+
+	int64 NicheSum = 0;
+	const double NicheSeconds = MeasureAverageSeconds(
+		NumIterations, [&] { NicheSum += ResultTestPrivate::RunAndThenOrElseChains<FMonostate>(Pointers); });
+
+	TestEqual("Both layouts compute the same", NicheSum, VariantSum);
+	ReportBenchmark(
+		*this,
+		TEXT("AndThen / OrElse chains, TResult<int32*, FMonostate> vs TResult<int32*, int32>"),
+		VariantSeconds,
+		NicheSeconds);
+}
+
+ZKZ_END_AUTOMATION_TEST(FResultBenchmark);
+
 }  // namespace Zkz::Test
@@ -0,0 +1,585 @@
+#include "SerializationTest.h"
+
+#include "Misc/ScopeLock.h"
+#include "Serialization/Csv/CsvParser.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Zakazane/Serialization.h"
+#include "Zakazane/Test/Benchmark.h"
+#include "Zakazane/Test/Test.h"
+
+namespace Zkz::Serialization::Test
+{
+
+using Zkz::Test::MeasureAverageSeconds;
+using Zkz::Test::ReportBenchmark;
+
+namespace SerializationTestPrivate
+{
+
+/// Rows with cells which need quoting: commas, quotes, line breaks and non-ASCII characters
+TArray<FZkzSerializationTestRow> MakeRows(const int32 NumRows)
+{
+	TArray<FZkzSerializationTestRow> Rows;
+	for (int32 RowIdx = 0; RowIdx < NumRows; ++RowIdx)
+	{
+		FZkzSerializationTestRow& Row = Rows.Emplace_GetRef();
+		Row.Id = RowIdx;
+		Row.Name = FString::Printf(TEXT("Row %d, \"quoted\"\nnext line"), RowIdx);
+		Row.Label = FText::FromString(FString::Printf(TEXT("Za\u017C\u00F3\u0142\u0107 %d"), RowIdx));
+		Row.Value = RowIdx * 0.5f;
+	}
+	return Rows;
+}
+
+TArray<uint8> ToUTF8(const FString& String)
+{
+	const FTCHARToUTF8 Converted{*String};
+	return TArray<uint8>{reinterpret_cast<const uint8*>(Converted.Get()), Converted.Length()};
+}
+
+TArray<uint8> ToUTF16LEWithByteOrderMark(const FString& String)
+{
+	const auto Converted = StringCast<UTF16CHAR>(*String);
+
+	TArray<uint8> Bytes{0xFF, 0xFE};
+	for (int32 UnitIdx = 0; UnitIdx < Converted.Length(); ++UnitIdx)
+	{
+		const uint16 CodeUnit = Converted.Get()[UnitIdx];
+		Bytes.Emplace(static_cast<uint8>(CodeUnit & 0xFF));
+		Bytes.Emplace(static_cast<uint8>(CodeUnit >> 8));
+	}
+	return Bytes;
+}
+
+TArray<FZkzSerializationTestRow> ImportFromBytes(const TArray<uint8>& Bytes, EImportResult& OutResult)
+{
+	TArray<FZkzSerializationTestRow> Rows;
+	FMemoryReader Reader{Bytes};
+	OutResult = ImportFromCSV<FZkzSerializationTestRow>(
+		Reader, [&Rows](const FZkzSerializationTestRow& Row) { Rows.Emplace(Row); });
+	return Rows;
+}
+
+bool RowsEqual(const TArray<FZkzSerializationTestRow>& Lhs, const TArray<FZkzSerializationTestRow>& Rhs)
+{
+	ZKZ_RETURN_IF(Lhs.Num() != Rhs.Num(), false);
+
+	for (int32 RowIdx = 0; RowIdx < Lhs.Num(); ++RowIdx)
+	{
+		const FZkzSerializationTestRow& L = Lhs[RowIdx];
+		const FZkzSerializationTestRow& R = Rhs[RowIdx];
+		ZKZ_RETURN_IF(L.Id != R.Id || L.Name != R.Name || L.Value != R.Value, false);
+		ZKZ_RETURN_IF(!L.Label.ToString().Equals(R.Label.ToString()), false);
+	}
+
+	return true;
+}
+
+TArray<FZkzSerializationNumericRow> MakeNumericRows(const int32 NumRows)
+{
+	TArray<FZkzSerializationNumericRow> Rows;
+	for (int32 RowIdx = 0; RowIdx < NumRows; ++RowIdx)
+	{
+		FZkzSerializationNumericRow& Row = Rows.Emplace_GetRef();
+		Row.Id = RowIdx - NumRows / 2;
+		Row.Count = static_cast<int64>(RowIdx) * 1000000007;
+		Row.Flags = static_cast<uint8>(RowIdx);
+		Row.Mask = static_cast<uint32>(RowIdx) * 2654435761u;
+		Row.X = RowIdx * 0.25f;
+		Row.Y = -RowIdx / 3.0f;
+		Row.Weight = RowIdx * 1.0e-3;
+		Row.bEnabled = RowIdx % 2 == 0;
+		Row.Kind = static_cast<EZkzSerializationTestEnum>(RowIdx % 3);
+		Row.Tag = FName{TEXT("Tag"), RowIdx % 8};
+	}
+	return Rows;
+}
+
+bool NumericRowsEqual(const TArray<FZkzSerializationNumericRow>& Lhs, const TArray<FZkzSerializationNumericRow>& Rhs)
+{
+	ZKZ_RETURN_IF(Lhs.Num() != Rhs.Num(), false);
+
+	for (int32 RowIdx = 0; RowIdx < Lhs.Num(); ++RowIdx)
+	{
+		const FZkzSerializationNumericRow& L = Lhs[RowIdx];
+		const FZkzSerializationNumericRow& R = Rhs[RowIdx];
+		ZKZ_RETURN_IF(L.Id != R.Id || L.Count != R.Count || L.Flags != R.Flags || L.Mask != R.Mask, false);
+		ZKZ_RETURN_IF(L.X != R.X || L.Y != R.Y || L.Weight != R.Weight || L.bEnabled != R.bEnabled, false);
+		ZKZ_RETURN_IF(L.Kind != R.Kind || L.Tag != R.Tag, false);
+	}
+
+	return true;
+}
+
+/// Import through the generic text import of each property, as ImportFromCSV did before it got per-struct codecs
+int32 ImportWithImportText(const UStruct& Struct, const FString& CSV)
+{
+	const FCsvParser Parser{CSV};
+	const FCsvParser::FRows& Rows = Parser.GetRows();
+	ZKZ_RETURN_IF(Rows.IsEmpty(), 0);
+
+	TArray<const FProperty*> Properties;
+	for (const TCHAR* const Cell : Rows[0])
+	{
+		Properties.Emplace(Struct.FindPropertyByName(Cell));
+	}
+
+	TArray<uint8> Object;
+	Object.SetNumZeroed(Struct.GetStructureSize());
+
+	int32 NumImported = 0;
+	for (int32 RowIdx = 1; RowIdx < Rows.Num(); ++RowIdx)
+	{
+		Struct.InitializeStruct(Object.GetData());
+		for (int32 CellIdx = 0; CellIdx < Rows[RowIdx].Num() && CellIdx < Properties.Num(); ++CellIdx)
+		{
+			ZKZ_CONTINUE_IF(Properties[CellIdx] == nullptr);
+
+			FStringOutputDevice ImportOutput;
+			Properties[CellIdx]->ImportText_Direct(
+				Rows[RowIdx][CellIdx],
+				Properties[CellIdx]->ContainerPtrToValuePtr<void>(Object.GetData()),
+				nullptr,
+				0,
+				&ImportOutput);
+		}
+		Struct.DestroyStruct(Object.GetData());
+		++NumImported;
+	}
+
+	return NumImported;
+}
+
+/// Export through the generic text export of each property
+FString ExportWithExportText(const UStruct& Struct, const TArrayView<const void*> Objects)
+{
+	FString CSV;
+	for (const void* const Object : Objects)
+	{
+		for (TFieldIterator<FProperty> FieldIt{&Struct}; FieldIt; ++FieldIt)
+		{
+			const void* const Value = FieldIt->ContainerPtrToValuePtr<void>(Object);
+			CSV += TEXT("\"");
+			FieldIt->ExportText_Direct(CSV, Value, Value, nullptr, PPF_None);
+			CSV += TEXT("\",");
+		}
+		CSV += TEXT("\n");
+	}
+	return CSV;
+}
+
+/// Imports from the string, or from its UTF-8 bytes through an archive, collecting rows in the order they're delivered
+EImportResult ImportCollectingRows(
+	const FString& CSV,
+	const bool bFromArchive,
+	const ECSVImportMode Mode,
+	TArray<FZkzSerializationTestRow>& OutRows,
+	FOutputDevice* const Output)
+{
+	FCriticalSection RowsLock;
+	const auto LineCallback = [&RowsLock, &OutRows](const FZkzSerializationTestRow& Row)
+	{
+		FScopeLock Lock{&RowsLock};
+		OutRows.Emplace(Row);
+	};
+
+	if (!bFromArchive)
+	{
+		return ImportFromCSV<FZkzSerializationTestRow>(CSV, LineCallback, Output, nullptr, Mode);
+	}
+
+	const TArray<uint8> Bytes = ToUTF8(CSV);
+	FMemoryReader Reader{Bytes};
+	return ImportFromCSV<FZkzSerializationTestRow>(Reader, LineCallback, Output, nullptr, Mode);
+}
+
+template <class T>
+TArray<uint8> ExportToColumnarTableBytes(const TArray<T>& Rows)
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer{Bytes};
+	ExportToColumnarTable<T>(Rows, Writer);
+	return Bytes;
+}
+
+}  // namespace SerializationTestPrivate
+
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FSerializationTest,
+	"Zakazane.ZakazaneUtilities.Serialization",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+ZKZ_ADD_TEST(StreamingImportReadsExportedCSV)
+{
+	using namespace SerializationTestPrivate;
+
+	// Large enough to span multiple read chunks
+	const TArray<FZkzSerializationTestRow> Rows = MakeRows(2000);
+	const FString CSV = ExportToCSV<FZkzSerializationTestRow>(Rows);
+
+	EImportResult Result = EImportResult::Error;
+	const TArray<FZkzSerializationTestRow> ImportedRows = ImportFromBytes(ToUTF8(CSV), Result);
+
+	TestTrue("Success", Result == EImportResult::Success);
+	TestTrue("AllRowsImported", RowsEqual(ImportedRows, Rows));
+}
+
+ZKZ_ADD_TEST(StreamingImportReadsUTF16AndCRLF)
+{
+	using namespace SerializationTestPrivate;
+
+	const TArray<FZkzSerializationTestRow> Rows = MakeRows(3);
+	const FString CSV = ExportToCSV<FZkzSerializationTestRow>(Rows).Replace(TEXT(",\n"), TEXT(",\r\n"));
+
+	EImportResult Result = EImportResult::Error;
+	const TArray<FZkzSerializationTestRow> ImportedRows = ImportFromBytes(ToUTF16LEWithByteOrderMark(CSV), Result);
+
+	TestTrue("Success", Result == EImportResult::Success);
+	TestTrue("AllRowsImported", RowsEqual(ImportedRows, Rows));
+}
+
+ZKZ_ADD_TEST(StreamingImportSkipsInvalidRows)
+{
+	using namespace SerializationTestPrivate;
+
+	const FString CSV = TEXT("Id,Value\n1,1.5\n\n2,3.5,extra\n3,2.5");
+
+	EImportResult Result = EImportResult::Error;
+	const TArray<FZkzSerializationTestRow> ImportedRows = ImportFromBytes(ToUTF8(CSV), Result);
+
+	TestTrue("Warning", Result == EImportResult::Warning);
+	ZKZ_RETURN_IF(!TestEqual("ValidRowsImported", ImportedRows.Num(), 2));
+	TestEqual("FirstRow", ImportedRows[0].Id, 1);
+	TestEqual("LastRowWithoutLineBreak", ImportedRows[1].Value, 2.5f);
+
+	const TArray<uint8> EmptyBytes;
+	ImportFromBytes(EmptyBytes, Result);
+	TestTrue("EmptyIsError", Result == EImportResult::Error);
+}
+
+ZKZ_ADD_TEST(ParallelImportMatchesSerial)
+{
+	using namespace SerializationTestPrivate;
+
+	// More rows than fit in a parallel batch (16k), with invalid rows in the second batch and at the end, to check
+	// that line numbers carry over batches and warnings are reported in the same order
+	constexpr int32 NumRows = 40000;
+	constexpr int32 NumRowsBeforeInvalidRow = 20000;
+	const TArray<FZkzSerializationTestRow> Rows = MakeRows(NumRows);
+	const FString FirstPartCSV =
+		ExportToCSV<FZkzSerializationTestRow>(MakeArrayView(Rows).Left(NumRowsBeforeInvalidRow));
+	FString SecondPartCSV =
+		ExportToCSV<FZkzSerializationTestRow>(MakeArrayView(Rows).RightChop(NumRowsBeforeInvalidRow));
+	SecondPartCSV.RightChopInline(SecondPartCSV.Find(TEXT("\n")) + 1);
+	const FString CSV = FirstPartCSV + TEXT("invalid,row\n") + SecondPartCSV + TEXT("another,invalid,row\n");
+
+	for (const bool bFromArchive : {false, true})
+	{
+		const FString SourceName = bFromArchive ? TEXT("Archive") : TEXT("String");
+
+		FStringOutputDevice SerialOutput;
+		TArray<FZkzSerializationTestRow> SerialRows;
+		const EImportResult SerialResult =
+			ImportCollectingRows(CSV, bFromArchive, ECSVImportMode::Serial, SerialRows, &SerialOutput);
+
+		FStringOutputDevice ParallelOutput;
+		TArray<FZkzSerializationTestRow> ParallelRows;
+		const EImportResult ParallelResult =
+			ImportCollectingRows(CSV, bFromArchive, ECSVImportMode::Parallel, ParallelRows, &ParallelOutput);
+
+		TArray<FZkzSerializationTestRow> UnorderedRows;
+		const EImportResult UnorderedResult =
+			ImportCollectingRows(CSV, bFromArchive, ECSVImportMode::ParallelUnordered, UnorderedRows, nullptr);
+		UnorderedRows.Sort(
+			[](const FZkzSerializationTestRow& L, const FZkzSerializationTestRow& R) { return L.Id < R.Id; });
+
+		TestTrue(SourceName + TEXT("SerialWarning"), SerialResult == EImportResult::Warning);
+		TestTrue(SourceName + TEXT("ParallelWarning"), ParallelResult == EImportResult::Warning);
+		TestTrue(SourceName + TEXT("UnorderedWarning"), UnorderedResult == EImportResult::Warning);
+		TestTrue(SourceName + TEXT("SerialRows"), RowsEqual(SerialRows, Rows));
+		TestTrue(SourceName + TEXT("ParallelRowsInFileOrder"), RowsEqual(ParallelRows, Rows));
+		TestTrue(SourceName + TEXT("AllUnorderedRows"), RowsEqual(UnorderedRows, Rows));
+		TestEqual(SourceName + TEXT("SameWarnings"), *ParallelOutput, *SerialOutput);
+
+		// Line numbers count rows, the header being line 1
+		TestTrue(
+			SourceName + TEXT("InvalidRowLineNumber"),
+			ParallelOutput.Contains(FString::Printf(TEXT("line %d:"), NumRowsBeforeInvalidRow + 2)));
+		TestTrue(
+			SourceName + TEXT("LastInvalidRowLineNumber"),
+			ParallelOutput.Contains(FString::Printf(TEXT("line %d:"), NumRows + 3)));
+	}
+}
+
+ZKZ_ADD_TEST(CodecRoundTripsNumericTypes)
+{
+	using namespace SerializationTestPrivate;
+
+	TArray<FZkzSerializationNumericRow> Rows = MakeNumericRows(100);
+	Rows[0].Id = MIN_int32;
+	Rows[0].Count = MIN_int64;
+	Rows[0].Flags = MAX_uint8;
+	Rows[0].Mask = MAX_uint32;
+	Rows[1].Id = MAX_int32;
+	Rows[1].Count = MAX_int64;
+	Rows[1].Y = 1.0e-20f;
+	Rows[1].Weight = -1.0e100;
+
+	const FString CSV = ExportToCSV<FZkzSerializationNumericRow>(Rows);
+
+	TArray<FZkzSerializationNumericRow> ImportedRows;
+	const EImportResult Result = ImportFromCSV<FZkzSerializationNumericRow>(
+		CSV, [&ImportedRows](const FZkzSerializationNumericRow& Row) { ImportedRows.Emplace(Row); });
+
+	TestTrue("Success", Result == EImportResult::Success);
+	TestTrue("AllRowsImported", NumericRowsEqual(ImportedRows, Rows));
+}
+
+ZKZ_ADD_TEST(CodecFallsBackToImportText)
+{
+	const FString CSV = TEXT(
+		"Id,bEnabled,Kind,Flags\n"
+		"1,Yes,EZkzSerializationTestEnum::Third,7\n"
+		"2,True,Fourth,7\n"
+		"3,False,Second,7 trailing\n");
+
+	FStringOutputDevice Output;
+	TArray<FZkzSerializationNumericRow> ImportedRows;
+	const EImportResult Result = ImportFromCSV<FZkzSerializationNumericRow>(
+		CSV, [&ImportedRows](const FZkzSerializationNumericRow& Row) { ImportedRows.Emplace(Row); }, &Output);
+
+	TestTrue("Warning", Result == EImportResult::Warning);
+	ZKZ_RETURN_IF(!TestEqual("OnlyValidRowImported", ImportedRows.Num(), 1));
+	TestTrue("GenericBoolNames", ImportedRows[0].bEnabled);
+	TestTrue("QualifiedEnumName", ImportedRows[0].Kind == EZkzSerializationTestEnum::Third);
+	TestTrue("UnknownEnumNameReported", FString{*Output}.Contains(TEXT("line 3, column 3")));
+	TestTrue("TrailingTextReported", FString{*Output}.Contains(TEXT("line 4, column 4")));
+}
+
+ZKZ_ADD_TEST(StreamingExportMatchesStringExport)
+{
+	using namespace SerializationTestPrivate;
+
+	// More rows than a parallel export batch
+	const TArray<FZkzSerializationTestRow> Rows = MakeRows(20000);
+	const TArray<uint8> StringExportBytes = ToUTF8(ExportToCSV<FZkzSerializationTestRow>(Rows));
+
+	for (const ECSVExportMode Mode : {ECSVExportMode::Serial, ECSVExportMode::Parallel})
+	{
+		const FString ModeName = Mode == ECSVExportMode::Serial ? TEXT("Serial") : TEXT("Parallel");
+
+		TArray<uint8> Bytes;
+		FMemoryWriter Writer{Bytes};
+		TestTrue(ModeName + TEXT("Success"), ExportToCSV<FZkzSerializationTestRow>(Rows, Writer, Mode));
+		TestTrue(ModeName + TEXT("SameAsStringExport"), Bytes == StringExportBytes);
+
+		EImportResult Result = EImportResult::Error;
+		const TArray<FZkzSerializationTestRow> ImportedRows = ImportFromBytes(Bytes, Result);
+		TestTrue(ModeName + TEXT("ImportSuccess"), Result == EImportResult::Success);
+		TestTrue(ModeName + TEXT("AllRowsImported"), RowsEqual(ImportedRows, Rows));
+	}
+}
+
+ZKZ_ADD_TEST(ColumnarTableRoundTrips)
+{
+	using namespace SerializationTestPrivate;
+
+	// More rows than an import batch, with text and string columns
+	const TArray<FZkzSerializationTestRow> Rows = MakeRows(3000);
+	const TArray<uint8> Bytes = ExportToColumnarTableBytes(Rows);
+
+	TArray<FZkzSerializationTestRow> ImportedRows;
+	const EImportResult Result = ImportFromColumnarTable<FZkzSerializationTestRow>(
+		Bytes, [&ImportedRows](const FZkzSerializationTestRow& Row) { ImportedRows.Emplace(Row); });
+
+	TestTrue("Success", Result == EImportResult::Success);
+	TestTrue("AllRowsImported", RowsEqual(ImportedRows, Rows));
+
+	// Plain old data columns, including enums, bools and limits of the integer types
+	TArray<FZkzSerializationNumericRow> NumericRows = MakeNumericRows(100);
+	NumericRows[0].Count = MIN_int64;
+	NumericRows[0].Mask = MAX_uint32;
+	const TArray<uint8> NumericBytes = ExportToColumnarTableBytes(NumericRows);
+
+	TArray<FZkzSerializationNumericRow> ImportedNumericRows;
+	const EImportResult NumericResult = ImportFromColumnarTable<FZkzSerializationNumericRow>(
+		NumericBytes,
+		[&ImportedNumericRows](const FZkzSerializationNumericRow& Row) { ImportedNumericRows.Emplace(Row); });
+
+	TestTrue("NumericSuccess", NumericResult == EImportResult::Success);
+	TestTrue("AllNumericRowsImported", NumericRowsEqual(ImportedNumericRows, NumericRows));
+
+	TArray<uint8> CSVBytes;
+	FMemoryWriter CSVWriter{CSVBytes};
+	const EImportResult ConvertResult =
+		ConvertColumnarTableToCSV(*FZkzSerializationTestRow::StaticStruct(), Bytes, CSVWriter);
+
+	TestTrue("ConvertSuccess", ConvertResult == EImportResult::Success);
+	TestTrue("ConvertedAsExportToCSV", CSVBytes == ToUTF8(ExportToCSV<FZkzSerializationTestRow>(Rows)));
+}
+
+ZKZ_ADD_TEST(ColumnarTableImportChecksData)
+{
+	using namespace SerializationTestPrivate;
+
+	const TArray<FZkzSerializationNumericRow> Rows = MakeNumericRows(10);
+	const TArray<uint8> Bytes = ExportToColumnarTableBytes(Rows);
+
+	const auto ImportRows = [](const TArrayView64<const uint8> Data, int32& OutNumRows)
+	{
+		OutNumRows = 0;
+		return ImportFromColumnarTable<FZkzSerializationTestRow>(
+			Data, [&OutNumRows](const FZkzSerializationTestRow&) { ++OutNumRows; });
+	};
+
+	int32 NumRows = 0;
+	TestTrue("EmptyIsError", ImportRows({}, NumRows) == EImportResult::Error);
+
+	const TArrayView64<const uint8> TruncatedBytes{Bytes.GetData(), Bytes.Num() - 1};
+	TestTrue("TruncatedIsError", ImportRows(TruncatedBytes, NumRows) == EImportResult::Error);
+	TestEqual("NoRowsFromTruncated", NumRows, 0);
+
+	// Magic and version, then the length prefixed struct path, the number of rows and the number of columns
+	int32 StructPathLen = 0;
+	FMemory::Memcpy(&StructPathLen, Bytes.GetData() + sizeof(uint32) * 2, sizeof(int32));
+	const int32 NumRowsOffset = sizeof(uint32) * 2 + sizeof(int32) + StructPathLen;
+
+	TArray<uint8> HugeNumColumnsBytes = Bytes;
+	const int32 HugeNumColumns = MAX_int32;
+	FMemory::Memcpy(HugeNumColumnsBytes.GetData() + NumRowsOffset + sizeof(int32), &HugeNumColumns, sizeof(int32));
+	TestTrue("HugeNumColumnsIsError", ImportRows(HugeNumColumnsBytes, NumRows) == EImportResult::Error);
+
+	// Without columns, nothing bounds the number of rows
+	TArray<uint8> HugeNumRowsWithoutColumnsBytes = Bytes;
+	const int32 HugeNumRowsWithoutColumns[] = {MAX_int32, 0};
+	FMemory::Memcpy(
+		HugeNumRowsWithoutColumnsBytes.GetData() + NumRowsOffset,
+		HugeNumRowsWithoutColumns,
+		sizeof(HugeNumRowsWithoutColumns));
+	TestTrue(
+		"HugeNumRowsWithoutColumnsIsError",
+		ImportRows(HugeNumRowsWithoutColumnsBytes, NumRows) == EImportResult::Error);
+	TestEqual("NoRowsWithoutColumns", NumRows, 0);
+
+	// Only the Id column has a property in the other struct
+	TArray<FZkzSerializationTestRow> ImportedRows;
+	const EImportResult Result = ImportFromColumnarTable<FZkzSerializationTestRow>(
+		Bytes, [&ImportedRows](const FZkzSerializationTestRow& Row) { ImportedRows.Emplace(Row); });
+
+	TestTrue("UnknownColumnsAreWarnings", Result == EImportResult::Warning);
+	ZKZ_RETURN_IF(!TestEqual("AllRowsImported", ImportedRows.Num(), Rows.Num()));
+	TestEqual("MatchingColumnImported", ImportedRows.Last().Id, Rows.Last().Id);
+}
+
+ZKZ_END_AUTOMATION_TEST(FSerializationTest);
+
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FSerializationBenchmark,
+	"Zakazane.ZakazaneUtilities.Benchmark.Serialization",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+ZKZ_ADD_TEST(CodecVsImportTextOnNumericTable)
+{
+	using namespace SerializationTestPrivate;
+
+	constexpr int32 NumIterations = 5;
+	constexpr int32 NumRows = 20000;
+
+	const UStruct& Struct = *FZkzSerializationNumericRow::StaticStruct();
+	const TArray<FZkzSerializationNumericRow> Rows = MakeNumericRows(NumRows);
+	TArray<const void*> Objects;
+	Algo::Transform(Rows, Objects, [](const FZkzSerializationNumericRow& Row) { return &Row; });
+
+	const FString CSV = ExportToCSV(Struct, Objects);
+
+	const double ImportTextSeconds =
+		MeasureAverageSeconds(NumIterations, [&] { ImportWithImportText(Struct, CSV); });
+	const double CodecImportSeconds = MeasureAverageSeconds(
+		NumIterations, [&] { ImportFromCSV(Struct, CSV, [](const void*) {}); });
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("CSV import of numeric rows (%d rows)"), NumRows),
+		ImportTextSeconds,
+		CodecImportSeconds);
+
+	const double ExportTextSeconds =
+		MeasureAverageSeconds(NumIterations, [&] { ExportWithExportText(Struct, Objects); });
+	const double CodecExportSeconds = MeasureAverageSeconds(NumIterations, [&] { ExportToCSV(Struct, Objects); });
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("CSV export of numeric rows (%d rows)"), NumRows),
+		ExportTextSeconds,
+		CodecExportSeconds);
+}
+
+ZKZ_ADD_TEST(StreamingExportVsStringExport)
+{
+	using namespace SerializationTestPrivate;
+
+	constexpr int32 NumIterations = 5;
+	constexpr int32 NumRows = 100000;
+
+	const TArray<FZkzSerializationNumericRow> Rows = MakeNumericRows(NumRows);
+
+	const double StringSeconds = MeasureAverageSeconds(
+		NumIterations,
+		[&Rows]
+		{
+			TArray<uint8> Bytes;
+			FMemoryWriter Writer{Bytes};
+			const FTCHARToUTF8 Converted{*ExportToCSV<FZkzSerializationNumericRow>(Rows)};
+			Writer.Serialize(const_cast<ANSICHAR*>(Converted.Get()), Converted.Length());
+		});
+
+	for (const ECSVExportMode Mode : {ECSVExportMode::Serial, ECSVExportMode::Parallel})
+	{
+		const double StreamingSeconds = MeasureAverageSeconds(
+			NumIterations,
+			[&Rows, Mode]
+			{
+				TArray<uint8> Bytes;
+				FMemoryWriter Writer{Bytes};
+				ExportToCSV<FZkzSerializationNumericRow>(Rows, Writer, Mode);
+			});
+
+		ReportBenchmark(
+			*this,
+			FString::Printf(
+				TEXT("%s streaming CSV export (%d rows)"),
+				Mode == ECSVExportMode::Serial ? TEXT("Serial") : TEXT("Parallel"),
+				NumRows),
+			StringSeconds,
+			StreamingSeconds);
+	}
+}
+
+ZKZ_ADD_TEST(ColumnarTableVsCSVImport)
+{
+	using namespace SerializationTestPrivate;
+
+	constexpr int32 NumIterations = 5;
+	constexpr int32 NumRows = 100000;
+
+	const UStruct& Struct = *FZkzSerializationNumericRow::StaticStruct();
+	const TArray<FZkzSerializationNumericRow> Rows = MakeNumericRows(NumRows);
+	const FString CSV = ExportToCSV<FZkzSerializationNumericRow>(Rows);
+	const TArray<uint8> Bytes = ExportToColumnarTableBytes(Rows);
+
+	const double CSVSeconds =
+		MeasureAverageSeconds(NumIterations, [&] { ImportFromCSV(Struct, CSV, [](const void*) {}); });
+	const double ColumnarSeconds =
+		MeasureAverageSeconds(NumIterations, [&] { ImportFromColumnarTable(Struct, Bytes, [](const void*) {}); });
+
+	ReportBenchmark(
+		*this,
+		FString::Printf(TEXT("Columnar table import of numeric rows (%d rows)"), NumRows),
+		CSVSeconds,
+		ColumnarSeconds);
+}
+
+ZKZ_END_AUTOMATION_TEST(FSerializationBenchmark);
+
+}  // namespace Zkz::Serialization::Test
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "SerializationTest.generated.h"
+
+USTRUCT()
+struct FZkzSerializationTestRow
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+
+	UPROPERTY()
+	FString Name;
+
+	UPROPERTY()
+	FText Label;
+
+	UPROPERTY()
+	float Value = 0.0f;
+};
+
+UENUM()
+enum class EZkzSerializationTestEnum : uint8
+{
+	First,
+	Second,
+	Third,
+};
+
+/// Row with only properties which have direct CSV conversions
+USTRUCT()
+struct FZkzSerializationNumericRow
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Id = 0;
+
+	UPROPERTY()
+	int64 Count = 0;
+
+	UPROPERTY()
+	uint8 Flags = 0;
+
+	UPROPERTY()
+	uint32 Mask = 0;
+
+	UPROPERTY()
+	float X = 0.0f;
+
+	UPROPERTY()
+	float Y = 0.0f;
+
+	UPROPERTY()
+	double Weight = 0.0;
+
+	UPROPERTY()
+	bool bEnabled = false;
+
+	UPROPERTY()
+	EZkzSerializationTestEnum Kind = EZkzSerializationTestEnum::First;
+
+	UPROPERTY()
+	FName Tag;
+};
@@ -0,0 +1,93 @@
+#include "Zakazane/TimerWheel.h"
+#include "Zakazane/Test/Test.h"
+
+namespace Zkz::Test
+{
+
+ZKZ_BEGIN_AUTOMATION_TEST(
+	FTimerWheelTest,
+	"Zakazane.ZakazaneUtilities.TimerWheel",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+ZKZ_ADD_TEST(TimersFireOnExpiryTick)
+{
+	FTimerWheel Wheel{FTimespan::FromMilliseconds(1)};
+
+	// Delays chosen to land on every level of the wheel, including timers beyond the wheel span
+	const TArray<int64> DelaysMs{1, 2, 63, 64, 65, 100, 4095, 4096, 4097, 300000, 17000000};
+
+	TArray<int64> FiredAtTick;
+	FiredAtTick.Init(-1, DelaysMs.Num());
+
+	int64 CurrentTick = 0;
+
+	for (int32 Idx = 0; Idx < DelaysMs.Num(); ++Idx)
+	{
+		Wheel.Schedule(
+			FTimespan::FromMilliseconds(DelaysMs[Idx]),
+			[&FiredAtTick, &CurrentTick, Idx] { FiredAtTick[Idx] = CurrentTick; });
+	}
+
+	TestEqual("AllTimersPending", Wheel.GetNumPending(), DelaysMs.Num());
+
+	while (CurrentTick < DelaysMs.Last())
+	{
+		++CurrentTick;
+		Wheel.Tick();
+	}
+
+	TestEqual("NoTimersPending", Wheel.GetNumPending(), 0);
+	TestEqual("TimersFiredOnTime", FiredAtTick, DelaysMs);
+}
+
+ZKZ_ADD_TEST(CanceledTimersDoNotFire)
+{
+	FTimerWheel Wheel{FTimespan::FromMilliseconds(1)};
+
+	bool bCanceledFired = false;
+	bool bOtherFired = false;
+
+	const FTimerWheelHandle Canceled =
+		Wheel.Schedule(FTimespan::FromMilliseconds(10), [&bCanceledFired] { bCanceledFired = true; });
+	Wheel.Schedule(FTimespan::FromMilliseconds(10), [&bOtherFired] { bOtherFired = true; });
+
+	TestTrue("CancelSucceeds", Wheel.Cancel(Canceled));
+	TestFalse("SecondCancelFails", Wheel.Cancel(Canceled));
+
+	Wheel.Tick(10);
+
+	TestFalse("CanceledTimerNotFired", bCanceledFired);
+	TestTrue("OtherTimerFired", bOtherFired);
+
+	// The canceled timer's slot gets reused, the stale handle must not cancel the new timer
+	bool bReusedFired = false;
+	Wheel.Schedule(FTimespan::FromMilliseconds(1), [&bReusedFired] { bReusedFired = true; });
+	TestFalse("StaleHandleDoesNotCancel", Wheel.Cancel(Canceled));
+
+	Wheel.Tick();
+	TestTrue("ReusedTimerFired", bReusedFired);
+}
+
+ZKZ_ADD_TEST(CallbacksCanScheduleTimers)
+{
+	FTimerWheel Wheel{FTimespan::FromMilliseconds(1)};
+
+	int32 NumFired = 0;
+	TFunction<void()> Reschedule;
+	Reschedule = [&Wheel, &NumFired, &Reschedule]
+	{
+		if (++NumFired < 5)
+		{
+			Wheel.Schedule(FTimespan::FromMilliseconds(1), [&Reschedule] { Reschedule(); });
+		}
+	};
+
+	Wheel.Schedule(FTimespan::FromMilliseconds(1), [&Reschedule] { Reschedule(); });
+	Wheel.Tick(10);
+
+	TestEqual("ChainedTimersFired", NumFired, 5);
+}
+
+ZKZ_END_AUTOMATION_TEST(FTimerWheelTest);
+
+}  // namespace Zkz::Test
@@ -21,6 +21,7 @@ public class ZakazaneUtilitiesTests : ModuleRules
 				"Engine",
 				"Slate",
 				"SlateCore",
+				"UnrealEd",
 				"ZakazaneUtilities",
 				"ZakazaneTestUtilities"
 			}